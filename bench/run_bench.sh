@@ -0,0 +1,80 @@
+#!/bin/bash
+#
+# compiles the benchmark programs without optimisation, optimised and untagged,
+# runs them and reports the executed instructions and run times
+# @author Tobias Weber (orcid: 0000-0002-7230-1932)
+# @date 16-oct-2026
+# @license see 'LICENSE' file
+#
+# usage: run_bench.sh <compiler> <vm> [benchmark directory] [output directory]
+# additional vm arguments can be given in VM_ARGS, e.g. VM_ARGS="-j"
+#
+
+COMPILER="$1"
+VM="$2"
+BENCH_DIR="${3:-$(dirname "$0")}"
+OUT_DIR="${4:-bench}"
+
+VM_MEM=1048576
+
+if [ -z "${COMPILER}" ] || [ -z "${VM}" ]; then
+	echo -e "Usage: $0 <compiler> <vm> [benchmark directory] [output directory]"
+	exit -1
+fi
+
+mkdir -p "${OUT_DIR}"
+
+# current time in nanoseconds
+get_time() {
+	date +%s%N
+}
+
+printf "%-16s %-6s %16s %16s %16s %16s\n" \
+	"benchmark" "opt" "instructions" "instructions/s" "vm time [ms]" "wall time [ms]"
+
+num_failed=0
+
+for prog in "${BENCH_DIR}"/*.muf; do
+	name=$(basename "${prog}" .muf)
+
+	for opt in "" "-O" "-u"; do
+		bin="${OUT_DIR}/${name}${opt}"
+		opt_name="${opt:-none}"
+
+		if ! "${COMPILER}" ${opt} "${prog}" -o "${bin}" > "${bin}.compile.log" 2>&1; then
+			printf "%-16s %-6s %16s\n" "${name}" "${opt_name}" "compile failed"
+			num_failed=$((num_failed + 1))
+			continue
+		fi
+
+		start_time=$(get_time)
+		"${VM}" -t -m ${VM_MEM} ${VM_ARGS} "${bin}.bin" < /dev/null > "${bin}.out" 2>&1
+		status=$?
+		end_time=$(get_time)
+
+		# the vm's timer line reads:
+		# "Program run time: <time> <unit>, <n> instructions (<n> instructions/s)."
+		timer_line=$(grep "^Program run time:" "${bin}.out")
+		if [ ${status} -ne 0 ] || [ -z "${timer_line}" ]; then
+			printf "%-16s %-6s %16s\n" "${name}" "${opt_name}" "run failed"
+			num_failed=$((num_failed + 1))
+			continue
+		fi
+
+		vm_time=$(echo "${timer_line}" | sed -E 's/^Program run time: ([^ ]+) ([^,]+),.*/\1 \2/' |
+			awk '{ t = $1; if($2 == "s") t *= 1000; else if($2 == "min") t *= 60000; printf "%.3f", t }')
+		num_instrs=$(echo "${timer_line}" | sed -E 's/.*, ([0-9]+) instructions.*/\1/')
+		instrs_per_s=$(echo "${timer_line}" | sed -nE 's/.*\(([^ ]+) instructions\/s\).*/\1/p')
+		wall_time=$(awk "BEGIN { printf \"%.3f\", (${end_time} - ${start_time}) / 1000000 }")
+
+		printf "%-16s %-6s %16s %16.4g %16s %16s\n" "${name}" "${opt_name}" \
+			"${num_instrs}" "${instrs_per_s:-0}" "${vm_time}" "${wall_time}"
+	done
+done
+
+if [ ${num_failed} -ne 0 ]; then
+	echo -e "${num_failed} benchmark(s) failed."
+	exit -1
+fi
+
+exit 0
@@ -63,14 +63,46 @@ Codegen::GetArrayTypeConst(SymbolType ty) const
 }
 
 
-t_astret Codegen::visit(const ASTArrayAccess* ast)
+/**
+ * get the symbol if the term is a named array or string variable
+ */
+t_astret Codegen::GetArrayVar(const ASTPtr& term) const
 {
-	t_astret term = ast->GetTerm()->accept(this);
+	if(!term || term->type() != ASTType::Var)
+		return nullptr;
+
+	const t_str& varname = std::dynamic_pointer_cast<ASTVar>(term)->GetIdent();
+	t_astret sym = GetSym(varname);
+
+	if(!sym || !sym->addr ||
+		!(IsArray(sym->ty) || sym->ty == SymbolType::STRING))
+		return nullptr;
+
+	return sym;
+}
 
+
+t_astret Codegen::visit(const ASTArrayAccess* ast)
+{
 	bool ranged12 = ast->IsRanged12();
 	const auto num1 = ast->GetNum1();
 	const auto num2 = ast->GetNum2();
 
+	// is the term a named array or string variable?
+	t_astret var_sym = GetArrayVar(ast->GetTerm());
+
+	t_astret term = nullptr;
+	if(var_sym)
+	{
+		// only push the variable's address, the elements are read from memory
+		PushVarAddr(var_sym);
+		term = var_sym;
+	}
+	else
+	{
+		term = ast->GetTerm()->accept(this);
+	}
+
 	// single-element array access
 	if(!ranged12 && num1 && !num2)
 	{
@@ -111,7 +143,7 @@ t_astret Codegen::visit(const ASTArrayAccess* ast)
 				CastTo(m_int_const);
 		}
 
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::RDARR));
+		m_ostr->put(static_cast<t_vm_byte>(var_sym ? OpCode::RDARRM : OpCode::RDARR));
 
 		if(auto [arr_ty, arr_elem_ty] = GetArrayTypeConst(term->ty); arr_elem_ty)
 			return arr_elem_ty;
@@ -138,7 +170,7 @@ t_astret Codegen::visit(const ASTArrayAccess* ast)
 				CastTo(m_int_const);
 		}
 
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::RDARRR));
+		m_ostr->put(static_cast<t_vm_byte>(var_sym ? OpCode::RDARRRM : OpCode::RDARRR));
 
 		if(auto [arr_ty, arr_elem_ty] = GetArrayTypeConst(term->ty); arr_elem_ty)
 			return arr_ty;
@@ -161,19 +193,47 @@ t_astret Codegen::visit(const ASTArrayAssign* ast)
 		throw std::runtime_error("ASTArrayAssign: Variable \"" + varname + "\" has not been declared.");
 
 	// push variable address
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(
-		sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP));
-	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
-	m_ostr->write(reinterpret_cast<const char*>(&addr), vm_type_size<VMType::ADDR_BP, false>);
-
-	// evaluate the rhs expression
-	t_astret expr = ast->GetExpr()->accept(this);
+	PushVarAddr(sym);
 
 	bool ranged12 = ast->IsRanged12();
 	const auto num1 = ast->GetNum1();
 	const auto num2 = ast->GetNum2();
 
+	// push an index, casting it to an integer
+	auto push_index = [this](const ASTPtr& num)
+	{
+		t_astret numsym = num->accept(this);
+		if(numsym->ty != SymbolType::INT)
+			CastTo(m_int_const);
+	};
+
+	// range copy from another array variable of the same type
+	if(ranged12 && num1 && num2 && IsArray(sym->ty) &&
+		num1->type() != ASTType::ExprList && num2->type() != ASTType::ExprList &&
+		ast->GetExpr()->type() == ASTType::ArrayAccess)
+	{
+		auto src = std::dynamic_pointer_cast<ASTArrayAccess>(ast->GetExpr());
+		t_astret src_sym = GetArrayVar(src->GetTerm());
+
+		if(src_sym && src_sym->ty == sym->ty && src->IsRanged12() &&
+			src->GetNum1() && src->GetNum2() &&
+			src->GetNum1()->type() != ASTType::ExprList &&
+			src->GetNum2()->type() != ASTType::ExprList)
+		{
+			PushVarAddr(src_sym);
+			push_index(src->GetNum1());
+			push_index(src->GetNum2());
+			push_index(num1);
+			push_index(num2);
+
+			m_ostr->put(static_cast<t_vm_byte>(OpCode::CPARRR));
+			return GetArrayTypeConst(sym->ty).first;
+		}
+	}
+
+	// evaluate the rhs expression
+	t_astret expr = ast->GetExpr()->accept(this);
+
 	// single-element array assignment
 	if(!ranged12 && num1 && !num2)
 	{
@@ -286,9 +346,10 @@ t_astret Codegen::visit(const ASTExprList* ast)
 	{
 		// push number of elements
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_MEM));
+		write_vm_descr(*m_ostr, VMType::ADDR_MEM);
 		m_ostr->write(reinterpret_cast<const char*>(&num_elems),
 			vm_type_size<VMType::ADDR_MEM, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_MEM, false>);
 
 		if(arr_sym_ty == SymbolType::REAL_ARRAY)
 			m_ostr->put(static_cast<t_vm_byte>(OpCode::MAKEREALARR));
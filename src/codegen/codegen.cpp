@@ -16,8 +16,10 @@
 
 
 Codegen::Codegen(SymTab* syms, std::ostream* ostr)
-	: m_syms{syms}, m_ostr{ostr}
+	: m_syms{syms}, m_outstr{ostr}
 {
+	m_code.precision(ostr->precision());
+
 	// dummy symbol for real constants
 	m_real_const = std::make_shared<Symbol>();
 	m_real_const->ty = SymbolType::REAL;
@@ -84,6 +86,39 @@ Codegen::~Codegen()
 { }
 
 
+/**
+ * emit a section mapping the code addresses to source lines and functions
+ */
+void Codegen::SetDebugInfo(bool b, const t_str& srcfile)
+{
+	if(!b)
+	{
+		m_debuginfo.reset();
+		return;
+	}
+
+	m_debuginfo = DebugInfo{};
+	m_debuginfo->SetSourceFile(srcfile);
+}
+
+
+/**
+ * notes the source line of the statement that is emitted next
+ */
+void Codegen::AddDebugLine(const AST* ast)
+{
+	if(!m_debuginfo || !ast)
+		return;
+
+	auto lines = ast->GetLineRange();
+	if(!lines)
+		return;
+
+	m_debuginfo->AddLine(static_cast<t_vm_addr>(m_ostr->tellp()),
+		static_cast<t_vm_addr>(lines->first));
+}
+
+
 /**
  * insert start-up code
  */
@@ -100,8 +135,9 @@ void Codegen::Start()
 				<< std::endl;
 		}
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-		m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+		write_vm_descr(*m_ostr, VMType::INT);
 		m_ostr->write(reinterpret_cast<const char*>(&global_framesize), vm_type_size<VMType::INT, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::ADDFRAME));
 	}
 
@@ -119,19 +155,21 @@ void Codegen::Start()
 	// create stack frame
 	t_vm_int framesize = static_cast<t_vm_int>(GetStackFrameSize(func));
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+	write_vm_descr(*m_ostr, VMType::INT);
 	m_ostr->write(reinterpret_cast<const char*>(&framesize), vm_type_size<VMType::INT, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::ADDFRAME));
 
 	// push relative function address
 	t_vm_addr func_addr = 0;  // to be filled in later
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	// already skipped over address and jmp instruction
 	std::streampos addr_pos = m_ostr->tellp();
 	t_vm_addr to_skip = static_cast<t_vm_addr>(func_addr - addr_pos);
-	to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+	to_skip -= g_vm_addr_skip;
 	m_ostr->write(reinterpret_cast<const char*>(&to_skip), vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 
 	// call the start function
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::CALL));
@@ -155,8 +193,9 @@ std::streampos Codegen::Finish()
 	if(global_framesize > 0)
 	{
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-		m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+		write_vm_descr(*m_ostr, VMType::INT);
 		m_ostr->write(reinterpret_cast<const char*>(&global_framesize), vm_type_size<VMType::INT, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::REMFRAME));
 	}
 
@@ -206,7 +245,7 @@ std::streampos Codegen::Finish()
 		// write relative function address
 		t_vm_addr to_skip = static_cast<t_vm_addr>(*sym->addr - pos);
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip), vm_type_size<VMType::ADDR_IP, false>);
 	}
 
@@ -225,7 +264,7 @@ std::streampos Codegen::Finish()
 		t_vm_addr to_skip = label_pos - goto_pos;
 
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(goto_pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip),
 			vm_type_size<VMType::ADDR_IP, false>);
@@ -236,5 +275,32 @@ std::streampos Codegen::Finish()
 
 	// seek to end of stream
 	m_ostr->seekp(0, std::ios_base::end);
-	return m_ostr->tellp();
+
+	// assemble the program container from the generated code
+	const std::string code = m_code.str();
+	const t_vm_byte* codebytes = reinterpret_cast<const t_vm_byte*>(code.data());
+	const std::size_t codesize = static_cast<std::size_t>(consttab_pos);
+
+	ProgContainer prog;
+	prog.SetSection(SectionType::CODE, codebytes, codesize, 0);
+	if(code.size() > codesize)
+	{
+		prog.SetSection(SectionType::CONSTS, codebytes + codesize,
+			code.size() - codesize, codesize);
+	}
+
+	std::ostringstream ostrFuncs;
+	m_functab.Write(ostrFuncs);
+	prog.SetSection(SectionType::FUNCS, get_section_bytes(ostrFuncs));
+
+	if(m_debuginfo)
+	{
+		std::ostringstream ostrDebug;
+		m_debuginfo->Write(ostrDebug);
+		prog.SetSection(SectionType::DEBUG, get_section_bytes(ostrDebug));
+	}
+
+	std::streampos begin = m_outstr->tellp();
+	prog.Write(*m_outstr);
+	return m_outstr->tellp() - begin;
 }
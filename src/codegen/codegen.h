@@ -11,8 +11,11 @@
 #include "ast/ast.h"
 #include "consttab.h"
 #include "vm/opcodes.h"
+#include "vm/debuginfo.h"
+#include "vm/container.h"
 
 #include <optional>
+#include <sstream>
 #include <stack>
 #include <unordered_map>
 
@@ -85,6 +88,9 @@ public:
 	std::streampos Finish();
 
 	void SetDebug(bool b) { m_debug = b; }
+	void SetOptimise(bool b) { m_optimise = b; }
+	void SetUntagged(bool b) { m_untagged = b; }
+	void SetDebugInfo(bool b, const t_str& srcfile = "");
 
 
 protected:
@@ -107,6 +113,20 @@ protected:
 		const std::optional<std::streampos>& pos = std::nullopt,
 		bool allow_array_cast = false);
 
+	// returns the statically typed variant of an operation if possible
+	OpCode GetTypedOpCode(OpCode op, t_astret res_ty) const;
+
+	// returns the type of an expression that can be evaluated without type descriptors
+	std::optional<SymbolType> GetUntaggedType(const ASTPtr& ast,
+		std::size_t* num_ops = nullptr) const;
+
+	// emits code to evaluate an expression without type descriptors
+	SymbolType EmitUntagged(const ASTPtr& ast);
+	SymbolType EmitUntaggedOp(OpCode op, const ASTPtr& term1, const ASTPtr& term2);
+
+	// emits code to cast between untagged integers and reals
+	void CastUntagged(SymbolType ty_from, SymbolType ty_to);
+
 	// push constants
 	void PushRealConst(t_vm_real);
 	void PushIntConst(t_vm_int);
@@ -121,27 +141,43 @@ protected:
 	void PushQuatVecConst(const std::vector<t_vm_quat>& vec);
 
 	t_astret PushVar(const t_str& varname);
+	t_astret GetArrayVar(const ASTPtr& term) const;
+	void PushVarAddr(t_astret sym);
+	void ReadVar(t_astret sym);
 
 	void AssignVar(t_astret sym);
+	void ReadVarUntagged(t_astret sym);
+	void AssignVarUntagged(t_astret sym);
 	void CallExternal(const t_str& funcname);
 
+	// emits a conditional jump if the condition on the stack is false,
+	// returns the stream position of the jump address to patch
+	std::streampos JumpIfNot();
+
+	// notes the source line of the following code in the debug info
+	void AddDebugLine(const AST* ast);
+
 	bool IsArray(SymbolType ty) const;
 	SymbolPtr GetTypeConst(SymbolType ty) const;
 	std::pair<SymbolPtr, SymbolPtr> GetArrayTypeConst(SymbolType ty) const;
 
-
-private:
 	// symbol table
 	SymTab* m_syms{nullptr};
 
+	// currently active function scope
+	std::vector<t_str> m_curscope{};
+
+
+private:
 	// constants table
 	ConstTab m_consttab{};
 
-	// code output
-	std::ostream* m_ostr{&std::cout};
+	// code output, generated into m_code before the
+	// program container is written to m_outstr
+	std::stringstream m_code{};
+	std::ostream* m_ostr{&m_code};
+	std::ostream* m_outstr{&std::cout};
 
-	// currently active function scope
-	std::vector<t_str> m_curscope{};
 	// current address on stack for local variables
 	std::unordered_map<t_str, t_vm_addr> m_local_stack{};
 	// current address on stack for global variables
@@ -170,7 +206,18 @@ private:
 	SymbolPtr m_cplx_array_const{}, m_quat_array_const{};
 	SymbolPtr m_bool_const{}, m_str_const{};
 
+	// stream position and opcode of the last emitted comparison
+	std::optional<std::tuple<std::streampos, OpCode>> m_last_comp{};
+
 	bool m_debug{false};
+	bool m_optimise{false};  // emit superinstructions and typed operations
+	bool m_untagged{false};  // evaluate integer and real expressions without type descriptors
+
+	// line and function tables, if a debug info section is emitted
+	std::optional<DebugInfo> m_debuginfo{};
+
+	// compiled functions for the function table section
+	FuncTable m_functab{};
 };
 
 
@@ -25,20 +25,22 @@ std::streampos ConstTab::AddConst(const t_constval& constval)
 		const t_real realval = std::get<t_real>(constval);
 
 		// write real type descriptor byte
-		m_ostr.put(static_cast<t_vm_byte>(VMType::REAL));
+		write_vm_descr(m_ostr, VMType::REAL);
 		// write real data
 		m_ostr.write(reinterpret_cast<const char*>(&realval),
 			vm_type_size<VMType::REAL, false>);
+		write_vm_padding(m_ostr, vm_type_size<VMType::REAL, false>);
 	}
 	else if(std::holds_alternative<t_int>(constval))
 	{
 		const t_int intval = std::get<t_int>(constval);
 
 		// write int type descriptor byte
-		m_ostr.put(static_cast<t_vm_byte>(VMType::INT));
+		write_vm_descr(m_ostr, VMType::INT);
 		// write int data
 		m_ostr.write(reinterpret_cast<const char*>(&intval),
 			vm_type_size<VMType::INT, false>);
+		write_vm_padding(m_ostr, vm_type_size<VMType::INT, false>);
 	}
 	/*else if(std::holds_alternative<t_cplx>(constval))
 	{
@@ -46,7 +48,7 @@ std::streampos ConstTab::AddConst(const t_constval& constval)
 		const t_real imagval = std::get<t_cplx>(constval).imag();
 
 		// write int type descriptor byte
-		m_ostr.put(static_cast<t_vm_byte>(VMType::CPLX));
+		write_vm_descr(m_ostr, VMType::CPLX);
 		// write real data
 		m_ostr.write(reinterpret_cast<const char*>(&realval),
 			vm_type_size<VMType::REAL, false>);
@@ -59,13 +61,14 @@ std::streampos ConstTab::AddConst(const t_constval& constval)
 		const t_str& strval = std::get<t_str>(constval);
 
 		// write string type descriptor byte
-		m_ostr.put(static_cast<t_vm_byte>(VMType::STR));
+		write_vm_descr(m_ostr, VMType::STR);
 		// write string length
 		t_vm_addr len = static_cast<t_vm_addr>(strval.length());
 		m_ostr.write(reinterpret_cast<const char*>(&len),
 			vm_type_size<VMType::ADDR_MEM, false>);
 		// write string data
 		m_ostr.write(strval.data(), len);
+		write_vm_padding(m_ostr, vm_type_size<VMType::ADDR_MEM, false> + len);
 	}
 	else
 	{
@@ -0,0 +1,753 @@
+/**
+ * c++ source code generator
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "cppgen.h"
+
+#include <algorithm>
+
+
+/**
+ * run-time support code which is put at the beginning of the
+ * generated translation unit, it follows the semantics of the vm
+ */
+static const char g_cpp_runtime[] = R"RUNTIME(
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <limits>
+#include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+#include <thread>
+#include <chrono>
+#include <cmath>
+
+#include "vm/types.h"
+#include "common/helpers.h"
+
+using namespace m_ops;
+
+
+namespace rt {
+
+// ----------------------------------------------------------------------------
+// settings
+// ----------------------------------------------------------------------------
+inline t_vm_real g_eps = std::numeric_limits<t_vm_real>::epsilon();
+inline t_vm_int g_prec = 6;
+
+
+template<class t_val> struct is_vec_type : std::false_type {};
+template<class t_elem> struct is_vec_type<m::vec<t_elem, std::vector>> : std::true_type {};
+template<class t_val> constexpr bool is_vec = is_vec_type<std::decay_t<t_val>>::value;
+// ----------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------
+// casts
+// ----------------------------------------------------------------------------
+template<class t_val>
+t_vm_str to_str(const t_val& val)
+{
+	using t_from = std::decay_t<t_val>;
+
+	std::ostringstream ostr;
+	ostr.precision(g_prec);
+
+	if constexpr(std::is_same_v<t_from, t_vm_str>)
+	{
+		return val;
+	}
+	else if constexpr(std::is_same_v<t_from, bool>)
+	{
+		ostr << std::boolalpha << val;
+	}
+	else if constexpr(std::is_same_v<t_from, t_vm_real>)
+	{
+		ostr << (m::equals_0<t_vm_real>(val, g_eps) ? t_vm_real(0) : val);
+	}
+	else if constexpr(std::is_same_v<t_from, t_vm_cplx>)
+	{
+		t_vm_real real = val.real(), imag = val.imag();
+		if(m::equals_0<t_vm_real>(real, g_eps))
+			real = t_vm_real(0);
+		if(m::equals_0<t_vm_real>(imag, g_eps))
+			imag = t_vm_real(0);
+		ostr << "(" << real << ", " << imag << ")";
+	}
+	else if constexpr(std::is_same_v<t_from, t_vm_quat>)
+	{
+		t_vm_real comps[] = { val.real(), val.imag1(), val.imag2(), val.imag3() };
+		ostr << "(";
+		for(std::size_t i = 0; i < 4; ++i)
+		{
+			if(m::equals_0<t_vm_real>(comps[i], g_eps))
+				comps[i] = t_vm_real(0);
+			ostr << comps[i] << (i < 3 ? ", " : ")");
+		}
+	}
+	else if constexpr(is_vec<t_from>)
+	{
+		using t_elem = typename t_from::value_type;
+
+		ostr << "[ ";
+		for(std::size_t i = 0; i < val.size(); ++i)
+		{
+			t_elem elem = val[i];
+			if(m::equals_0<t_elem>(elem, g_eps))
+				elem = t_elem{};
+
+			ostr << elem;
+			if(i != val.size() - 1)
+				ostr << ", ";
+		}
+		ostr << " ]";
+	}
+	else
+	{
+		ostr << val;
+	}
+
+	return ostr.str();
+}
+
+
+template<class t_to, class t_val>
+t_to cast(const t_val& val)
+{
+	using t_from = std::decay_t<t_val>;
+
+	if constexpr(std::is_same_v<t_from, t_to>)
+		return val;
+	else if constexpr(std::is_same_v<t_to, t_vm_str>)
+		return to_str(val);
+	else if constexpr(std::is_same_v<t_from, t_vm_str>)
+	{
+		t_to conv_val{};
+		std::istringstream{val} >> conv_val;
+		return conv_val;
+	}
+	else if constexpr(std::is_arithmetic_v<t_from> && std::is_arithmetic_v<t_to>)
+		return static_cast<t_to>(val);
+	else if constexpr(std::is_constructible_v<t_to, t_from>)
+		return t_to(val);
+	else
+		throw std::runtime_error("Invalid cast.");
+}
+
+
+template<class t_vec>
+t_vec zero_vec(std::size_t size)
+{
+	using t_elem = typename t_vec::value_type;
+
+	t_vec vec = m::create<t_vec>(size);
+	for(std::size_t i = 0; i < size; ++i)
+		vec[i] = t_elem{};
+	return vec;
+}
+
+
+template<class t_vec>
+t_vec make_vec(std::initializer_list<typename t_vec::value_type> elems)
+{
+	t_vec vec = m::create<t_vec>(elems.size());
+	std::size_t i = 0;
+	for(const auto& elem : elems)
+		vec[i++] = elem;
+	return vec;
+}
+
+
+template<class t_vec, class t_val>
+t_vec cast_vec(const t_val& val, std::size_t size)
+{
+	using t_elem = typename t_vec::value_type;
+	using t_from = std::decay_t<t_val>;
+
+	if constexpr(std::is_same_v<t_from, t_vec>)
+		return val;
+	else if constexpr(!is_vec<t_from> && !std::is_same_v<t_from, t_vm_str> &&
+		std::is_constructible_v<t_elem, t_from>)
+	{
+		// set every element of the array to the scalar value
+		t_vec vec = m::create<t_vec>(size);
+		for(std::size_t i = 0; i < size; ++i)
+			vec[i] = t_elem(val);
+		return vec;
+	}
+	else
+		throw std::runtime_error("Invalid cast to array.");
+}
+// ----------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------
+// operators
+// ----------------------------------------------------------------------------
+template<class t_val1, class t_val2>
+t_val1 op_mod(const t_val1& val1, const t_val2& val2)
+{
+	if constexpr(std::is_floating_point_v<t_val1>)
+		return std::fmod(val1, val2);
+	else
+		return val1 % val2;
+}
+
+
+template<class t_val1, class t_val2>
+t_val1 op_pow(const t_val1& val1, const t_val2& val2)
+{
+	return power<t_val1, t_val2>(val1, val2);
+}
+
+
+template<class t_val1, class t_val2>
+bool equ(const t_val1& val1, const t_val2& val2)
+{
+	if constexpr(std::is_same_v<t_val1, t_vm_real> && std::is_same_v<t_val2, t_vm_real>)
+		return std::abs(val1 - val2) <= g_eps;
+	else if constexpr(is_vec<t_val1> && std::is_same_v<t_val1, t_val2>)
+		return m::equals(val1, val2, g_eps);
+	else
+		return val1 == val2;
+}
+
+
+template<class t_val1, class t_val2>
+bool nequ(const t_val1& val1, const t_val2& val2)
+{
+	return !equ(val1, val2);
+}
+
+
+template<class t_vec>
+typename t_vec::value_type inner(const t_vec& vec1, const t_vec& vec2)
+{
+	return m::inner<t_vec>(vec1, vec2);
+}
+
+
+template<class t_vec>
+t_vec matmul(const t_vec& vec1, const t_vec& vec2,
+	t_vm_int M1_rows, t_vm_int M1_cols, t_vm_int M2_rows, t_vm_int M2_cols)
+{
+	using t_mat = m::mat<typename t_vec::value_type, std::vector>;
+
+	// matrices as flat vectors
+	t_mat M1 = m::create<t_mat>(M1_rows, M1_cols, vec1);
+	t_mat M2 = m::create<t_mat>(M2_rows, M2_cols, vec2);
+	t_mat prod = M1 * M2;
+
+	return t_vec{prod.data(), prod.size1()*prod.size2()};
+}
+// ----------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------
+// arrays
+// ----------------------------------------------------------------------------
+template<class t_arr>
+auto at(const t_arr& arr, t_vm_int idx)
+{
+	idx = safe_array_index<t_vm_int>(idx, static_cast<t_vm_int>(arr.size()));
+
+	// gets string element as substring
+	if constexpr(std::is_same_v<t_arr, t_vm_str>)
+		return t_vm_str(1, arr[idx]);
+	else
+		return arr[idx];
+}
+
+
+template<class t_arr>
+t_arr range(const t_arr& arr, t_vm_int idx1, t_vm_int idx2)
+{
+	idx1 = safe_array_index<t_vm_int>(idx1, static_cast<t_vm_int>(arr.size()));
+	idx2 = safe_array_index<t_vm_int>(idx2, static_cast<t_vm_int>(arr.size()));
+
+	t_vm_int delta = (idx2 >= idx1 ? 1 : -1);
+	idx2 += delta;
+
+	t_arr newarr{};
+	if constexpr(!std::is_same_v<t_arr, t_vm_str>)
+		newarr = zero_vec<t_arr>(std::abs(idx2 - idx1));
+
+	t_vm_int new_idx = 0;
+	for(t_vm_int idx = idx1; idx != idx2; idx += delta)
+	{
+		if constexpr(std::is_same_v<t_arr, t_vm_str>)
+			newarr += arr[idx];
+		else
+			newarr[new_idx++] = arr[idx];
+	}
+
+	return newarr;
+}
+
+
+template<class t_arr, class t_val>
+void set(t_arr& arr, t_vm_int idx, const t_val& val)
+{
+	if constexpr(!is_vec<t_arr>)
+		throw std::runtime_error("Cannot index non-array type.");
+	else
+	{
+		idx = safe_array_index<t_vm_int>(idx, static_cast<t_vm_int>(arr.size()));
+		arr[idx] = val;
+	}
+}
+
+
+template<class t_arr, class t_val>
+void set_range(t_arr& arr, t_vm_int idx1, t_vm_int idx2, const t_val& val)
+{
+	idx1 = safe_array_index<t_vm_int>(idx1, static_cast<t_vm_int>(arr.size()));
+	idx2 = safe_array_index<t_vm_int>(idx2, static_cast<t_vm_int>(arr.size()));
+
+	t_vm_int delta = (idx2 >= idx1 ? 1 : -1);
+	idx2 += delta;
+
+	std::size_t cur_idx = 0;
+	for(t_vm_int idx = idx1; idx != idx2; idx += delta)
+	{
+		// rhs is an array or a string
+		if constexpr(std::is_same_v<t_arr, t_val>)
+		{
+			if(cur_idx >= val.size())
+				throw std::runtime_error("Array index out of bounds.");
+			arr[idx] = val[cur_idx++];
+		}
+
+		// rhs is a scalar
+		else if constexpr(is_vec<t_arr> && !is_vec<t_val>)
+		{
+			arr[idx] = cast<typename t_arr::value_type>(val);
+		}
+
+		else
+		{
+			throw std::runtime_error("Array range has to be of array or scalar type.");
+		}
+	}
+}
+// ----------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------
+// external functions
+// ----------------------------------------------------------------------------
+template<class t_val>
+auto norm(const t_val& val)
+{
+	if constexpr(std::is_same_v<t_val, t_vm_real> || std::is_same_v<t_val, t_vm_int>)
+		return val < t_val(0) ? -val : val;
+	else if constexpr(std::is_same_v<t_val, t_vm_vec_real>)
+		return m::norm<t_vm_vec_real>(val);  // 2-norm for vectors
+	else
+		return val;
+}
+
+template<class t_val> auto abs(const t_val& val) { return norm(val); }
+template<class t_val> auto fabs(const t_val& val) { return norm(val); }
+
+template<class t_val> t_vm_real sqrt(const t_val& val) { return std::sqrt(cast<t_vm_real>(val)); }
+template<class t_val> t_vm_real exp(const t_val& val) { return std::exp(cast<t_vm_real>(val)); }
+template<class t_val> t_vm_real sin(const t_val& val) { return std::sin(cast<t_vm_real>(val)); }
+template<class t_val> t_vm_real cos(const t_val& val) { return std::cos(cast<t_vm_real>(val)); }
+template<class t_val> t_vm_real tan(const t_val& val) { return std::tan(cast<t_vm_real>(val)); }
+
+template<class t_val1, class t_val2>
+t_vm_real pow(const t_val1& val1, const t_val2& val2)
+{
+	return std::pow(cast<t_vm_real>(val1), cast<t_vm_real>(val2));
+}
+
+template<class t_val>
+void set_eps(const t_val& val)
+{
+	g_eps = cast<t_vm_real>(val);
+}
+
+template<class t_val>
+void set_prec(const t_val& val)
+{
+	g_prec = cast<t_vm_int>(val);
+	std::cout.precision(g_prec);
+}
+
+inline t_vm_real get_eps()
+{
+	return g_eps;
+}
+
+template<class t_val>
+void set_debug(const t_val&)
+{
+}
+
+template<class t_val>
+t_vm_str to_string(const t_val& val)
+{
+	return cast<t_vm_str>(val);
+}
+
+template<class t_val>
+t_vm_int strlen(const t_val& val)
+{
+	return static_cast<t_vm_int>(cast<t_vm_str>(val).length());
+}
+
+template<class t_val>
+void write(const t_val& val)
+{
+	std::cout << cast<t_vm_str>(val) << '\n';
+}
+
+template<class t_val>
+void write_no_cr(const t_val& val)
+{
+	std::cout << cast<t_vm_str>(val);
+}
+
+template<class ...t_vals>
+void print(const t_vals& ...vals)
+{
+	// write all items and a newline at once
+	t_vm_str line;
+	((line += cast<t_vm_str>(vals)), ...);
+	line += '\n';
+	std::cout << line;
+}
+
+template<class t_val>
+t_vm_real read_real(const t_val& prompt)
+{
+	std::cout << cast<t_vm_str>(prompt) << std::flush;
+
+	t_vm_real val{};
+	std::cin >> val;
+	return val;
+}
+
+template<class t_val>
+t_vm_int read_integer(const t_val& prompt)
+{
+	std::cout << cast<t_vm_str>(prompt) << std::flush;
+
+	t_vm_int val{};
+	std::cin >> val;
+	return val;
+}
+
+template<class t_val>
+void sleep(const t_val& val)
+{
+	std::cout.flush();
+	std::this_thread::sleep_for(std::chrono::milliseconds{cast<t_vm_int>(val)});
+}
+// ----------------------------------------------------------------------------
+
+}
+)RUNTIME";
+
+
+
+CppCodegen::CppCodegen(SymTab* syms, std::ostream* ostr)
+	: Codegen(syms, ostr), m_cppostr{ostr}, m_out{&m_main}, m_indent{2}
+{ }
+
+
+CppCodegen::~CppCodegen()
+{ }
+
+
+/**
+ * write the header and the run-time support code
+ */
+void CppCodegen::Start(const t_str& srcname)
+{
+	(*m_cppostr) << "/**\n"
+		<< " * generated by the muF compiler";
+	if(srcname != "")
+		(*m_cppostr) << " from \"" << srcname << "\"";
+	(*m_cppostr) << "\n"
+		<< " * build using: c++ -std=c++20 -O2 -I<muF>/src -I<mathlibs> <file>.cpp\n"
+		<< " */\n";
+
+	(*m_cppostr) << g_cpp_runtime << "\n\n";
+}
+
+
+/**
+ * write the variables, functions and the main program
+ */
+std::streampos CppCodegen::Finish()
+{
+	for(const t_str& label : m_gotos)
+	{
+		if(m_labels.find(label) == m_labels.end())
+			throw std::runtime_error("Label \"" + label + "\" not found in the main program.");
+	}
+
+	// global variables
+	std::ostringstream globals;
+	DeclareVars("", globals, "static ");
+	if(globals.tellp() > 0)
+		(*m_cppostr) << "// global variables\n" << globals.str() << "\n\n";
+
+	// functions
+	if(m_protos.tellp() > 0)
+		(*m_cppostr) << "// functions\n" << m_protos.str() << "\n\n";
+	(*m_cppostr) << m_funcs.str();
+
+	// main program
+	(*m_cppostr) << "int main()\n{\n"
+		<< "\tstd::ios_base::sync_with_stdio(false);\n\n"
+		<< "\ttry\n\t{\n"
+		<< m_main.str()
+		<< "\t}\n"
+		<< "\tcatch(const std::exception& err)\n\t{\n"
+		<< "\t\tstd::cout.flush();\n"
+		<< "\t\tstd::cerr << \"Error: \" << err.what() << std::endl;\n"
+		<< "\t\treturn -1;\n"
+		<< "\t}\n\n"
+		<< "\tstd::cout.flush();\n"
+		<< "\treturn 0;\n"
+		<< "}\n";
+
+	m_cppostr->flush();
+	return m_cppostr->tellp();
+}
+
+
+/**
+ * get the c++ type corresponding to a symbol type
+ */
+t_str CppCodegen::GetCppType(SymbolType ty) const
+{
+	switch(ty)
+	{
+		case SymbolType::REAL: return "t_vm_real";
+		case SymbolType::INT: return "t_vm_int";
+		case SymbolType::CPLX: return "t_vm_cplx";
+		case SymbolType::QUAT: return "t_vm_quat";
+		case SymbolType::BOOL: return "bool";
+		case SymbolType::STRING: return "t_vm_str";
+		case SymbolType::REAL_ARRAY: return "t_vm_vec_real";
+		case SymbolType::INT_ARRAY: return "t_vm_vec_int";
+		case SymbolType::CPLX_ARRAY: return "t_vm_vec_cplx";
+		case SymbolType::QUAT_ARRAY: return "t_vm_vec_quat";
+		case SymbolType::VOID: return "void";
+		default: break;
+	}
+
+	throw std::runtime_error("Type \"" + Symbol::get_type_name(ty)
+		+ "\" is not supported by the C++ backend.");
+}
+
+
+/**
+ * get the c++ return type of a function
+ */
+t_str CppCodegen::GetCppRetType(const ASTFunc* func) const
+{
+	std::vector<t_str> rettypes;
+	for(const auto& [retname, rettype, dims] : func->GetRets())
+		rettypes.push_back(GetCppType(GetSym(retname)->ty));
+
+	if(rettypes.size() == 0)
+		return "void";
+	else if(rettypes.size() == 1)
+		return rettypes[0];
+
+	// multiple return values
+	t_str ty = "std::tuple<";
+	for(std::size_t i = 0; i < rettypes.size(); ++i)
+	{
+		ty += rettypes[i];
+		if(i + 1 < rettypes.size())
+			ty += ", ";
+	}
+	ty += ">";
+	return ty;
+}
+
+
+/**
+ * get the c++ identifier of a variable
+ */
+t_str CppCodegen::GetCppVar(t_astret sym) const
+{
+	return "v_" + sym->name;
+}
+
+
+/**
+ * get the c++ identifier of a function
+ */
+t_str CppCodegen::GetCppFunc(const t_str& name) const
+{
+	return "f_" + name;
+}
+
+
+/**
+ * get the c++ identifier of a jump label
+ */
+t_str CppCodegen::GetCppLabel(const t_str& name) const
+{
+	// labels start with a dot
+	t_str label = "l_";
+	for(char c : name)
+	{
+		if(c != '.')
+			label += c;
+	}
+	return label;
+}
+
+
+/**
+ * get the value of a freshly declared variable
+ */
+t_str CppCodegen::GetCppDefault(t_astret sym) const
+{
+	if(IsArray(sym->ty))
+	{
+		return "rt::zero_vec<" + GetCppType(sym->ty) + ">("
+			+ std::to_string(sym->get_total_size()) + ")";
+	}
+
+	return GetCppType(sym->ty) + "{}";
+}
+
+
+/**
+ * return statement of the current function
+ */
+t_str CppCodegen::GetReturn() const
+{
+	if(m_cur_rets.size() == 0)
+		return "return;";
+	else if(m_cur_rets.size() == 1)
+		return "return " + GetCppVar(m_cur_rets[0]) + ";";
+
+	t_str ret = "return std::make_tuple(";
+	for(std::size_t i = 0; i < m_cur_rets.size(); ++i)
+	{
+		ret += GetCppVar(m_cur_rets[i]);
+		if(i + 1 < m_cur_rets.size())
+			ret += ", ";
+	}
+	ret += ");";
+	return ret;
+}
+
+
+/**
+ * declare the variables of a scope, they are initialised where the
+ * program declares them, so that jumps don't cross any initialisations
+ */
+void CppCodegen::DeclareVars(const t_str& scope, std::ostream& ostr, const t_str& indent)
+{
+	std::vector<SymbolPtr> syms = m_syms->FindSymbolsWithSameScope(scope);
+	std::erase_if(syms, [this](const SymbolPtr& sym) -> bool
+	{
+		switch(sym->ty)
+		{
+			case SymbolType::FUNC:
+			case SymbolType::COMP:
+			case SymbolType::VOID:
+			case SymbolType::UNKNOWN:
+				return true;
+			default:
+				return false;
+		}
+	});
+
+	// sort by name for a reproducible output
+	std::sort(syms.begin(), syms.end(), [](const SymbolPtr& sym1, const SymbolPtr& sym2) -> bool
+	{
+		return sym1->name < sym2->name;
+	});
+
+	for(const SymbolPtr& sym : syms)
+	{
+		ostr << indent << GetCppType(sym->ty) << " " << GetCppVar(sym);
+		if(IsArray(sym->ty))
+			ostr << " = " << GetCppDefault(sym) << ";\n";
+		else
+			ostr << "{};\n";
+	}
+}
+
+
+/**
+ * emits an indented line in the current block
+ */
+std::ostream& CppCodegen::Line()
+{
+	for(std::size_t i = 0; i < m_indent; ++i)
+		m_out->put('\t');
+	return *m_out;
+}
+
+
+/**
+ * evaluates an expression, returns its type and c++ code
+ */
+std::pair<t_astret, t_str> CppCodegen::Expr(const ASTPtr& ast)
+{
+	m_expr.clear();
+	t_astret ty = ast->accept(this);
+	return std::make_pair(ty, m_expr);
+}
+
+
+/**
+ * converts an expression to the given type
+ */
+t_str CppCodegen::CastExpr(const t_str& expr, t_astret ty_from, t_astret ty_to,
+	bool allow_array_cast) const
+{
+	if(!ty_to)
+		return expr;
+
+	// use return type for function
+	SymbolType to = ty_to->ty == SymbolType::FUNC ? ty_to->retty : ty_to->ty;
+	if(ty_from)
+	{
+		SymbolType from = ty_from->ty == SymbolType::FUNC ? ty_from->retty : ty_from->ty;
+		if(from == to)
+			return expr;
+	}
+
+	switch(to)
+	{
+		case SymbolType::REAL:
+		case SymbolType::INT:
+		case SymbolType::CPLX:
+		case SymbolType::QUAT:
+		case SymbolType::STRING:
+		case SymbolType::BOOL:
+			return "rt::cast<" + GetCppType(to) + ">(" + expr + ")";
+
+		case SymbolType::REAL_ARRAY:
+		case SymbolType::INT_ARRAY:
+		case SymbolType::CPLX_ARRAY:
+		case SymbolType::QUAT_ARRAY:
+			if(!allow_array_cast)
+				return expr;
+			return "rt::cast_vec<" + GetCppType(to) + ">(" + expr + ", "
+				+ std::to_string(ty_to->get_total_size()) + ")";
+
+		default:
+			return expr;
+	}
+}
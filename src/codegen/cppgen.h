@@ -0,0 +1,160 @@
+/**
+ * c++ source code generator
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __CPPGEN_H__
+#define __CPPGEN_H__
+
+#include "codegen.h"
+
+#include <sstream>
+#include <unordered_set>
+
+
+/**
+ * transpiles the syntax tree into a single c++ translation unit
+ * (the symbol lookup and type promotion rules are shared with the
+ * zero-address code generator, so that both backends agree on the casts;
+ * the return value is only used for type information, the generated
+ * expression is stored in m_expr)
+ */
+class CppCodegen : public Codegen
+{
+public:
+	CppCodegen(SymTab* syms, std::ostream* ostr = &std::cout);
+	virtual ~CppCodegen();
+
+	CppCodegen(const CppCodegen&) = delete;
+	const CppCodegen& operator=(const CppCodegen&) = delete;
+
+	virtual t_astret visit(const ASTUMinus* ast) override;
+	virtual t_astret visit(const ASTPlus* ast) override;
+	virtual t_astret visit(const ASTMult* ast) override;
+	virtual t_astret visit(const ASTMod* ast) override;
+	virtual t_astret visit(const ASTPow* ast) override;
+	virtual t_astret visit(const ASTNorm* ast) override;
+
+	virtual t_astret visit(const ASTVarDecl* ast) override;
+	virtual t_astret visit(const ASTVar* ast) override;
+	virtual t_astret visit(const ASTAssign* ast) override;
+	virtual t_astret visit(const ASTVarRange* ast) override;
+
+	virtual t_astret visit(const ASTArrayAccess* ast) override;
+	virtual t_astret visit(const ASTArrayAssign* ast) override;
+
+	virtual t_astret visit(const ASTNumConst<t_real>* ast) override;
+	virtual t_astret visit(const ASTNumConst<t_int>* ast) override;
+	virtual t_astret visit(const ASTNumConst<t_cplx>* ast) override;
+	virtual t_astret visit(const ASTNumConst<t_quat>* ast) override;
+	virtual t_astret visit(const ASTNumConst<bool>* ast) override;
+
+	virtual t_astret visit(const ASTNumConstList<t_int>* ast) override;
+
+	virtual t_astret visit(const ASTStrConst* ast) override;
+
+	virtual t_astret visit(const ASTFunc* ast) override;
+	virtual t_astret visit(const ASTCall* ast) override;
+	virtual t_astret visit(const ASTReturn* ast) override;
+	virtual t_astret visit(const ASTStmts* ast) override;
+
+	virtual t_astret visit(const ASTCond* ast) override;
+	virtual t_astret visit(const ASTLoop* ast) override;
+	virtual t_astret visit(const ASTCases* ast) override;
+	virtual t_astret visit(const ASTRangedLoop* ast) override;
+	virtual t_astret visit(const ASTLoopBreak* ast) override;
+	virtual t_astret visit(const ASTLoopNext* ast) override;
+
+	virtual t_astret visit(const ASTComp* ast) override;
+	virtual t_astret visit(const ASTBool* ast) override;
+	virtual t_astret visit(const ASTExprList* ast) override;
+
+	virtual t_astret visit(const ASTLabel* ast) override;
+	virtual t_astret visit(const ASTJump* ast) override;
+
+	void Start(const t_str& srcname = "");
+	std::streampos Finish();
+
+
+protected:
+	// evaluates an expression, returns its type and c++ code
+	std::pair<t_astret, t_str> Expr(const ASTPtr& ast);
+
+	// converts an expression to the given type
+	t_str CastExpr(const t_str& expr, t_astret ty_from, t_astret ty_to,
+		bool allow_array_cast = false) const;
+
+	// converts an array index expression to an integer
+	t_str IndexExpr(const ASTPtr& ast);
+
+	// gets the flattened index of a (multi-dimensional) array access
+	t_str FlatIndexExpr(const ASTPtr& num, t_astret arr);
+
+	// get c++ type names and identifiers
+	t_str GetCppType(SymbolType ty) const;
+	t_str GetCppRetType(const ASTFunc* func) const;
+	t_str GetCppVar(t_astret sym) const;
+	t_str GetCppFunc(const t_str& name) const;
+	t_str GetCppLabel(const t_str& name) const;
+	t_str GetCppDefault(t_astret sym) const;
+
+	// return statement of the current function
+	t_str GetReturn() const;
+
+	// declarations of the variables in a scope
+	void DeclareVars(const t_str& scope, std::ostream& ostr, const t_str& indent);
+
+	// emits a line in the current block
+	std::ostream& Line();
+
+	// emits a statement, expressions are evaluated for their side effects
+	void Stmt(const ASTPtr& ast);
+
+	// emits a block into a separate buffer
+	template<class t_func> t_str Block(t_func&& func)
+	{
+		std::ostringstream ostr;
+		std::ostream* out = m_out;
+
+		m_out = &ostr;
+		++m_indent;
+		func();
+		--m_indent;
+		m_out = out;
+
+		return ostr.str();
+	}
+
+	// emits the body of a loop with the labels needed for multi-level jumps
+	void Loop(const t_str& head, const ASTPtr& stmts, const t_str& inc = "");
+
+
+private:
+	// final code output
+	std::ostream* m_cppostr{&std::cout};
+
+	// generated code of the current expression
+	t_str m_expr{};
+
+	// function prototypes and definitions, main program body
+	std::ostringstream m_protos{}, m_funcs{}, m_main{};
+
+	// current output block and indentation
+	std::ostream* m_out{nullptr};
+	std::size_t m_indent{1};
+
+	// return variables of the current function
+	std::vector<t_astret> m_cur_rets{};
+
+	// labels and jump targets of the current function
+	std::unordered_set<t_str> m_labels{}, m_gotos{};
+
+	// currently active loops: [ ident, next jump used, break jump used ]
+	std::size_t m_loop_ident{0};
+	std::vector<std::tuple<std::size_t, bool, bool>> m_loops{};
+};
+
+
+#endif
@@ -0,0 +1,576 @@
+/**
+ * c++ source code generator -- expressions
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "cppgen.h"
+#include "vm/extfuncs.h"
+
+#include <cmath>
+#include <limits>
+
+
+// ----------------------------------------------------------------------------
+// operations
+// ----------------------------------------------------------------------------
+t_astret CppCodegen::visit(const ASTUMinus* ast)
+{
+	auto [term, expr] = Expr(ast->GetTerm());
+
+	m_expr = "(-" + expr + ")";
+	return term;
+}
+
+
+t_astret CppCodegen::visit(const ASTPlus* ast)
+{
+	auto [term1, expr1] = Expr(ast->GetTerm1());
+	auto [term2, expr2] = Expr(ast->GetTerm2());
+
+	// cast if needed
+	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
+	if(first_ty)
+		expr1 = CastExpr(expr1, term1, first_ty);
+	if(second_ty)
+		expr2 = CastExpr(expr2, term2, second_ty);
+
+	m_expr = "(" + expr1 + (ast->IsInverted() ? " - " : " + ") + expr2 + ")";
+	return res_ty;
+}
+
+
+t_astret CppCodegen::visit(const ASTMult* ast)
+{
+	auto [term1, expr1] = Expr(ast->GetTerm1());
+	auto [term2, expr2] = Expr(ast->GetTerm2());
+
+	// cast if needed
+	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
+	if(first_ty)
+		expr1 = CastExpr(expr1, term1, first_ty);
+	if(second_ty)
+		expr2 = CastExpr(expr2, term2, second_ty);
+
+	// division
+	if(ast->IsInverted())
+	{
+		if(term2 && IsArray(term2->ty))
+			throw std::runtime_error("ASTMult: Cannot divide by array.");
+
+		m_expr = "(" + expr1 + " / " + expr2 + ")";
+		return res_ty;
+	}
+
+	bool arr1 = term1 && IsArray(term1->ty);
+	bool arr2 = term2 && IsArray(term2->ty);
+
+	// scalar multiplication
+	if(!res_ty || !IsArray(res_ty->ty) || !arr1 || !arr2)
+	{
+		m_expr = "(" + expr1 + " * " + expr2 + ")";
+		return res_ty;
+	}
+
+	// inner product
+	if(term1->dims.size() == 1 && term2->dims.size() == 1)
+	{
+		m_expr = "rt::inner(" + expr1 + ", " + expr2 + ")";
+		return GetArrayTypeConst(res_ty->ty).second;
+	}
+
+	// matrix multiplication
+	t_vm_int M1_rows = 0, M1_cols = 0;
+	t_vm_int M2_rows = 0, M2_cols = 0;
+	std::vector<std::size_t> res_dims;
+
+	// matrix-vector multiplication
+	if(term1->dims.size() == 2 && term2->dims.size() == 1)
+	{
+		M1_rows = term1->dims[0];
+		M1_cols = term1->dims[1];
+		M2_rows = term2->dims[0];
+		M2_cols = 1;
+		res_dims = { term1->dims[0] };
+	}
+	// vector-matrix multiplication
+	else if(term1->dims.size() == 1 && term2->dims.size() == 2)
+	{
+		M1_rows = 1;
+		M1_cols = term1->dims[0];
+		M2_rows = term2->dims[0];
+		M2_cols = term2->dims[1];
+		res_dims = { term2->dims[1] };
+	}
+	// matrix-matrix multiplication
+	else if(term1->dims.size() == 2 && term2->dims.size() == 2)
+	{
+		M1_rows = term1->dims[0];
+		M1_cols = term1->dims[1];
+		M2_rows = term2->dims[0];
+		M2_cols = term2->dims[1];
+		res_dims = { term1->dims[0], term2->dims[1] };
+	}
+	else
+	{
+		throw std::runtime_error("ASTMult: Invalid array dimensions.");
+	}
+
+	m_expr = "rt::matmul(" + expr1 + ", " + expr2 + ", "
+		+ std::to_string(M1_rows) + ", " + std::to_string(M1_cols) + ", "
+		+ std::to_string(M2_rows) + ", " + std::to_string(M2_cols) + ")";
+
+	t_astret mat_ty = std::make_shared<Symbol>(*GetArrayTypeConst(res_ty->ty).first);
+	mat_ty->dims = res_dims;
+	return mat_ty;
+}
+
+
+t_astret CppCodegen::visit(const ASTMod* ast)
+{
+	auto [term1, expr1] = Expr(ast->GetTerm1());
+	auto [term2, expr2] = Expr(ast->GetTerm2());
+
+	// cast if needed
+	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
+	if(first_ty)
+		expr1 = CastExpr(expr1, term1, first_ty);
+	if(second_ty)
+		expr2 = CastExpr(expr2, term2, second_ty);
+
+	m_expr = "rt::op_mod(" + expr1 + ", " + expr2 + ")";
+	return res_ty;
+}
+
+
+t_astret CppCodegen::visit(const ASTPow* ast)
+{
+	auto [term1, expr1] = Expr(ast->GetTerm1());
+	auto [term2, expr2] = Expr(ast->GetTerm2());
+
+	// cast if needed
+	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
+	if(first_ty)
+		expr1 = CastExpr(expr1, term1, first_ty);
+	if(second_ty)
+		expr2 = CastExpr(expr2, term2, second_ty);
+
+	m_expr = "rt::op_pow(" + expr1 + ", " + expr2 + ")";
+	return res_ty;
+}
+
+
+t_astret CppCodegen::visit(const ASTNorm* ast)
+{
+	auto [term, expr] = Expr(ast->GetTerm());
+
+	m_expr = "rt::norm(" + expr + ")";
+
+	// the norm of a vector is a scalar
+	if(term && IsArray(term->ty))
+		return GetTypeConst(SymbolType::REAL);
+	return term;
+}
+
+
+t_astret CppCodegen::visit(const ASTComp* ast)
+{
+	auto [term1, expr1] = Expr(ast->GetTerm1());
+	auto [term2, expr2] = Expr(ast->GetTerm2());
+
+	// cast if needed
+	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
+	if(first_ty)
+		expr1 = CastExpr(expr1, term1, first_ty);
+	if(second_ty)
+		expr2 = CastExpr(expr2, term2, second_ty);
+
+	switch(ast->GetOp())
+	{
+		case ASTComp::EQU:
+			m_expr = "rt::equ(" + expr1 + ", " + expr2 + ")";
+			break;
+		case ASTComp::NEQ:
+			m_expr = "rt::nequ(" + expr1 + ", " + expr2 + ")";
+			break;
+		case ASTComp::GT:
+			m_expr = "(" + expr1 + " > " + expr2 + ")";
+			break;
+		case ASTComp::LT:
+			m_expr = "(" + expr1 + " < " + expr2 + ")";
+			break;
+		case ASTComp::GEQ:
+			m_expr = "(" + expr1 + " >= " + expr2 + ")";
+			break;
+		case ASTComp::LEQ:
+			m_expr = "(" + expr1 + " <= " + expr2 + ")";
+			break;
+		default:
+			throw std::runtime_error("ASTComp: Invalid operation.");
+			break;
+	}
+
+	return GetTypeConst(SymbolType::BOOL);
+}
+
+
+t_astret CppCodegen::visit(const ASTBool* ast)
+{
+	// both operands are evaluated, as in the vm
+	t_str expr1 = Expr(ast->GetTerm1()).second;
+	t_str expr2;
+	if(ast->GetTerm2())
+		expr2 = Expr(ast->GetTerm2()).second;
+
+	switch(ast->GetOp())
+	{
+		case ASTBool::XOR:
+			m_expr = "(bool(" + expr1 + ") != bool(" + expr2 + "))";
+			break;
+		case ASTBool::OR:
+			m_expr = "(bool(" + expr1 + ") | bool(" + expr2 + "))";
+			break;
+		case ASTBool::AND:
+			m_expr = "(bool(" + expr1 + ") & bool(" + expr2 + "))";
+			break;
+		case ASTBool::NOT:
+			m_expr = "(!" + expr1 + ")";
+			break;
+		default:
+			throw std::runtime_error("ASTBool: Invalid operation.");
+			break;
+	}
+
+	return nullptr;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// variables and constants
+// ----------------------------------------------------------------------------
+t_astret CppCodegen::visit(const ASTVar* ast)
+{
+	const t_str& varname = ast->GetIdent();
+	t_astret sym = GetSym(varname);
+
+	if(sym->ty == SymbolType::FUNC)
+		throw std::runtime_error("ASTVar: Function addresses are not supported by the C++ backend.");
+
+	m_expr = GetCppVar(sym);
+	return sym;
+}
+
+
+t_astret CppCodegen::visit(const ASTVarRange*)
+{
+	// handled in ranged loop
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTNumConst<t_real>* ast)
+{
+	t_vm_real val = static_cast<t_vm_real>(ast->GetVal());
+
+	if(std::isnan(val))
+	{
+		m_expr = "std::numeric_limits<t_vm_real>::quiet_NaN()";
+	}
+	else if(std::isinf(val))
+	{
+		m_expr = t_str(val < 0. ? "(-" : "(")
+			+ "std::numeric_limits<t_vm_real>::infinity())";
+	}
+	else
+	{
+		std::ostringstream ostr;
+		ostr.precision(std::numeric_limits<t_vm_real>::max_digits10);
+		ostr << val;
+
+		// make sure the literal is a floating-point number
+		t_str num = ostr.str();
+		if(num.find_first_of(".en") == t_str::npos)
+			num += ".";
+
+		m_expr = val < 0. ? "(" + num + ")" : num;
+	}
+
+	return GetTypeConst(SymbolType::REAL);
+}
+
+
+t_astret CppCodegen::visit(const ASTNumConst<t_int>* ast)
+{
+	t_vm_int val = static_cast<t_vm_int>(ast->GetVal());
+	m_expr = "t_vm_int(" + std::to_string(val) + ")";
+	return GetTypeConst(SymbolType::INT);
+}
+
+
+t_astret CppCodegen::visit(const ASTNumConst<t_cplx>* ast)
+{
+	const t_vm_cplx& val = ast->GetVal();
+
+	m_expr = "t_vm_cplx(" + Expr(std::make_shared<ASTNumConst<t_real>>(val.real())).second
+		+ ", " + Expr(std::make_shared<ASTNumConst<t_real>>(val.imag())).second + ")";
+	return GetTypeConst(SymbolType::CPLX);
+}
+
+
+t_astret CppCodegen::visit(const ASTNumConst<t_quat>* ast)
+{
+	const t_vm_quat& val = ast->GetVal();
+
+	m_expr = "t_vm_quat(" + Expr(std::make_shared<ASTNumConst<t_real>>(val.real())).second
+		+ ", " + Expr(std::make_shared<ASTNumConst<t_real>>(val.imag1())).second
+		+ ", " + Expr(std::make_shared<ASTNumConst<t_real>>(val.imag2())).second
+		+ ", " + Expr(std::make_shared<ASTNumConst<t_real>>(val.imag3())).second + ")";
+	return GetTypeConst(SymbolType::QUAT);
+}
+
+
+t_astret CppCodegen::visit(const ASTNumConst<bool>* ast)
+{
+	m_expr = ast->GetVal() ? "true" : "false";
+	return GetTypeConst(SymbolType::BOOL);
+}
+
+
+t_astret CppCodegen::visit(const ASTStrConst* ast)
+{
+	std::ostringstream ostr;
+	ostr << "t_vm_str{\"";
+
+	// escape the string for a c++ literal
+	for(char c : ast->GetVal())
+	{
+		switch(c)
+		{
+			case '\"': ostr << "\\\""; break;
+			case '\\': ostr << "\\\\"; break;
+			case '\n': ostr << "\\n"; break;
+			case '\r': ostr << "\\r"; break;
+			case '\t': ostr << "\\t"; break;
+			default:
+				if(static_cast<unsigned char>(c) < 0x20)
+				{
+					// octal escape for other control characters
+					ostr << "\\" << std::oct << static_cast<int>(c) << std::dec;
+				}
+				else
+				{
+					ostr << c;
+				}
+				break;
+		}
+	}
+
+	ostr << "\"}";
+	m_expr = ostr.str();
+	return GetTypeConst(SymbolType::STRING);
+}
+
+
+t_astret CppCodegen::visit(const ASTNumConstList<t_int>*)
+{
+	// directly handled in grammar
+	return nullptr;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// arrays
+// ----------------------------------------------------------------------------
+/**
+ * converts an array index expression to an integer
+ */
+t_str CppCodegen::IndexExpr(const ASTPtr& ast)
+{
+	auto [ty, expr] = Expr(ast);
+	if(!ty || ty->ty != SymbolType::INT)
+		expr = CastExpr(expr, ty, GetTypeConst(SymbolType::INT));
+	return expr;
+}
+
+
+/**
+ * gets the flattened index of a (multi-dimensional) array access
+ */
+t_str CppCodegen::FlatIndexExpr(const ASTPtr& num, t_astret arr)
+{
+	// one-dimensional array
+	if(num->type() != ASTType::ExprList)
+		return IndexExpr(num);
+
+	// multi-dimensional array
+	auto indices = std::dynamic_pointer_cast<ASTExprList>(num)->GetList();
+	if(arr->dims.size() != indices.size())
+		throw std::runtime_error("ASTArrayAccess: Dimension mismatch.");
+
+	t_str expr;
+	std::size_t cur_dim = 0;
+	for(const auto& idx : indices)
+	{
+		if(cur_dim > 0)
+			expr += " + ";
+		expr += IndexExpr(idx);
+
+		// multiply with the rest of the array dimensions
+		t_vm_int dims_rest = t_vm_int(arr->get_total_size(cur_dim + 1));
+		if(dims_rest > 1)
+			expr += "*t_vm_int(" + std::to_string(dims_rest) + ")";
+
+		++cur_dim;
+	}
+
+	return "(" + expr + ")";
+}
+
+
+t_astret CppCodegen::visit(const ASTArrayAccess* ast)
+{
+	bool ranged12 = ast->IsRanged12();
+	const auto num1 = ast->GetNum1();
+	const auto num2 = ast->GetNum2();
+
+	auto [term, expr] = Expr(ast->GetTerm());
+	if(!term)
+		throw std::runtime_error("ASTArrayAccess: Invalid array term.");
+	auto [arr_ty, arr_elem_ty] = GetArrayTypeConst(term->ty);
+	if(!arr_elem_ty)
+		throw std::runtime_error("ASTArrayAccess: Invalid array type of \"" + term->name + "\".");
+
+	// single-element array access
+	if(!ranged12 && num1 && !num2)
+	{
+		m_expr = "rt::at(" + expr + ", " + FlatIndexExpr(num1, term) + ")";
+		return arr_elem_ty;
+	}
+
+	// ranged array access
+	else if(ranged12 && num1 && num2)
+	{
+		// TODO: multi-dimensional array
+		if(num1->type() == ASTType::ExprList || num2->type() == ASTType::ExprList)
+			throw std::runtime_error("ASTArrayAccess: Ranged multi-dimensional array access not yet supported.");
+
+		t_str idx1 = IndexExpr(num1);
+		t_str idx2 = IndexExpr(num2);
+		m_expr = "rt::range(" + expr + ", " + idx1 + ", " + idx2 + ")";
+		return arr_ty;
+	}
+
+	throw std::runtime_error("ASTArrayAccess: Invalid array access to \"" + term->name + "\".");
+}
+
+
+t_astret CppCodegen::visit(const ASTExprList* ast)
+{
+	if(!ast->IsArray())
+		throw std::runtime_error("ASTExprList: Expression lists are only supported as arrays by the C++ backend.");
+
+	const SymbolType arr_sym_ty = ast->GetArrayType();
+	auto [arr_ty, arr_elem_ty] = GetArrayTypeConst(arr_sym_ty);
+	if(!arr_ty || !arr_elem_ty)
+		throw std::runtime_error("ASTExprList: Invalid array type.");
+
+	// make sure all array elements are of the element type
+	t_str elems;
+	std::size_t num_elems = 0;
+	for(const auto& elem : ast->GetList())
+	{
+		auto [ty, expr] = Expr(elem);
+		if(num_elems > 0)
+			elems += ", ";
+		elems += CastExpr(expr, ty, arr_elem_ty);
+		++num_elems;
+	}
+
+	m_expr = "rt::make_vec<" + GetCppType(arr_sym_ty) + ">({ " + elems + " })";
+
+	t_astret sym_ret = std::make_shared<Symbol>(*arr_ty);
+	sym_ret->dims.resize(1);
+	sym_ret->dims[0] = num_elems;
+	return sym_ret;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// function calls
+// ----------------------------------------------------------------------------
+t_astret CppCodegen::visit(const ASTCall* ast)
+{
+	const t_str& funcname = ast->GetIdent();
+	t_astret func = GetSym(funcname, false, SymbolType::FUNC);
+
+	const ExtFuncInfo* extfunc = func->is_external ? get_vm_ext_func(funcname) : nullptr;
+	bool variadic = extfunc && extfunc->variadic;
+
+	std::size_t num_args = func->argty.size();
+	if(!variadic && ast->GetArgumentList().size() != num_args)
+	{
+		std::ostringstream ostr;
+		ostr << "ASTCall: Invalid number of function arguments for \"" << funcname
+			<< "\": expected " << num_args
+			<< ", got " << ast->GetArgumentList().size() << ".";
+		throw std::runtime_error(ostr.str());
+	}
+
+	// call external function
+	if(func->is_external)
+	{
+		if(!extfunc || funcname == "set_isr" || funcname == "set_timer")
+		{
+			throw std::runtime_error("ASTCall: External function \"" + funcname
+				+ "\" is not supported by the C++ backend.");
+		}
+
+		t_str args;
+		for(const ASTPtr& arg : ast->GetArgumentList())
+		{
+			if(args != "")
+				args += ", ";
+			args += Expr(arg).second;
+		}
+
+		m_expr = "rt::" + funcname + "(" + args + ")";
+		return func;
+	}
+
+	// call internal function, casting the arguments to the parameter types
+	std::vector<SymbolPtr> params = m_syms->FindSymbolsWithSameScope(
+		func->scoped_name + Symbol::get_scopenameseparator(), false);
+	std::erase_if(params, [](const SymbolPtr& sym) -> bool
+	{
+		return !sym->is_arg;
+	});
+	std::sort(params.begin(), params.end(), [](const SymbolPtr& sym1, const SymbolPtr& sym2) -> bool
+	{
+		return sym1->argidx < sym2->argidx;
+	});
+
+	if(params.size() != num_args)
+		throw std::runtime_error("ASTCall: Parameters of function \"" + funcname + "\" not found.");
+
+	t_str args;
+	std::size_t argidx = 0;
+	for(const ASTPtr& arg : ast->GetArgumentList())
+	{
+		auto [ty, expr] = Expr(arg);
+		if(argidx > 0)
+			args += ", ";
+		args += CastExpr(expr, ty, params[argidx], true);
+		++argidx;
+	}
+
+	m_expr = GetCppFunc(funcname) + "(" + args + ")";
+	return func;
+}
+// ----------------------------------------------------------------------------
@@ -0,0 +1,568 @@
+/**
+ * c++ source code generator -- statements
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "cppgen.h"
+
+#include <algorithm>
+
+
+/**
+ * emits a statement, expressions are evaluated for their side effects
+ */
+void CppCodegen::Stmt(const ASTPtr& ast)
+{
+	switch(ast->type())
+	{
+		case ASTType::UMinus:
+		case ASTType::Plus:
+		case ASTType::Mult:
+		case ASTType::Mod:
+		case ASTType::Pow:
+		case ASTType::Norm:
+		case ASTType::Var:
+		case ASTType::Call:
+		case ASTType::ArrayAccess:
+		case ASTType::Comp:
+		case ASTType::Bool:
+		case ASTType::StrConst:
+		case ASTType::NumConst:
+		{
+			t_str expr = Expr(ast).second;
+			if(expr != "")
+				Line() << expr << ";\n";
+			break;
+		}
+
+		case ASTType::ExprList:
+		{
+			// evaluate the individual expressions
+			auto exprs = std::dynamic_pointer_cast<ASTExprList>(ast);
+			if(exprs->IsArray())
+			{
+				Line() << Expr(ast).second << ";\n";
+			}
+			else
+			{
+				for(const ASTPtr& expr : exprs->GetList())
+					Stmt(expr);
+			}
+			break;
+		}
+
+		default:
+		{
+			ast->accept(this);
+			break;
+		}
+	}
+}
+
+
+
+// ----------------------------------------------------------------------------
+// variables
+// ----------------------------------------------------------------------------
+t_astret CppCodegen::visit(const ASTVarDecl* ast)
+{
+	t_astret sym_ret = nullptr;
+
+	for(const auto& varname : ast->GetVariables())
+	{
+		t_astret sym = GetSym(varname, true);
+
+		if(sym->is_arg)
+			continue;  // arguments already declared with function
+		if(!(sym->is_arg || sym->is_ret) && (ast->GetIntentIn() || ast->GetIntentOut()))
+			throw std::runtime_error("ASTVarDecl: Variable \"" + varname + "\" is not a function argument or return value, but has an intent declaration.");
+		if(sym->is_ret && ast->GetIntentIn())
+			throw std::runtime_error("ASTVarDecl: Variable \"" + varname + "\" is a function return value, but has an intent(in) declaration.");
+
+		// the variable itself is declared at the start of its scope
+		if(ast->GetAssignment())
+		{
+			// initialise variable using given assignment
+			ast->GetAssignment()->accept(this);
+		}
+		else
+		{
+			// initialise variable to 0 if no assignment is given
+			Line() << GetCppVar(sym) << " = " << GetCppDefault(sym) << ";\n";
+		}
+
+		if(!sym_ret)
+			sym_ret = sym;
+	}
+
+	return sym_ret;
+}
+
+
+t_astret CppCodegen::visit(const ASTAssign* ast)
+{
+	// expression statement
+	if(ast->IsNullAssign())
+	{
+		if(ast->GetExpr())
+			Stmt(ast->GetExpr());
+		return nullptr;
+	}
+
+	auto [ty, expr] = Expr(ast->GetExpr());
+
+	// single assignment
+	if(!ast->IsMultiAssign())
+	{
+		t_astret sym = GetSym(ast->GetIdent());
+		Line() << GetCppVar(sym) << " = " << CastExpr(expr, ty, sym, true) << ";\n";
+		return sym;
+	}
+
+	// return values of a function in the order of their declaration
+	std::vector<SymbolPtr> rets;
+	if(ty && ty->ty == SymbolType::FUNC && !ty->is_external)
+	{
+		rets = m_syms->FindSymbolsWithSameScope(
+			ty->scoped_name + Symbol::get_scopenameseparator());
+		std::erase_if(rets, [](const SymbolPtr& sym) -> bool
+		{
+			return !sym->is_ret;
+		});
+		std::sort(rets.begin(), rets.end(), [](const SymbolPtr& sym1, const SymbolPtr& sym2) -> bool
+		{
+			return sym1->retidx < sym2->retidx;
+		});
+	}
+
+	// multiple assignment from a tuple
+	Line() << "{\n";
+	++m_indent;
+	Line() << "auto ret = " << expr << ";\n";
+
+	t_astret sym_ret = nullptr;
+	std::size_t idx = 0;
+	for(const t_str& varname : ast->GetIdents())
+	{
+		t_astret sym = GetSym(varname);
+		t_astret ret_ty = idx < rets.size() ? rets[idx] : nullptr;
+
+		Line() << GetCppVar(sym) << " = " << CastExpr(
+			"std::get<" + std::to_string(idx) + ">(ret)", ret_ty, sym, true) << ";\n";
+
+		if(!sym_ret)
+			sym_ret = sym;
+		++idx;
+	}
+
+	--m_indent;
+	Line() << "}\n";
+
+	return sym_ret;
+}
+
+
+t_astret CppCodegen::visit(const ASTArrayAssign* ast)
+{
+	const t_str& varname = ast->GetIdent();
+	t_astret sym = GetSym(varname);
+
+	bool ranged12 = ast->IsRanged12();
+	const auto num1 = ast->GetNum1();
+	const auto num2 = ast->GetNum2();
+
+	// evaluate the rhs expression
+	auto [ty, expr] = Expr(ast->GetExpr());
+
+	// single-element array assignment
+	if(!ranged12 && num1 && !num2)
+	{
+		auto [arr_ty, arr_elem_ty] = GetArrayTypeConst(sym->ty);
+		if(!arr_elem_ty)
+			throw std::runtime_error("ASTArrayAssign: Invalid array element type in \"" + varname + "\".");
+
+		if(!ty || ty->ty != sym->ty)
+			expr = CastExpr(expr, ty, arr_elem_ty);
+
+		Line() << "rt::set(" << GetCppVar(sym) << ", "
+			<< FlatIndexExpr(num1, sym) << ", " << expr << ");\n";
+	}
+
+	// ranged array assignment
+	else if(ranged12 && num1 && num2)
+	{
+		// TODO: multi-dimensional array
+		if(num1->type() == ASTType::ExprList || num2->type() == ASTType::ExprList)
+			throw std::runtime_error("ASTArrayAssign: Ranged multi-dimensional array access not yet supported.");
+
+		t_str idx1 = IndexExpr(num1);
+		t_str idx2 = IndexExpr(num2);
+		Line() << "rt::set_range(" << GetCppVar(sym) << ", "
+			<< idx1 << ", " << idx2 << ", " << expr << ");\n";
+	}
+
+	return ty;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// functions
+// ----------------------------------------------------------------------------
+t_astret CppCodegen::visit(const ASTFunc* ast)
+{
+	const t_str& funcname = ast->GetIdent();
+	m_curscope.push_back(funcname);
+
+	t_astret func = GetSym(funcname);
+
+	// function arguments are passed by value
+	t_str args;
+	std::size_t argidx = 0;
+	for(const auto& [argname, argtype, dims] : ast->GetArgs())
+	{
+		t_astret sym = GetSym(argname);
+		if(!sym->is_arg)
+			throw std::runtime_error("ASTFunc: Function \"" + funcname + "\" variable \"" + argname + "\" is not an argument.");
+		if(sym->ty != argtype)
+			throw std::runtime_error("ASTFunc: Function \"" + funcname + "\" argument \"" + argname + "\" type mismatch.");
+		if(sym->argidx != argidx)
+			throw std::runtime_error("ASTFunc: Function \"" + funcname + "\" argument \"" + argname + "\" index mismatch.");
+
+		if(argidx > 0)
+			args += ", ";
+		args += GetCppType(sym->ty) + " " + GetCppVar(sym);
+		++argidx;
+	}
+
+	for(const auto& [retname, rettype, dims] : ast->GetRets())
+		m_cur_rets.push_back(GetSym(retname));
+
+	t_str sig = GetCppRetType(ast) + " " + GetCppFunc(funcname) + "(" + args + ")";
+	m_protos << "static " << sig << ";\n";
+
+	// local variables
+	std::ostringstream decls;
+	DeclareVars(func->scoped_name + Symbol::get_scopenameseparator(), decls, "\t");
+
+	// the main program's labels are kept separately
+	std::unordered_set<t_str> main_labels, main_gotos;
+	std::swap(m_labels, main_labels);
+	std::swap(m_gotos, main_gotos);
+
+	// function statement block
+	std::ostringstream body;
+	std::ostream* main_out = m_out;
+	std::size_t main_indent = m_indent;
+	m_out = &body;
+	m_indent = 1;
+
+	Stmt(ast->GetStatements());
+	if(m_cur_rets.size())
+		Line() << GetReturn() << "\n";
+
+	m_out = main_out;
+	m_indent = main_indent;
+
+	for(const t_str& label : m_gotos)
+	{
+		if(m_labels.find(label) == m_labels.end())
+			throw std::runtime_error("Label \"" + label + "\" not found in function \"" + funcname + "\".");
+	}
+
+	std::swap(m_labels, main_labels);
+	std::swap(m_gotos, main_gotos);
+
+	m_funcs << "static " << sig << "\n{\n";
+	if(decls.tellp() > 0)
+		m_funcs << decls.str() << "\n";
+	m_funcs << body.str() << "}\n\n\n";
+
+	m_loops.clear();
+	m_cur_rets.clear();
+	m_curscope.pop_back();
+
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTReturn* ast)
+{
+	if(!m_curscope.size())
+		throw std::runtime_error("ASTReturn: Not in a function.");
+
+	// return the current values of the return variables
+	if(ast->OnlyJumpToFuncEnd())
+	{
+		if(ast->GetRets())
+		{
+			throw std::runtime_error(
+				"ASTReturn: Given return values are not handled here,"
+				" but automatically pushed at the end of the function.");
+		}
+
+		Line() << GetReturn() << "\n";
+		return nullptr;
+	}
+
+	// explicitly return the given values
+	const auto& retasts = ast->GetRets()->GetList();
+	if(retasts.size() != m_cur_rets.size())
+		throw std::runtime_error("ASTReturn: Number of return values does not match the function declaration.");
+
+	t_astret sym_ret = nullptr;
+	std::vector<t_str> rets;
+	std::size_t idx = 0;
+	for(const auto& retast : retasts)
+	{
+		auto [ty, expr] = Expr(retast);
+		rets.push_back(CastExpr(expr, ty, m_cur_rets[idx], true));
+
+		if(!sym_ret)
+			sym_ret = ty;
+		++idx;
+	}
+
+	if(rets.size() == 0)
+	{
+		Line() << "return;\n";
+	}
+	else if(rets.size() == 1)
+	{
+		Line() << "return " << rets[0] << ";\n";
+	}
+	else
+	{
+		Line() << "return std::make_tuple(";
+		for(std::size_t i = 0; i < rets.size(); ++i)
+		{
+			*m_out << rets[i];
+			if(i + 1 < rets.size())
+				*m_out << ", ";
+		}
+		*m_out << ");\n";
+	}
+
+	return sym_ret;
+}
+
+
+t_astret CppCodegen::visit(const ASTStmts* ast)
+{
+	for(const auto& stmt : ast->GetStatementList())
+		Stmt(stmt);
+
+	return nullptr;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// conditionals
+// ----------------------------------------------------------------------------
+t_astret CppCodegen::visit(const ASTCond* ast)
+{
+	Line() << "if(" << Expr(ast->GetCond()).second << ")\n";
+	Line() << "{\n";
+	*m_out << Block([this, ast]() { Stmt(ast->GetIf()); });
+	Line() << "}\n";
+
+	if(ast->HasElse())
+	{
+		Line() << "else\n";
+		Line() << "{\n";
+		*m_out << Block([this, ast]() { Stmt(ast->GetElse()); });
+		Line() << "}\n";
+	}
+
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTCases* ast)
+{
+	bool first_case = true;
+
+	for(auto& [ cond, stmts ] : ast->GetCases())
+	{
+		// condition for the case: expr == case_cond?
+		t_str expr = Expr(ast->GetExpr()).second;
+		t_str cond_expr = Expr(cond).second;
+
+		Line() << (first_case ? "if" : "else if")
+			<< "(rt::equ(" << expr << ", " << cond_expr << "))\n";
+		Line() << "{\n";
+		*m_out << Block([this, &stmts]() { Stmt(stmts); });
+		Line() << "}\n";
+
+		first_case = false;
+	}
+
+	// default case
+	if(ast->GetDefaultCase())
+	{
+		if(!first_case)
+		{
+			Line() << "else\n";
+			Line() << "{\n";
+		}
+		*m_out << Block([this, ast]() { Stmt(ast->GetDefaultCase()); });
+		if(!first_case)
+			Line() << "}\n";
+	}
+
+	return nullptr;
+}
+// ----------------------------------------------------------------------------
+
+
+
+// ----------------------------------------------------------------------------
+// loops
+// ----------------------------------------------------------------------------
+/**
+ * emits the body of a loop with the labels needed for multi-level jumps,
+ * the next-label is placed after the increment, as in the vm
+ */
+void CppCodegen::Loop(const t_str& head, const ASTPtr& stmts, const t_str& inc)
+{
+	std::size_t loop_ident = ++m_loop_ident;
+	m_loops.emplace_back(std::make_tuple(loop_ident, false, false));
+
+	t_str body = Block([this, &stmts]() { Stmt(stmts); });
+	auto [ident, next_used, break_used] = m_loops.back();
+	m_loops.pop_back();
+
+	const t_str label = "loop" + std::to_string(loop_ident);
+
+	Line() << head << "\n";
+	Line() << "{\n";
+	*m_out << body;
+	++m_indent;
+	if(inc != "")
+		Line() << inc << "\n";
+	if(next_used)
+		Line() << label << "_next:;\n";
+	--m_indent;
+	Line() << "}\n";
+	if(break_used)
+		Line() << label << "_end:;\n";
+}
+
+
+t_astret CppCodegen::visit(const ASTLoop* ast)
+{
+	Loop("while(" + Expr(ast->GetCond()).second + ")", ast->GetLoopStmt());
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTRangedLoop* ast)
+{
+	const auto& range = ast->GetRange();
+	t_astret ctr_sym = GetSym(range->GetIdent());
+	const t_str ctr = GetCppVar(ctr_sym);
+
+	// assign initial counter variable
+	auto [begin_ty, begin] = Expr(range->GetBegin());
+	Line() << ctr << " = " << CastExpr(begin, begin_ty, ctr_sym, true) << ";\n";
+
+	// loop condition: check if the counter is smaller than the end value
+	t_str end = Expr(range->GetEnd()).second;
+
+	// increment counter, by 1 if nothing is given
+	t_str inc;
+	if(range->GetInc())
+	{
+		auto [inc_ty, inc_expr] = Expr(range->GetInc());
+		bool same_ty = inc_ty && inc_ty->ty == ctr_sym->ty;
+		inc = ctr + " = " + CastExpr("(" + inc_expr + " + " + ctr + ")",
+			same_ty ? inc_ty : nullptr, ctr_sym) + ";";
+	}
+	else
+	{
+		inc = "++" + ctr + ";";
+	}
+
+	Loop("while(" + ctr + " <= " + end + ")", ast->GetLoopStmt(), inc);
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTLoopBreak* ast)
+{
+	if(!m_loops.size())
+		throw std::runtime_error("ASTLoopBreak: Not in a loop.");
+
+	t_int loop_depth = ast->GetNumLoops();
+
+	// reduce to maximum loop depth
+	if(static_cast<std::size_t>(loop_depth) >= m_loops.size() || loop_depth < 0)
+		loop_depth = static_cast<t_int>(m_loops.size()-1);
+
+	if(loop_depth == 0)
+	{
+		Line() << "break;\n";
+		return nullptr;
+	}
+
+	// jump to the end of an outer loop
+	auto& loop = m_loops[m_loops.size()-loop_depth-1];
+	std::get<2>(loop) = true;
+	Line() << "goto loop" << std::get<0>(loop) << "_end;\n";
+
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTLoopNext* ast)
+{
+	if(!m_loops.size())
+		throw std::runtime_error("ASTLoopNext: Not in a loop.");
+
+	t_int loop_depth = ast->GetNumLoops();
+
+	// reduce to maximum loop depth
+	if(static_cast<std::size_t>(loop_depth) >= m_loops.size() || loop_depth < 0)
+		loop_depth = static_cast<t_int>(m_loops.size()-1);
+
+	// the loop condition is checked next without incrementing the counter
+	if(loop_depth == 0)
+	{
+		Line() << "continue;\n";
+		return nullptr;
+	}
+
+	// jump to the beginning of an outer loop
+	auto& loop = m_loops[m_loops.size()-loop_depth-1];
+	std::get<1>(loop) = true;
+	Line() << "goto loop" << std::get<0>(loop) << "_next;\n";
+
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTLabel* ast)
+{
+	m_labels.insert(ast->GetIdent());
+	Line() << GetCppLabel(ast->GetIdent()) << ":;\n";
+
+	return nullptr;
+}
+
+
+t_astret CppCodegen::visit(const ASTJump* ast)
+{
+	if(ast->IsComefrom())
+		throw std::runtime_error("Comefrom is not (yet) implemented...");
+
+	m_gotos.insert(ast->GetLabel());
+	Line() << "goto " << GetCppLabel(ast->GetLabel()) << ";\n";
+
+	return nullptr;
+}
+// ----------------------------------------------------------------------------
@@ -6,6 +6,7 @@
  */
 
 #include "codegen.h"
+#include "vm/extfuncs.h"
 
 
 /**
@@ -53,10 +54,11 @@ t_astret Codegen::visit(const ASTFunc* ast)
 
 	// safety jump to the end of the function to prevent accidental execution
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH)); // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	std::streampos safety_jmp_streampos = m_ostr->tellp();
 	t_vm_addr dummy_addr = 0;
 	m_ostr->write(reinterpret_cast<const char*>(&dummy_addr), vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 
 	auto argnames = ast->GetArgs();
@@ -110,13 +112,15 @@ t_astret Codegen::visit(const ASTFunc* ast)
 	// push stack frame size for returning
 	t_vm_int framesize = static_cast<t_vm_int>(GetStackFrameSize(func));
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+	write_vm_descr(*m_ostr, VMType::INT);
 	m_ostr->write(reinterpret_cast<const char*>(&framesize), vm_type_size<VMType::INT, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 
 	// push number of arguments for returning
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+	write_vm_descr(*m_ostr, VMType::INT);
 	m_ostr->write(reinterpret_cast<const char*>(&num_args), vm_type_size<VMType::INT, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 
 	// return instruction
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::RET));
@@ -125,12 +129,31 @@ t_astret Codegen::visit(const ASTFunc* ast)
 	std::streampos end_func_streampos = m_ostr->tellp();
 	func->end_addr = end_func_streampos;
 
+	m_functab.AddFunc(FuncTable::Func
+	{
+		.name = funcname,
+		.addr = static_cast<t_vm_addr>(*func->addr),
+		.end_addr = static_cast<t_vm_addr>(*func->end_addr),
+		.num_args = num_args,
+		.framesize = framesize,
+	});
+
+	if(m_debuginfo)
+	{
+		auto lines = ast->GetLineRange();
+		m_debuginfo->AddFunc(funcname, *func->addr, *func->end_addr,
+			lines ? static_cast<t_vm_addr>(lines->first) : 0);
+
+		// the code skipping over the function has no source line
+		m_debuginfo->AddLine(*func->end_addr, 0);
+	}
+
 	// fill in any saved, unset end-of-function jump addresses
 	for(std::streampos pos : m_pushret_comefroms)
 	{
 		t_vm_addr to_skip = pushret_streampos - pos;
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip), vm_type_size<VMType::ADDR_IP, false>);
 	}
@@ -140,7 +163,7 @@ t_astret Codegen::visit(const ASTFunc* ast)
 	{
 		t_vm_addr to_skip = ret_streampos - pos;
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip), vm_type_size<VMType::ADDR_IP, false>);
 	}
@@ -149,7 +172,7 @@ t_astret Codegen::visit(const ASTFunc* ast)
 	// fill in address of safety jump
 	t_vm_addr to_skip = end_func_streampos - safety_jmp_streampos;
 	// already skipped over address and jmp instruction
-	to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+	to_skip -= g_vm_addr_skip;
 	m_ostr->seekp(safety_jmp_streampos);
 	m_ostr->write(reinterpret_cast<const char*>(&to_skip), vm_type_size<VMType::ADDR_IP, false>);
 
@@ -167,22 +190,31 @@ t_astret Codegen::visit(const ASTFunc* ast)
  */
 void Codegen::CallExternal(const t_str& funcname)
 {
+	// native vm function: push its id
+	if(const ExtFuncInfo* func = get_vm_ext_func(funcname); func)
+	{
+		PushIntConst(static_cast<t_vm_int>(func->id));
+		m_ostr->put(static_cast<t_vm_byte>(OpCode::EXTCALL));
+		return;
+	}
+
+	// otherwise push the function name
 	// get constant address
 	std::streampos funcname_addr = m_consttab.AddConst(funcname);
 
 	// push constant address
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 
 	std::streampos addr_pos = m_ostr->tellp();
 	funcname_addr -= addr_pos;
-	funcname_addr -= static_cast<std::streampos>(
-		vm_type_size<VMType::ADDR_IP, true>);
+	funcname_addr -= static_cast<std::streampos>(g_vm_addr_skip);
 
 	m_const_addrs.push_back(std::make_tuple(addr_pos, funcname_addr));
 
 	m_ostr->write(reinterpret_cast<const char*>(&funcname_addr),
 		vm_type_size<VMType::ADDR_MEM, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_MEM, false>);
 
 	// dereference function name address
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::RDMEM));
@@ -199,8 +231,12 @@ t_astret Codegen::visit(const ASTCall* ast)
 	if(!func)
 		throw std::runtime_error("ASTCall: Function \"" + (*funcname) + "\" is not in symbol table.");
 
+	// native vm functions can take a variable number of arguments
+	const ExtFuncInfo* extfunc = func->is_external ? get_vm_ext_func(*funcname) : nullptr;
+	bool variadic = extfunc && extfunc->variadic;
+
 	t_vm_int num_args = static_cast<t_vm_int>(func->argty.size());
-	if(static_cast<t_vm_int>(ast->GetArgumentList().size()) != num_args)
+	if(!variadic && static_cast<t_vm_int>(ast->GetArgumentList().size()) != num_args)
 	{
 		std::ostringstream ostr;
 		ostr << "ASTCall: Invalid number of function arguments for \"" << (*funcname)
@@ -215,6 +251,10 @@ t_astret Codegen::visit(const ASTCall* ast)
 	// call external function
 	if(func->is_external)
 	{
+		// push the number of arguments for variadic functions
+		if(variadic)
+			PushIntConst(static_cast<t_vm_int>(ast->GetArgumentList().size()));
+
 		// if the function has an alternate external name assigned, use it
 		//if(func->ext_name)
 		//	funcname = &(*func->ext_name);
@@ -227,18 +267,20 @@ t_astret Codegen::visit(const ASTCall* ast)
 		// push stack frame size
 		t_vm_int framesize = static_cast<t_vm_int>(GetStackFrameSize(func));
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-		m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+		write_vm_descr(*m_ostr, VMType::INT);
 		m_ostr->write(reinterpret_cast<const char*>(&framesize), vm_type_size<VMType::INT, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 
 		// push function address relative to instruction pointer
 		t_vm_addr func_addr = 0;  // to be filled in later
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+		write_vm_descr(*m_ostr, VMType::ADDR_IP);
 		// already skipped over address and jmp instruction
 		std::streampos addr_pos = m_ostr->tellp();
 		t_vm_addr to_skip = static_cast<t_vm_addr>(func_addr - addr_pos);
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip), vm_type_size<VMType::ADDR_IP, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 
 		// call the function
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::CALL));
@@ -274,10 +316,11 @@ t_astret Codegen::visit(const ASTReturn* ast)
 
 		// write jump address to before the end of the function
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH)); // push jump address
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+		write_vm_descr(*m_ostr, VMType::ADDR_IP);
 		m_pushret_comefroms.push_back(m_ostr->tellp());
 		t_vm_addr dummy_addr = 0;
 		m_ostr->write(reinterpret_cast<const char*>(&dummy_addr), vm_type_size<VMType::ADDR_IP, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 
 		// jump before the end of the function
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
@@ -298,10 +341,11 @@ t_astret Codegen::visit(const ASTReturn* ast)
 
 		// write jump address to the end of the function
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH)); // push jump address
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+		write_vm_descr(*m_ostr, VMType::ADDR_IP);
 		m_endfunc_comefroms.push_back(m_ostr->tellp());
 		t_vm_addr dummy_addr = 0;
 		m_ostr->write(reinterpret_cast<const char*>(&dummy_addr), vm_type_size<VMType::ADDR_IP, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 
 		// jump to the end of the function
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
@@ -316,7 +360,10 @@ t_astret Codegen::visit(const ASTReturn* ast)
 t_astret Codegen::visit(const ASTStmts* ast)
 {
 	for(const auto& stmt : ast->GetStatementList())
+	{
+		AddDebugLine(stmt.get());
 		stmt->accept(this);
+	}
 
 	return nullptr;
 }
@@ -11,6 +11,50 @@
 // ----------------------------------------------------------------------------
 // conditionals
 // ----------------------------------------------------------------------------
+/**
+ * emits a conditional jump if the condition on the stack is false,
+ * the jump address is relative to the end of the emitted instructions
+ */
+std::streampos Codegen::JumpIfNot()
+{
+	t_vm_addr dummy_addr = 0;
+	std::streampos addr_pos = 0;
+
+	if(m_optimise)
+	{
+		OpCode op = OpCode::JMPIFNOT;
+
+		// fuse the jump with a directly preceding comparison
+		if(m_last_comp && std::get<0>(*m_last_comp) + std::streamoff(1) == m_ostr->tellp())
+		{
+			m_ostr->seekp(std::get<0>(*m_last_comp));
+			op = get_vm_jump_if_not(std::get<1>(*m_last_comp));
+		}
+		m_last_comp = std::nullopt;
+
+		m_ostr->put(static_cast<t_vm_byte>(op));
+		addr_pos = m_ostr->tellp();
+		m_ostr->write(reinterpret_cast<const char*>(&dummy_addr),
+			vm_type_size<VMType::ADDR_IP, false>);
+
+		return addr_pos;
+	}
+
+	// negate the condition
+	m_ostr->put(static_cast<t_vm_byte>(OpCode::NOT));
+
+	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));  // push jump address
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
+	addr_pos = m_ostr->tellp();
+	m_ostr->write(reinterpret_cast<const char*>(&dummy_addr),
+		vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
+	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMPCND));
+
+	return addr_pos;
+}
+
+
 t_astret Codegen::visit(const ASTCond* ast)
 {
 	// condition
@@ -18,19 +62,10 @@ t_astret Codegen::visit(const ASTCond* ast)
 
 	t_vm_addr skipEndCond = 0;         // how many bytes to skip to jump to end of the if block?
 	t_vm_addr skipEndIf = 0;           // how many bytes to skip to jump to end of the entire if statement?
-	std::streampos skip_addr = 0;      // stream position with the condition jump label
 	std::streampos skip_else_addr = 0; // stream position with the if block jump label
 
-	// if the condition is not fulfilled...
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::NOT));
-
-	// ...skip to the end of the if block
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
-	skip_addr = m_ostr->tellp();
-	m_ostr->write(reinterpret_cast<const char*>(&skipEndCond),
-		vm_type_size<VMType::ADDR_IP, false>);
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMPCND));
+	// if the condition is not fulfilled, skip to the end of the if block
+	std::streampos skip_addr = JumpIfNot();  // stream position with the condition jump label
 
 	// if block
 	std::streampos before_if_block = m_ostr->tellp();
@@ -39,10 +74,11 @@ t_astret Codegen::visit(const ASTCond* ast)
 	{
 		// skip to end of if statement if there's an else block
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));  // push jump address
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+		write_vm_descr(*m_ostr, VMType::ADDR_IP);
 		skip_else_addr = m_ostr->tellp();
 		m_ostr->write(reinterpret_cast<const char*>(&skipEndIf),
 			vm_type_size<VMType::ADDR_IP, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 	}
 
@@ -86,19 +122,12 @@ t_astret Codegen::visit(const ASTCases* ast)
 		// condition for the case: expr == case_cond?
 		ast->GetExpr()->accept(this);
 		cond->accept(this);
+		m_last_comp = std::make_tuple(m_ostr->tellp(), OpCode::EQU);
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::EQU));
 
-		// if the condition is not fulfilled...
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::NOT));
-
-		// ...skip to the end of the case block
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
-		std::streampos skip_case_addr = m_ostr->tellp();        // stream position with the condition jump label
+		// if the condition is not fulfilled, skip to the end of the case block
+		std::streampos skip_case_addr = JumpIfNot();            // stream position with the condition jump label
 		t_vm_addr skipEndCond = 0;                              // how many bytes to skip to jump to end of the case block?
-		m_ostr->write(reinterpret_cast<const char*>(&skipEndCond),
-			vm_type_size<VMType::ADDR_IP, false>);
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::JMPCND));
 
 		// run case statements block
 		std::streampos before_case_block = m_ostr->tellp();
@@ -106,11 +135,12 @@ t_astret Codegen::visit(const ASTCases* ast)
 
 		// skip to the end of all cases
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+		write_vm_descr(*m_ostr, VMType::ADDR_IP);
 		std::streampos skip_after_case_addr = m_ostr->tellp();  // stream position with the condition jump label
 		t_vm_addr skipEndAllDummy = 0;                          // how many bytes to skip to jump to end of all case blocks?
 		m_ostr->write(reinterpret_cast<const char*>(&skipEndAllDummy),
 			vm_type_size<VMType::ADDR_IP, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 		jump_addrs.emplace_back(std::make_pair(skip_after_case_addr, m_ostr->tellp()));
 
@@ -156,17 +186,9 @@ t_astret Codegen::visit(const ASTLoop* ast)
 
 	// how many bytes to skip to jump to end of the block?
 	t_vm_addr skip = 0;
-	std::streampos skip_addr = 0;
-
-	// negate loop condition
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::NOT));
 
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
-	skip_addr = m_ostr->tellp();
-	m_ostr->write(reinterpret_cast<const char*>(&skip),
-		vm_type_size<VMType::ADDR_IP, false>);
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMPCND));
+	// leave the loop if the condition is not fulfilled
+	std::streampos skip_addr = JumpIfNot();
 
 	// loop statement block
 	std::streampos before_block = m_ostr->tellp();
@@ -175,13 +197,14 @@ t_astret Codegen::visit(const ASTLoop* ast)
 
 	// loop back
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	std::streampos after_block = m_ostr->tellp();
 	skip = after_block - before_block;
 	t_vm_addr skip_back = loop_begin - after_block;
-	skip_back -= vm_type_size<VMType::ADDR_IP, true>;
+	skip_back -= g_vm_addr_skip;
 	m_ostr->write(reinterpret_cast<const char*>(&skip_back),
 		vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 
 	// go back and fill in missing number of bytes to skip
@@ -203,7 +226,7 @@ t_astret Codegen::visit(const ASTLoop* ast)
 
 		t_vm_addr to_skip = loop_begin - pos;
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip),
 			vm_type_size<VMType::ADDR_IP, false>);
@@ -221,7 +244,7 @@ t_astret Codegen::visit(const ASTLoop* ast)
 
 		t_vm_addr to_skip = after_block - pos;
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip),
 			vm_type_size<VMType::ADDR_IP, false>);
@@ -264,38 +287,41 @@ t_astret Codegen::visit(const ASTRangedLoop* ast)
 
 	std::streampos loop_begin = m_ostr->tellp();
 
+	// can the counter be handled without type descriptors?
+	const bool untagged_ctr = m_untagged &&
+		(ctr_sym->ty == SymbolType::INT || ctr_sym->ty == SymbolType::REAL);
+	const VMType ctr_ty = (ctr_sym->ty == SymbolType::INT ? VMType::INT : VMType::REAL);
+
 	// --------------------------------------------------------------------
 	// loop condition: check if the counter is smaller than the end value
-	// push counter variable address
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(
-		ctr_sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP));
-	t_vm_addr addr = static_cast<t_vm_addr>(*ctr_sym->addr);
-	m_ostr->write(reinterpret_cast<const char*>(&addr),
-		vm_type_size<VMType::ADDR_BP, false>);
-	// dereference counter variable
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::RDMEM));
-
-	// end value
-	ast->GetRange()->GetEnd()->accept(this);
+	OpCode comp_op = OpCode::INVALID;
+	if(untagged_ctr && GetUntaggedType(ast->GetRange()->GetEnd()) == ctr_sym->ty)
+	{
+		ReadVarUntagged(ctr_sym);
+		EmitUntagged(ast->GetRange()->GetEnd());
+		comp_op = get_vm_untagged_opcode(OpCode::LEQU, ctr_ty);
+	}
+	else
+	{
+		// push counter variable
+		ReadVar(ctr_sym);
+
+		// end value
+		ast->GetRange()->GetEnd()->accept(this);
+
+		comp_op = GetTypedOpCode(OpCode::LEQU, ctr_sym);
+	}
 
 	// ctr <= end ?
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::LEQU));
+	m_last_comp = std::make_tuple(m_ostr->tellp(), comp_op);
+	m_ostr->put(static_cast<t_vm_byte>(comp_op));
 	// --------------------------------------------------------------------
 
 	// how many bytes to skip to jump to end of the block?
 	t_vm_addr skip = 0;
-	std::streampos skip_addr = 0;
-
-	// negate loop condition
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::NOT));
 
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
-	skip_addr = m_ostr->tellp();
-	m_ostr->write(reinterpret_cast<const char*>(&skip),
-		vm_type_size<VMType::ADDR_IP, false>);
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMPCND));
+	// leave the loop if the condition is not fulfilled
+	std::streampos skip_addr = JumpIfNot();
 
 	// --------------------------------------------------------------------
 	// loop statement block
@@ -306,36 +332,53 @@ t_astret Codegen::visit(const ASTRangedLoop* ast)
 
 	// --------------------------------------------------------------------
 	// increment counter
+	std::optional<SymbolType> inc_ty = SymbolType::INT;
 	if(ast->GetRange()->GetInc())
-		ast->GetRange()->GetInc()->accept(this);
-	// increment by 1 if nothing is given
+		inc_ty = GetUntaggedType(ast->GetRange()->GetInc());
+
+	if(untagged_ctr && inc_ty == ctr_sym->ty)
+	{
+		if(ast->GetRange()->GetInc())
+			EmitUntagged(ast->GetRange()->GetInc());
+		// increment by 1 if nothing is given
+		else
+		{
+			PushIntConst(1);
+			m_ostr->put(static_cast<t_vm_byte>(OpCode::UNTAG_I));
+		}
+
+		ReadVarUntagged(ctr_sym);
+		m_ostr->put(static_cast<t_vm_byte>(get_vm_untagged_opcode(OpCode::ADD, ctr_ty)));
+		AssignVarUntagged(ctr_sym);
+	}
 	else
-		PushIntConst(1);
-
-	// push counter variable address
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(
-		ctr_sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP));
-	m_ostr->write(reinterpret_cast<const char*>(&addr),
-		vm_type_size<VMType::ADDR_BP, false>);
-	// dereference counter variable
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::RDMEM));
-
-	// add counter and increment and re-assign to counter
-	// TODO: casts
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::ADD));
-	AssignVar(ctr_sym);
+	{
+		if(ast->GetRange()->GetInc())
+			ast->GetRange()->GetInc()->accept(this);
+		// increment by 1 if nothing is given
+		else
+			PushIntConst(1);
+
+		// push counter variable
+		ReadVar(ctr_sym);
+
+		// add counter and increment and re-assign to counter
+		// TODO: casts
+		m_ostr->put(static_cast<t_vm_byte>(GetTypedOpCode(OpCode::ADD, ctr_sym)));
+		AssignVar(ctr_sym);
+	}
 	// --------------------------------------------------------------------
 
 	// loop back
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));      // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	std::streampos after_block = m_ostr->tellp();
 	skip = after_block - before_block;
 	t_vm_addr skip_back = loop_begin - after_block;
-	skip_back -= vm_type_size<VMType::ADDR_IP, true>;
+	skip_back -= g_vm_addr_skip;
 	m_ostr->write(reinterpret_cast<const char*>(&skip_back),
 		vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 
 	// go back and fill in missing number of bytes to skip
@@ -357,7 +400,7 @@ t_astret Codegen::visit(const ASTRangedLoop* ast)
 
 		t_vm_addr to_skip = loop_begin - pos;
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip),
 			vm_type_size<VMType::ADDR_IP, false>);
@@ -375,7 +418,7 @@ t_astret Codegen::visit(const ASTRangedLoop* ast)
 
 		t_vm_addr to_skip = after_block - pos;
 		// already skipped over address and jmp instruction
-		to_skip -= vm_type_size<VMType::ADDR_IP, true>;
+		to_skip -= g_vm_addr_skip;
 		m_ostr->seekp(pos);
 		m_ostr->write(reinterpret_cast<const char*>(&to_skip),
 			vm_type_size<VMType::ADDR_IP, false>);
@@ -404,12 +447,13 @@ t_astret Codegen::visit(const ASTLoopBreak* ast)
 
 	// jump to the end of the loop
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));  // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	m_loop_end_comefroms.insert(std::make_pair(
 		m_cur_loop[m_cur_loop.size()-loop_depth-1], m_ostr->tellp()));
 	t_vm_addr dummy_addr = 0;
 	m_ostr->write(reinterpret_cast<const char*>(&dummy_addr),
 		vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 
 	return nullptr;
@@ -431,12 +475,13 @@ t_astret Codegen::visit(const ASTLoopNext* ast)
 
 	// jump to the beginning of the loop
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));  // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	m_loop_begin_comefroms.insert(std::make_pair(
 		m_cur_loop[m_cur_loop.size()-loop_depth-1], m_ostr->tellp()));
 	t_vm_addr dummy_addr = 0;
 	m_ostr->write(reinterpret_cast<const char*>(&dummy_addr),
 		vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 
 	return nullptr;
@@ -460,11 +505,12 @@ t_astret Codegen::visit(const ASTJump* ast)
 
 	// jump to the label
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));  // push jump address
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 	m_goto_comefroms.emplace_back(std::make_pair(ast->GetLabel(), m_ostr->tellp()));
 	t_vm_addr dummy_addr = 0;
 	m_ostr->write(reinterpret_cast<const char*>(&dummy_addr),
 		vm_type_size<VMType::ADDR_IP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_IP, false>);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::JMP));
 
 	return nullptr;
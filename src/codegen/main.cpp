@@ -14,6 +14,7 @@
 #include "parser/lexer.h"
 #include "parser/grammar.h"
 #include "codegen.h"
+#include "cppgen.h"
 
 #if USE_RECASC != 0
 	#include "parser.h"
@@ -66,18 +67,24 @@ int main(int argc, char** argv)
 		// --------------------------------------------------------------------
 		std::vector<std::string> progs;
 		bool opt = false;
+		bool untagged = false;
 		bool show_symbols = false;
 		bool show_ast = false;
 		bool debug = false;
+		bool emit_cpp = false;
+		bool emit_debuginfo = false;
 		std::string outprog;
 
 		args::options_description arg_descr("Compiler arguments");
 		arg_descr.add_options()
 			("out,o", args::value(&outprog), "compiled program output")
 			("opt,O", args::bool_switch(&opt), "optimise code")
+			("untagged,u", args::bool_switch(&untagged), "evaluate statically typed integer and real expressions without type descriptors (implies -O)")
 			("symbols,s", args::bool_switch(&show_symbols), "output symbol table")
 			("ast,a", args::bool_switch(&show_ast), "output syntax tree")
 			("debug,d", args::bool_switch(&debug), "output debug infos")
+			("emit-cpp,c", args::bool_switch(&emit_cpp), "also emit the program as c++ source code")
+			("debuginfo,g", args::bool_switch(&emit_debuginfo), "emit a section with source line and function tables")
 			("program", args::value<decltype(progs)>(&progs), "input program to compile");
 
 		args::positional_options_description posarg_descr;
@@ -93,6 +100,9 @@ int main(int argc, char** argv)
 		args::store(parsedArgs, mapArgs);
 		args::notify(mapArgs);
 
+		if(untagged)
+			opt = true;
+
 		if(progs.size() == 0)
 		{
 			std::cerr << "Please specify an input program.\n" << std::endl;
@@ -115,6 +125,7 @@ int main(int argc, char** argv)
 		std::string outprog_ast = outprog + "_ast.xml";
 		std::string outprog_syms = outprog + "_syms.txt";
 		std::string outprog_0ac = outprog + ".bin";
+		std::string outprog_cpp = outprog + ".cpp";
 		// --------------------------------------------------------------------
 
 
@@ -138,7 +149,7 @@ int main(int argc, char** argv)
 		const auto& rules = grammar.GetSemanticRules();
 
 		// register external runtime functions which should be available to the compiler
-		add_ext_funcs<t_real, t_int>(ctx);
+		add_ext_funcs(ctx);
 
 		t_timepoint lex_start_time  = t_clock::now();
 		Lexer lexer(&ifstr);
@@ -251,6 +262,9 @@ int main(int argc, char** argv)
 
 		Codegen codegen{&ctx.GetSymbols(), ostr};
 		codegen.SetDebug(debug);
+		codegen.SetOptimise(opt);
+		codegen.SetUntagged(untagged);
+		codegen.SetDebugInfo(emit_debuginfo, fs::path(inprog).filename().string());
 		codegen.Start();
 		auto stmts = ctx.GetStatements()->GetStatementList();
 		for(auto iter = stmts.begin(); iter != stmts.end(); ++iter)
@@ -262,6 +276,25 @@ int main(int argc, char** argv)
 		// --------------------------------------------------------------------
 
 
+		// --------------------------------------------------------------------
+		// c++ generation
+		// --------------------------------------------------------------------
+		if(emit_cpp)
+		{
+			std::cout << "Generating c++ code: \""
+				<< inprog << "\" -> \"" << outprog_cpp << "\"..." << std::endl;
+
+			std::ofstream ofstrCpp{outprog_cpp};
+			CppCodegen cppgen{&ctx.GetSymbols(), &ofstrCpp};
+			cppgen.Start(fs::path(inprog).filename().string());
+			for(auto iter = stmts.begin(); iter != stmts.end(); ++iter)
+				(*iter)->accept(&cppgen);
+			std::streampos cpp_streampos = cppgen.Finish();
+			std::cout << "Generated " << cpp_streampos << " bytes of c++ code." << std::endl;
+		}
+		// --------------------------------------------------------------------
+
+
 		if(show_symbols)
 		{
 			std::cout << "Writing symbol table to \"" << outprog_syms
@@ -154,9 +154,10 @@ void Codegen::CastTo(t_astret ty_to,
 		t_vm_addr cols = static_cast<t_vm_addr>(ty_to->get_total_size());
 
 		m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-		m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_MEM));
+		write_vm_descr(*m_ostr, VMType::ADDR_MEM);
 		m_ostr->write(reinterpret_cast<const char*>(&cols),
 			vm_type_size<VMType::ADDR_MEM, false>);
+		write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_MEM, false>);
 	}
 
 	if(pos)
@@ -167,6 +168,183 @@ void Codegen::CastTo(t_astret ty_to,
 }
 
 
+/**
+ * returns the statically typed variant of an operation
+ * if the (already cast) operands are integer or real scalars
+ */
+OpCode Codegen::GetTypedOpCode(OpCode op, t_astret res_ty) const
+{
+	if(!m_optimise || !res_ty)
+		return op;
+
+	if(res_ty->ty == SymbolType::INT)
+		return get_vm_typed_opcode(op, VMType::INT);
+	else if(res_ty->ty == SymbolType::REAL)
+		return get_vm_typed_opcode(op, VMType::REAL);
+
+	return op;
+}
+
+
+/**
+ * returns the type of an integer or real expression that can be evaluated
+ * without type descriptors, i.e. an expression of declared scalar variables,
+ * constants, and the basic arithmetic operations
+ * @param num_ops optionally counts the arithmetic operations
+ */
+std::optional<SymbolType> Codegen::GetUntaggedType(const ASTPtr& ast,
+	std::size_t* num_ops) const
+{
+	if(!m_untagged || !ast)
+		return std::nullopt;
+
+	ASTPtr term1, term2;
+	switch(ast->type())
+	{
+		case ASTType::Var:
+		{
+			t_astret sym = GetSym(std::static_pointer_cast<ASTVar>(ast)->GetIdent());
+			if(!sym || !sym->addr ||
+				(sym->ty != SymbolType::INT && sym->ty != SymbolType::REAL))
+				return std::nullopt;
+			return sym->ty;
+		}
+
+		case ASTType::NumConst:
+		{
+			if(std::dynamic_pointer_cast<ASTNumConst<t_int>>(ast))
+				return SymbolType::INT;
+			else if(std::dynamic_pointer_cast<ASTNumConst<t_real>>(ast))
+				return SymbolType::REAL;
+			return std::nullopt;
+		}
+
+		case ASTType::Plus:
+		{
+			auto plus = std::static_pointer_cast<ASTPlus>(ast);
+			term1 = plus->GetTerm1();
+			term2 = plus->GetTerm2();
+			break;
+		}
+
+		case ASTType::Mult:
+		{
+			auto mult = std::static_pointer_cast<ASTMult>(ast);
+			term1 = mult->GetTerm1();
+			term2 = mult->GetTerm2();
+			break;
+		}
+
+		default:
+			return std::nullopt;
+	}
+
+	std::optional<SymbolType> ty1 = GetUntaggedType(term1, num_ops);
+	if(!ty1)
+		return std::nullopt;
+	std::optional<SymbolType> ty2 = GetUntaggedType(term2, num_ops);
+	if(!ty2)
+		return std::nullopt;
+
+	if(num_ops)
+		++*num_ops;
+
+	// mixed operations are performed on reals
+	return *ty1 == *ty2 ? *ty1 : SymbolType::REAL;
+}
+
+
+/**
+ * emit code to evaluate an expression without type descriptors,
+ * GetUntaggedType() has to be checked first
+ * @returns the type of the untagged result
+ */
+SymbolType Codegen::EmitUntagged(const ASTPtr& ast)
+{
+	switch(ast->type())
+	{
+		case ASTType::Var:
+		{
+			t_astret sym = GetSym(std::static_pointer_cast<ASTVar>(ast)->GetIdent());
+			ReadVarUntagged(sym);
+			return sym->ty;
+		}
+
+		case ASTType::NumConst:
+		{
+			if(auto intconst = std::dynamic_pointer_cast<ASTNumConst<t_int>>(ast))
+			{
+				PushIntConst(static_cast<t_vm_int>(intconst->GetVal()));
+				m_ostr->put(static_cast<t_vm_byte>(OpCode::UNTAG_I));
+				return SymbolType::INT;
+			}
+			else if(auto realconst = std::dynamic_pointer_cast<ASTNumConst<t_real>>(ast))
+			{
+				PushRealConst(static_cast<t_vm_real>(realconst->GetVal()));
+				m_ostr->put(static_cast<t_vm_byte>(OpCode::UNTAG_R));
+				return SymbolType::REAL;
+			}
+			break;
+		}
+
+		case ASTType::Plus:
+		{
+			auto plus = std::static_pointer_cast<ASTPlus>(ast);
+			return EmitUntaggedOp(plus->IsInverted() ? OpCode::SUB : OpCode::ADD,
+				plus->GetTerm1(), plus->GetTerm2());
+		}
+
+		case ASTType::Mult:
+		{
+			auto mult = std::static_pointer_cast<ASTMult>(ast);
+			return EmitUntaggedOp(mult->IsInverted() ? OpCode::DIV : OpCode::MUL,
+				mult->GetTerm1(), mult->GetTerm2());
+		}
+
+		default:
+			break;
+	}
+
+	throw std::runtime_error("EmitUntagged: Expression cannot be evaluated without type descriptors.");
+}
+
+
+/**
+ * emit code for an arithmetic operation or comparison of two untagged terms
+ * @returns the common type of the terms
+ */
+SymbolType Codegen::EmitUntaggedOp(OpCode op, const ASTPtr& term1, const ASTPtr& term2)
+{
+	// find the common type first to avoid cast placeholders
+	std::optional<SymbolType> ty2 = GetUntaggedType(term2);
+	if(!ty2)
+		throw std::runtime_error("EmitUntaggedOp: Operand cannot be evaluated without type descriptors.");
+
+	SymbolType ty1 = EmitUntagged(term1);
+	SymbolType ty = (ty1 == *ty2 ? ty1 : SymbolType::REAL);
+	CastUntagged(ty1, ty);
+
+	EmitUntagged(term2);
+	CastUntagged(*ty2, ty);
+
+	m_ostr->put(static_cast<t_vm_byte>(get_vm_untagged_opcode(op,
+		ty == SymbolType::INT ? VMType::INT : VMType::REAL)));
+	return ty;
+}
+
+
+/**
+ * emit code to cast between untagged integers and reals
+ */
+void Codegen::CastUntagged(SymbolType ty_from, SymbolType ty_to)
+{
+	if(ty_from == SymbolType::INT && ty_to == SymbolType::REAL)
+		m_ostr->put(static_cast<t_vm_byte>(OpCode::TOR_IU));
+	else if(ty_from == SymbolType::REAL && ty_to == SymbolType::INT)
+		m_ostr->put(static_cast<t_vm_byte>(OpCode::TOI_RU));
+}
+
+
 t_astret Codegen::visit(const ASTUMinus* ast)
 {
 	t_astret term = ast->GetTerm()->accept(this);
@@ -178,6 +356,17 @@ t_astret Codegen::visit(const ASTUMinus* ast)
 
 t_astret Codegen::visit(const ASTPlus* ast)
 {
+	// evaluate longer integer and real expressions without type descriptors
+	if(std::size_t num_ops = 1; GetUntaggedType(ast->GetTerm1(), &num_ops)
+		&& GetUntaggedType(ast->GetTerm2(), &num_ops) && num_ops >= 2)
+	{
+		SymbolType ty = EmitUntaggedOp(ast->IsInverted() ? OpCode::SUB : OpCode::ADD,
+			ast->GetTerm1(), ast->GetTerm2());
+		m_ostr->put(static_cast<t_vm_byte>(
+			ty == SymbolType::INT ? OpCode::TAG_I : OpCode::TAG_R));
+		return GetTypeConst(ty);
+	}
+
 	t_astret term1 = ast->GetTerm1()->accept(this);
 	std::streampos term1_pos = m_ostr->tellp();
 	// placeholder for potential cast
@@ -197,9 +386,9 @@ t_astret Codegen::visit(const ASTPlus* ast)
 	common_type = res_ty;
 
 	if(ast->IsInverted())  // subtraction
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::SUB));
+		m_ostr->put(static_cast<t_vm_byte>(GetTypedOpCode(OpCode::SUB, common_type)));
 	else                   // addition
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::ADD));
+		m_ostr->put(static_cast<t_vm_byte>(GetTypedOpCode(OpCode::ADD, common_type)));
 
 	return common_type;
 }
@@ -207,6 +396,17 @@ t_astret Codegen::visit(const ASTPlus* ast)
 
 t_astret Codegen::visit(const ASTMult* ast)
 {
+	// evaluate longer integer and real expressions without type descriptors
+	if(std::size_t num_ops = 1; GetUntaggedType(ast->GetTerm1(), &num_ops)
+		&& GetUntaggedType(ast->GetTerm2(), &num_ops) && num_ops >= 2)
+	{
+		SymbolType ty = EmitUntaggedOp(ast->IsInverted() ? OpCode::DIV : OpCode::MUL,
+			ast->GetTerm1(), ast->GetTerm2());
+		m_ostr->put(static_cast<t_vm_byte>(
+			ty == SymbolType::INT ? OpCode::TAG_I : OpCode::TAG_R));
+		return GetTypeConst(ty);
+	}
+
 	t_astret term1 = ast->GetTerm1()->accept(this);
 	std::streampos term1_pos = m_ostr->tellp();
 	// placeholder for potential cast
@@ -231,7 +431,7 @@ t_astret Codegen::visit(const ASTMult* ast)
 		if(term2 && IsArray(term2->ty))
 			throw std::runtime_error("ASTMult: Cannot divide by array.");
 
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::DIV));
+		m_ostr->put(static_cast<t_vm_byte>(GetTypedOpCode(OpCode::DIV, common_type)));
 	}
 	// multiplication
 	else
@@ -276,30 +476,34 @@ t_astret Codegen::visit(const ASTMult* ast)
 		{
 			// push first matrix sizes
 			m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-			m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+			write_vm_descr(*m_ostr, VMType::INT);
 			m_ostr->write(reinterpret_cast<const char*>(&M1_rows),
 				vm_type_size<VMType::INT, false>);
+			write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 			m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-			m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+			write_vm_descr(*m_ostr, VMType::INT);
 			m_ostr->write(reinterpret_cast<const char*>(&M1_cols),
 				vm_type_size<VMType::INT, false>);
+			write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 
 			// push second matrix sizes
 			m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-			m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+			write_vm_descr(*m_ostr, VMType::INT);
 			m_ostr->write(reinterpret_cast<const char*>(&M2_rows),
 				vm_type_size<VMType::INT, false>);
+			write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 			m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-			m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+			write_vm_descr(*m_ostr, VMType::INT);
 			m_ostr->write(reinterpret_cast<const char*>(&M2_cols),
 				vm_type_size<VMType::INT, false>);
+			write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 
 			m_ostr->put(static_cast<t_vm_byte>(OpCode::MATMUL));
 		}
 		// scalar multiplication
 		else
 		{
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::MUL));
+			m_ostr->put(static_cast<t_vm_byte>(GetTypedOpCode(OpCode::MUL, common_type)));
 		}
 	}
 
@@ -369,49 +573,67 @@ t_astret Codegen::visit(const ASTNorm* ast)
 
 t_astret Codegen::visit(const ASTComp* ast)
 {
-	t_astret term1 = ast->GetTerm1()->accept(this);
-	std::streampos term1_pos = m_ostr->tellp();
-	// placeholder for potential cast
-	m_ostr->put(static_cast<t_vm_byte>(OpCode::NOP));
-
-	t_astret term2 = ast->GetTerm2()->accept(this);
-	std::streampos term2_pos = m_ostr->tellp();
-
-	t_astret common_type = term1;
-
-	// cast if needed
-	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
-	if(first_ty)
-		CastTo(first_ty, term1_pos);
-	if(second_ty)
-		CastTo(second_ty, term2_pos);
-	common_type = res_ty;
-
+	OpCode op = OpCode::INVALID;
 	switch(ast->GetOp())
 	{
 		case ASTComp::EQU:
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::EQU));
+			op = OpCode::EQU;
 			break;
 		case ASTComp::NEQ:
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::NEQU));
+			op = OpCode::NEQU;
 			break;
 		case ASTComp::GT:
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::GT));
+			op = OpCode::GT;
 			break;
 		case ASTComp::LT:
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::LT));
+			op = OpCode::LT;
 			break;
 		case ASTComp::GEQ:
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::GEQU));
+			op = OpCode::GEQU;
 			break;
 		case ASTComp::LEQ:
-			m_ostr->put(static_cast<t_vm_byte>(OpCode::LEQU));
+			op = OpCode::LEQU;
 			break;
 		default:
 			throw std::runtime_error("ASTComp: Invalid operation.");
 			break;
 	}
 
+	// compare integer and real expressions without type descriptors
+	if(GetUntaggedType(ast->GetTerm1()) && GetUntaggedType(ast->GetTerm2()))
+	{
+		SymbolType ty = EmitUntaggedOp(op, ast->GetTerm1(), ast->GetTerm2());
+
+		// remember the comparison for a potential fusion with a following jump
+		m_last_comp = std::make_tuple(m_ostr->tellp() - std::streamoff(1),
+			get_vm_untagged_opcode(op, ty == SymbolType::INT ? VMType::INT : VMType::REAL));
+		return GetTypeConst(ty);
+	}
+
+	t_astret term1 = ast->GetTerm1()->accept(this);
+	std::streampos term1_pos = m_ostr->tellp();
+	// placeholder for potential cast
+	m_ostr->put(static_cast<t_vm_byte>(OpCode::NOP));
+
+	t_astret term2 = ast->GetTerm2()->accept(this);
+	std::streampos term2_pos = m_ostr->tellp();
+
+	t_astret common_type = term1;
+
+	// cast if needed
+	auto [first_ty, second_ty, res_ty] = GetCastSymType(term1, term2);
+	if(first_ty)
+		CastTo(first_ty, term1_pos);
+	if(second_ty)
+		CastTo(second_ty, term2_pos);
+	common_type = res_ty;
+
+	op = GetTypedOpCode(op, common_type);
+
+	// remember the comparison for a potential fusion with a following jump
+	m_last_comp = std::make_tuple(m_ostr->tellp(), op);
+	m_ostr->put(static_cast<t_vm_byte>(op));
+
 	return common_type;
 }
 
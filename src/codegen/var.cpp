@@ -268,19 +268,64 @@ t_astret Codegen::PushVar(const t_str& varname)
 	if(!sym->addr)
 		throw std::runtime_error("ASTVar: Variable \"" + varname + "\" has not been declared.");
 
-	// push variable address
+	// dereference the variable
+	if(sym->ty != SymbolType::FUNC)
+	{
+		ReadVar(sym);
+		return sym;
+	}
+
+	// push function address
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(
-		sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP));
+	write_vm_descr(*m_ostr,
+		sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP);
 	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
 	m_ostr->write(reinterpret_cast<const char*>(&addr),
 		vm_type_size<VMType::ADDR_BP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_BP, false>);
+
+	return sym;
+}
+
+
+/**
+ * push the value of a symbol variable onto the stack
+ */
+void Codegen::ReadVar(t_astret sym)
+{
+	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
+
+	if(m_optimise)
+	{
+		// read variable using a single instruction
+		m_ostr->put(static_cast<t_vm_byte>(
+			sym->is_global ? OpCode::LOADGLOBAL : OpCode::LOADLOCAL));
+		m_ostr->write(reinterpret_cast<const char*>(&addr),
+			vm_type_size<VMType::ADDR_BP, false>);
+		return;
+	}
+
+	// push variable address
+	PushVarAddr(sym);
 
 	// dereference the variable
-	if(sym->ty != SymbolType::FUNC)
-		m_ostr->put(static_cast<t_vm_byte>(OpCode::RDMEM));
+	m_ostr->put(static_cast<t_vm_byte>(OpCode::RDMEM));
+}
 
-	return sym;
+
+/**
+ * push the address of a symbol variable onto the stack
+ */
+void Codegen::PushVarAddr(t_astret sym)
+{
+	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
+
+	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
+	write_vm_descr(*m_ostr,
+		sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP);
+	m_ostr->write(reinterpret_cast<const char*>(&addr),
+		vm_type_size<VMType::ADDR_BP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_BP, false>);
 }
 
 
@@ -295,21 +340,89 @@ t_astret Codegen::visit(const ASTVar* ast)
  */
 void Codegen::AssignVar(t_astret sym)
 {
+	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
+
+	if(m_optimise)
+	{
+		// assign variable using a single instruction
+		m_ostr->put(static_cast<t_vm_byte>(
+			sym->is_global ? OpCode::STOREGLOBAL : OpCode::STORELOCAL));
+		m_ostr->write(reinterpret_cast<const char*>(&addr),
+			vm_type_size<VMType::ADDR_BP, false>);
+		return;
+	}
+
 	// push variable address
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(
-		sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP));
-	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
+	write_vm_descr(*m_ostr,
+		sym->is_global ? VMType::ADDR_GBP : VMType::ADDR_BP);
 	m_ostr->write(reinterpret_cast<const char*>(&addr),
 		vm_type_size<VMType::ADDR_BP, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_BP, false>);
 
 	// assign variable
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::WRMEM));
 }
 
 
+/**
+ * push the value of an integer or real variable onto the stack without its type descriptor
+ */
+void Codegen::ReadVarUntagged(t_astret sym)
+{
+	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
+
+	OpCode op = OpCode::INVALID;
+	if(sym->ty == SymbolType::INT)
+		op = sym->is_global ? OpCode::LOADGLOBAL_IU : OpCode::LOADLOCAL_IU;
+	else if(sym->ty == SymbolType::REAL)
+		op = sym->is_global ? OpCode::LOADGLOBAL_RU : OpCode::LOADLOCAL_RU;
+	else
+		throw std::runtime_error("ReadVarUntagged: Variable \"" + sym->name + "\" is not an integer or real.");
+
+	m_ostr->put(static_cast<t_vm_byte>(op));
+	m_ostr->write(reinterpret_cast<const char*>(&addr),
+		vm_type_size<VMType::ADDR_BP, false>);
+}
+
+
+/**
+ * assign an integer or real variable to the current untagged value on the stack
+ */
+void Codegen::AssignVarUntagged(t_astret sym)
+{
+	t_vm_addr addr = static_cast<t_vm_addr>(*sym->addr);
+
+	OpCode op = OpCode::INVALID;
+	if(sym->ty == SymbolType::INT)
+		op = sym->is_global ? OpCode::STOREGLOBAL_IU : OpCode::STORELOCAL_IU;
+	else if(sym->ty == SymbolType::REAL)
+		op = sym->is_global ? OpCode::STOREGLOBAL_RU : OpCode::STORELOCAL_RU;
+	else
+		throw std::runtime_error("AssignVarUntagged: Variable \"" + sym->name + "\" is not an integer or real.");
+
+	m_ostr->put(static_cast<t_vm_byte>(op));
+	m_ostr->write(reinterpret_cast<const char*>(&addr),
+		vm_type_size<VMType::ADDR_BP, false>);
+}
+
+
 t_astret Codegen::visit(const ASTAssign* ast)
 {
+	// assign a statically typed integer or real expression without type descriptors
+	if(m_untagged && !ast->IsMultiAssign() && !ast->IsNullAssign()
+		&& GetUntaggedType(ast->GetExpr()))
+	{
+		t_astret sym = GetSym(ast->GetIdent());
+		if(sym && sym->addr && (sym->ty == SymbolType::INT || sym->ty == SymbolType::REAL))
+		{
+			SymbolType ty = EmitUntagged(ast->GetExpr());
+			CastUntagged(ty, sym->ty);
+			AssignVarUntagged(sym);
+			return sym;
+		}
+	}
+
 	if(ast->GetExpr())
 		ast->GetExpr()->accept(this);
 	t_astret sym_ret = nullptr;
@@ -350,10 +463,11 @@ void Codegen::PushRealConst(t_vm_real val)
 {
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
 	// write type descriptor byte
-	m_ostr->put(static_cast<t_vm_byte>(VMType::REAL));
+	write_vm_descr(*m_ostr, VMType::REAL);
 	// write value
 	m_ostr->write(reinterpret_cast<const char*>(&val),
 		vm_type_size<VMType::REAL, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::REAL, false>);
 }
 
 
@@ -361,10 +475,11 @@ void Codegen::PushIntConst(t_vm_int val)
 {
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
 	// write type descriptor byte
-	m_ostr->put(static_cast<t_vm_byte>(VMType::INT));
+	write_vm_descr(*m_ostr, VMType::INT);
 	// write data
 	m_ostr->write(reinterpret_cast<const char*>(&val),
 		vm_type_size<VMType::INT, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::INT, false>);
 }
 
 
@@ -375,13 +490,14 @@ void Codegen::PushCplxConst(const t_vm_cplx& val)
 
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
 	// write type descriptor byte
-	m_ostr->put(static_cast<t_vm_byte>(VMType::CPLX));
+	write_vm_descr(*m_ostr, VMType::CPLX);
 
 	// write value components
 	m_ostr->write(reinterpret_cast<const char*>(&real),
 		vm_type_size<VMType::REAL, false>);
 	m_ostr->write(reinterpret_cast<const char*>(&imag),
 		vm_type_size<VMType::REAL, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::CPLX, false>);
 }
 
 
@@ -394,7 +510,7 @@ void Codegen::PushQuatConst(const t_vm_quat& val)
 
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
 	// write type descriptor byte
-	m_ostr->put(static_cast<t_vm_byte>(VMType::QUAT));
+	write_vm_descr(*m_ostr, VMType::QUAT);
 
 	// write value components
 	m_ostr->write(reinterpret_cast<const char*>(&real),
@@ -405,6 +521,7 @@ void Codegen::PushQuatConst(const t_vm_quat& val)
 		vm_type_size<VMType::REAL, false>);
 	m_ostr->write(reinterpret_cast<const char*>(&imag3),
 		vm_type_size<VMType::REAL, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::QUAT, false>);
 }
 
 
@@ -412,10 +529,11 @@ void Codegen::PushBoolConst(t_vm_bool val)
 {
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
 	// write type descriptor byte
-	m_ostr->put(static_cast<t_vm_byte>(VMType::BOOL));
+	write_vm_descr(*m_ostr, VMType::BOOL);
 	// write data
 	m_ostr->write(reinterpret_cast<const char*>(&val),
 		vm_type_size<VMType::BOOL, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::BOOL, false>);
 }
 
 
@@ -426,17 +544,17 @@ void Codegen::PushStrConst(const t_vm_str& val)
 
 	// push string constant address
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_IP));
+	write_vm_descr(*m_ostr, VMType::ADDR_IP);
 
 	std::streampos addr_pos = m_ostr->tellp();
 	str_addr -= addr_pos;
-	str_addr -= static_cast<std::streampos>(
-		vm_type_size<VMType::ADDR_IP, true>);
+	str_addr -= static_cast<std::streampos>(g_vm_addr_skip);
 
 	m_const_addrs.push_back(std::make_tuple(addr_pos, str_addr));
 
 	m_ostr->write(reinterpret_cast<const char*>(&str_addr),
 		vm_type_size<VMType::ADDR_MEM, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_MEM, false>);
 
 	// dereference string constant address
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::RDMEM));
@@ -450,9 +568,10 @@ void Codegen::PushVecSize(std::size_t size)
 {
 	t_vm_addr num_elems = static_cast<t_vm_addr>(size);
 	m_ostr->put(static_cast<t_vm_byte>(OpCode::PUSH));
-	m_ostr->put(static_cast<t_vm_byte>(VMType::ADDR_MEM));
+	write_vm_descr(*m_ostr, VMType::ADDR_MEM);
 	m_ostr->write(reinterpret_cast<const char*>(&num_elems),
 		vm_type_size<VMType::ADDR_MEM, false>);
+	write_vm_padding(*m_ostr, vm_type_size<VMType::ADDR_MEM, false>);
 }
 
 
@@ -10,101 +10,56 @@
 
 
 #include "context.h"
-#include <cstdint>
+#include "vm/extfuncs.h"
+
+#include <vector>
 
 
 /**
- * registers external runtime functions which should be available to the compiler
+ * get the symbol type corresponding to a vm type
  */
-template<class t_real, class t_int>
-void add_ext_funcs(ParserContext& ctx, bool skip_some = false)
+static inline SymbolType get_ext_func_symtype(VMType ty)
 {
-	// real functions
-	if constexpr(std::is_same_v<std::decay_t<t_real>, float>)
-	{
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "pow", "powf",
-			SymbolType::REAL, {SymbolType::REAL, SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "exp", "expf",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sin", "sinf",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "cos", "cosf",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sqrt", "sqrtf",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "fabs", "fabsf",
-			SymbolType::REAL, {SymbolType::REAL});
-	}
-	else if constexpr(std::is_same_v<std::decay_t<t_real>, double>)
-	{
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "pow", "pow",
-			SymbolType::REAL, {SymbolType::REAL, SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "exp", "exp",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sin", "sin",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "cos", "cos",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sqrt", "sqrt",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "fabs", "fabs",
-			SymbolType::REAL, {SymbolType::REAL});
-	}
-	else if constexpr(std::is_same_v<std::decay_t<t_real>, long double>)
+	switch(ty)
 	{
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "pow", "powl",
-			SymbolType::REAL, {SymbolType::REAL, SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "exp", "expl",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sin", "sinl",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "cos", "cosl",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sqrt", "sqrtl",
-			SymbolType::REAL, {SymbolType::REAL});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "fabs", "fabsl",
-			SymbolType::REAL, {SymbolType::REAL});
-	}
-
-	// int functions
-	if constexpr(std::is_same_v<std::decay_t<t_real>, std::int32_t>)
-	{
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "abs", "abs",
-			SymbolType::INT, {SymbolType::INT});
-	}
-	else if constexpr(std::is_same_v<std::decay_t<t_real>, std::int64_t>)
-	{
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "abs", "labs",
-			SymbolType::INT, {SymbolType::INT});
+		case VMType::REAL: return SymbolType::REAL;
+		case VMType::INT: return SymbolType::INT;
+		case VMType::STR: return SymbolType::STRING;
+		case VMType::UNKNOWN: return SymbolType::VOID;
+		default: return SymbolType::UNKNOWN;
 	}
+}
 
-	ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "strlen", "strlen",
-		SymbolType::INT, {SymbolType::STRING});
 
-	ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "set_debug", "set_debug",
-		SymbolType::VOID, {SymbolType::INT});
+/**
+ * registers external runtime functions which should be available to the compiler
+ */
+static inline void add_ext_funcs(ParserContext& ctx, bool skip_some = false)
+{
+	// native functions from the vm's registry
+	for(const ExtFuncInfo& func : g_vm_ext_funcs)
+	{
+		if(func.decl == ExtFuncDecl::NONE)
+			continue;
+		// functions that could also be declared as internals
+		if(func.decl == ExtFuncDecl::OPTIONAL && skip_some)
+			continue;
 
-	ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "sleep", "sleep",
-		SymbolType::VOID, {SymbolType::INT});
-	ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "set_timer", "set_timer",
-		SymbolType::VOID, {SymbolType::INT});
+		std::vector<SymbolType> argtypes;
+		for(VMType argty : func.argtys)
+		{
+			if(argty != VMType::UNKNOWN)
+				argtypes.push_back(get_ext_func_symtype(argty));
+		}
 
-	ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "set_eps", "set_eps",
-		SymbolType::VOID, {SymbolType::REAL});
-	ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "get_eps", "get_eps",
-		SymbolType::REAL, {});
+		const t_str name{func.name};
+		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), name, name,
+			get_ext_func_symtype(func.retty), argtypes);
+	}
 
 	// functions that could also be declared as internals
 	if(!skip_some)
 	{
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "write", "write",
-			SymbolType::VOID, {SymbolType::STRING});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "write_no_cr", "write_no_cr",
-			SymbolType::VOID, {SymbolType::STRING});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "read_real", "read_real",
-			SymbolType::REAL, {SymbolType::STRING});
-		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "read_integer", "read_integer",
-			SymbolType::INT, {SymbolType::STRING});
 		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "real_to_string", "real_to_string",
 			SymbolType::VOID, {SymbolType::REAL, SymbolType::STRING, SymbolType::INT});
 		ctx.GetSymbols().AddExtFunc(ctx.GetScopeName(), "integer_to_string", "integer_to_string",
@@ -112,5 +67,4 @@ void add_ext_funcs(ParserContext& ctx, bool skip_some = false)
 	}
 }
 
-
 #endif
@@ -308,23 +308,9 @@ void Grammar::CreateGrammar()
 		if(!full_match)
 			return nullptr;
 
-		auto write_stmts = std::make_shared<ASTStmts>();
-
-		// create a list of write statements out of the argument expressions
+		// write all argument expressions and a newline with a single call
 		auto exprs = std::dynamic_pointer_cast<ASTExprList>(args[3]);
-		for(ASTPtr expr : exprs->GetList())
-		{
-			auto arg = std::make_shared<ASTExprList>(expr);
-			auto write_stmt = std::make_shared<ASTCall>("write_no_cr", arg);
-			write_stmts->AddStatement(write_stmt, true);
-		}
-
-		// newline
-		auto arg = std::make_shared<ASTExprList>(std::make_shared<ASTStrConst>("\n"));
-		auto write_stmt = std::make_shared<ASTCall>("write_no_cr", arg);
-		write_stmts->AddStatement(write_stmt, true);
-
-		return write_stmts;
+		return std::make_shared<ASTCall>("print", exprs);
 	}));
 #endif
 	++semanticindex;
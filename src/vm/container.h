@@ -0,0 +1,454 @@
+/**
+ * zero-address code vm, program container format
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __0ACVM_CONTAINER_H__
+#define __0ACVM_CONTAINER_H__
+
+
+#include <array>
+#include <vector>
+#include <optional>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+
+#include "types.h"
+
+
+
+// ----------------------------------------------------------------------------
+// helpers to write and read the section contents
+// ----------------------------------------------------------------------------
+template<class t_val>
+void write_section_val(std::ostream& ostr, t_val val)
+{
+	ostr.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+
+static inline void write_section_str(std::ostream& ostr, const t_vm_str& str)
+{
+	write_section_val<t_vm_addr>(ostr, static_cast<t_vm_addr>(str.length()));
+	ostr.write(str.data(), str.length());
+}
+
+
+template<class t_val>
+bool read_section_val(const t_vm_byte*& ptr, const t_vm_byte* end, t_val& val)
+{
+	if(end - ptr < static_cast<std::ptrdiff_t>(sizeof(val)))
+		return false;
+
+	std::memcpy(&val, ptr, sizeof(val));
+	ptr += sizeof(val);
+	return true;
+}
+
+
+static inline bool read_section_str(const t_vm_byte*& ptr, const t_vm_byte* end, t_vm_str& str)
+{
+	t_vm_addr len = 0;
+	if(!read_section_val(ptr, end, len) || len < 0 || end - ptr < len)
+		return false;
+
+	str.assign(reinterpret_cast<const char*>(ptr), len);
+	ptr += len;
+	return true;
+}
+
+
+static inline std::vector<t_vm_byte> get_section_bytes(const std::ostringstream& ostr)
+{
+	const std::string str = ostr.str();
+	return std::vector<t_vm_byte>(str.begin(), str.end());
+}
+// ----------------------------------------------------------------------------
+
+
+
+enum class SectionType : std::uint32_t
+{
+	CODE        = 0x01,   // instructions, loaded at their address
+	CONSTS      = 0x02,   // constants table, loaded at their address
+	FUNCS       = 0x03,   // function table, see FuncTable
+	DEBUG       = 0x04,   // source lines and functions, see DebugInfo
+};
+
+
+
+/**
+ * table of the compiled functions
+ *
+ * layout: [count] { [begin][end][number of arguments][frame size][name length][name chars] }
+ * (begin, end, lengths and count are t_vm_addr values, the rest t_vm_int values)
+ */
+class FuncTable
+{
+public:
+	/**
+	 * function covering the code range [addr, end_addr)
+	 */
+	struct Func
+	{
+		t_vm_str name{};
+		t_vm_addr addr{0};
+		t_vm_addr end_addr{0};
+		t_vm_int num_args{0};
+		t_vm_int framesize{0};
+	};
+
+
+public:
+	void AddFunc(const Func& func) { m_funcs.push_back(func); }
+	const std::vector<Func>& GetFuncs() const { return m_funcs; }
+
+
+	void Write(std::ostream& ostr) const
+	{
+		write_section_val<t_vm_addr>(ostr, static_cast<t_vm_addr>(m_funcs.size()));
+		for(const Func& func : m_funcs)
+		{
+			write_section_val<t_vm_addr>(ostr, func.addr);
+			write_section_val<t_vm_addr>(ostr, func.end_addr);
+			write_section_val<t_vm_int>(ostr, func.num_args);
+			write_section_val<t_vm_int>(ostr, func.framesize);
+			write_section_str(ostr, func.name);
+		}
+	}
+
+
+	bool Read(const t_vm_byte* data, std::size_t size)
+	{
+		const t_vm_byte* ptr = data;
+		const t_vm_byte* end = data + size;
+		m_funcs.clear();
+
+		t_vm_addr num_funcs = 0;
+		if(!read_section_val(ptr, end, num_funcs) || num_funcs < 0)
+			return false;
+		for(t_vm_addr idx = 0; idx < num_funcs; ++idx)
+		{
+			Func func{};
+			if(!read_section_val(ptr, end, func.addr) || !read_section_val(ptr, end, func.end_addr)
+				|| !read_section_val(ptr, end, func.num_args) || !read_section_val(ptr, end, func.framesize)
+				|| !read_section_str(ptr, end, func.name))
+				return false;
+			m_funcs.emplace_back(std::move(func));
+		}
+
+		return true;
+	}
+
+
+private:
+	std::vector<Func> m_funcs{};
+};
+
+
+
+/**
+ * program file made up of a header and sections
+ *
+ * layout (fixed-width numbers in host byte order):
+ *   header:   [magic: 8 bytes][version: u16][address size: u8][real size: u8]
+ *             [int size: u8][stack slot size: u8][reserved: 2 bytes]
+ *             [section count: u32][reserved: u32]
+ *   sections: { [type: u32][flags: u32][load address: u64][file offset: u64][size: u64] }
+ *   contents of the sections, the code section starts at a page boundary
+ *             so that it can be mapped directly into the vm's memory
+ *
+ * a stack slot size of 0 denotes the compact layout of values without padding.
+ * files without the magic are raw code and constants (the former format).
+ */
+class ProgContainer
+{
+public:
+	static constexpr const std::array<char, 8> m_magic
+		{ '0', 'a', 'c', 'p', 'r', 'o', 'g', '\0' };
+	static constexpr const std::uint16_t m_version = 1;
+
+	static constexpr const std::size_t m_header_size = 24;
+	static constexpr const std::size_t m_section_entry_size = 32;
+
+	// alignment of the code section and of the other sections
+	static constexpr const std::size_t m_code_align = 4096;
+	static constexpr const std::size_t m_section_align = 8;
+
+
+	struct Section
+	{
+		SectionType type{};
+		std::uint32_t flags{0};
+		std::uint64_t addr{0};               // load address for code and constants
+		std::uint64_t offset{0};             // file offset
+		std::uint64_t size{0};
+		const t_vm_byte* data{nullptr};      // contents in the read file or the added data
+	};
+
+
+public:
+	ProgContainer() = default;
+	ProgContainer(const ProgContainer&) = delete;
+	ProgContainer& operator=(const ProgContainer&) = delete;
+
+	t_vm_byte GetAddrSize() const { return m_addr_size; }
+	t_vm_byte GetRealSize() const { return m_real_size; }
+	t_vm_byte GetIntSize() const { return m_int_size; }
+	t_vm_byte GetSlotSize() const { return m_slot_size; }
+
+	const std::vector<Section>& GetSections() const { return m_sections; }
+
+
+	/**
+	 * get the first section of the given type
+	 */
+	const Section* GetSection(SectionType ty) const
+	{
+		for(const Section& sec : m_sections)
+		{
+			if(sec.type == ty)
+				return &sec;
+		}
+
+		return nullptr;
+	}
+
+
+	/**
+	 * add a section with a copy of the data, replacing one of the same type
+	 */
+	void SetSection(SectionType ty, std::vector<t_vm_byte>&& data, std::uint64_t addr = 0)
+	{
+		RemoveSection(ty);
+
+		m_owned.emplace_back(std::move(data));
+		const std::vector<t_vm_byte>& owned = m_owned.back();
+
+		m_sections.emplace_back(Section
+		{
+			.type = ty,
+			.flags = 0,
+			.addr = addr,
+			.offset = 0,
+			.size = owned.size(),
+			.data = owned.data(),
+		});
+	}
+
+
+	void SetSection(SectionType ty, const t_vm_byte* data, std::size_t size, std::uint64_t addr = 0)
+	{
+		SetSection(ty, std::vector<t_vm_byte>(data, data + size), addr);
+	}
+
+
+	void RemoveSection(SectionType ty)
+	{
+		std::erase_if(m_sections, [ty](const Section& sec) -> bool
+		{
+			return sec.type == ty;
+		});
+	}
+
+
+	/**
+	 * does the file start with the container's magic?
+	 */
+	static bool IsContainer(const t_vm_byte* file, std::size_t size)
+	{
+		return size >= m_magic.size()
+			&& std::memcmp(file, m_magic.data(), m_magic.size()) == 0;
+	}
+
+
+	/**
+	 * write the header, the section table and the contents
+	 */
+	void Write(std::ostream& ostr) const
+	{
+		// file offsets of the section contents
+		std::vector<std::uint64_t> offsets;
+		std::uint64_t offset = m_header_size + m_section_entry_size*m_sections.size();
+		for(const Section& sec : m_sections)
+		{
+			const std::uint64_t align = (sec.type == SectionType::CODE
+				? m_code_align : m_section_align);
+			offset = (offset + align - 1) / align * align;
+			offsets.push_back(offset);
+			offset += sec.size;
+		}
+
+		// header
+		ostr.write(m_magic.data(), m_magic.size());
+		write_section_val<std::uint16_t>(ostr, m_version);
+		write_section_val<t_vm_byte>(ostr, sizeof(t_vm_addr));
+		write_section_val<t_vm_byte>(ostr, sizeof(t_vm_real));
+		write_section_val<t_vm_byte>(ostr, sizeof(t_vm_int));
+		write_section_val<t_vm_byte>(ostr, get_slot_size());
+		write_padding(ostr, 2);
+		write_section_val<std::uint32_t>(ostr, static_cast<std::uint32_t>(m_sections.size()));
+		write_padding(ostr, 4);
+
+		// section table
+		for(std::size_t idx = 0; idx < m_sections.size(); ++idx)
+		{
+			const Section& sec = m_sections[idx];
+			write_section_val<std::uint32_t>(ostr, static_cast<std::uint32_t>(sec.type));
+			write_section_val<std::uint32_t>(ostr, sec.flags);
+			write_section_val<std::uint64_t>(ostr, sec.addr);
+			write_section_val<std::uint64_t>(ostr, offsets[idx]);
+			write_section_val<std::uint64_t>(ostr, sec.size);
+		}
+
+		// section contents
+		std::uint64_t pos = m_header_size + m_section_entry_size*m_sections.size();
+		for(std::size_t idx = 0; idx < m_sections.size(); ++idx)
+		{
+			const Section& sec = m_sections[idx];
+			write_padding(ostr, offsets[idx] - pos);
+			ostr.write(reinterpret_cast<const char*>(sec.data), sec.size);
+			pos = offsets[idx] + sec.size;
+		}
+	}
+
+
+	/**
+	 * read and validate the header and the section table,
+	 * the section data refers to the file contents
+	 * @returns an error message if the file is not valid
+	 */
+	std::optional<t_vm_str> Read(const t_vm_byte* file, std::size_t size)
+	{
+		m_sections.clear();
+		m_owned.clear();
+
+		if(size < m_header_size || !IsContainer(file, size))
+			return "Invalid program header.";
+
+		const t_vm_byte* ptr = file + m_magic.size();
+		const t_vm_byte* end = file + size;
+
+		std::uint16_t version = 0;
+		std::uint32_t num_sections = 0;
+		read_section_val(ptr, end, version);
+		read_section_val(ptr, end, m_addr_size);
+		read_section_val(ptr, end, m_real_size);
+		read_section_val(ptr, end, m_int_size);
+		read_section_val(ptr, end, m_slot_size);
+		ptr += 2;
+		read_section_val(ptr, end, num_sections);
+		ptr += 4;
+
+		if(version != m_version)
+		{
+			std::ostringstream msg;
+			msg << "Unsupported program version " << version
+				<< ", expected version " << m_version << ".";
+			return msg.str();
+		}
+
+		if(num_sections > (size - m_header_size) / m_section_entry_size)
+			return "Invalid number of program sections.";
+
+		for(std::uint32_t idx = 0; idx < num_sections; ++idx)
+		{
+			Section sec{};
+			std::uint32_t ty = 0;
+			read_section_val(ptr, end, ty);
+			read_section_val(ptr, end, sec.flags);
+			read_section_val(ptr, end, sec.addr);
+			read_section_val(ptr, end, sec.offset);
+			read_section_val(ptr, end, sec.size);
+			sec.type = static_cast<SectionType>(ty);
+
+			if(sec.offset > size || sec.size > size - sec.offset)
+				return "Program section exceeds the file size.";
+
+			sec.data = file + sec.offset;
+			m_sections.push_back(sec);
+		}
+
+		return std::nullopt;
+	}
+
+
+	/**
+	 * check if the program's data types match the ones of the vm
+	 * @returns an error message if they do not
+	 */
+	std::optional<t_vm_str> CheckTypes() const
+	{
+		auto check = [](const char* name, std::size_t prog_size, std::size_t vm_size)
+			-> std::optional<t_vm_str>
+		{
+			if(prog_size == vm_size)
+				return std::nullopt;
+
+			std::ostringstream msg;
+			msg << "The program has been compiled for " << prog_size*8
+				<< " bit " << name << ", but the vm uses " << vm_size*8
+				<< " bit " << name << ".";
+			return msg.str();
+		};
+
+		if(auto err = check("addresses", m_addr_size, sizeof(t_vm_addr)))
+			return err;
+		if(auto err = check("reals", m_real_size, sizeof(t_vm_real)))
+			return err;
+		if(auto err = check("integers", m_int_size, sizeof(t_vm_int)))
+			return err;
+
+		if(m_slot_size != get_slot_size())
+		{
+			auto layout_name = [](t_vm_byte slot_size) -> t_vm_str
+			{
+				if(slot_size == 0)
+					return "the compact value layout";
+
+				std::ostringstream ostr;
+				ostr << "aligned " << int(slot_size) << " byte stack slots";
+				return ostr.str();
+			};
+
+			return "The program has been compiled for " + layout_name(m_slot_size)
+				+ ", but the vm uses " + layout_name(get_slot_size()) + ".";
+		}
+		return std::nullopt;
+	}
+
+
+protected:
+	/**
+	 * stack slot size of the values, 0 for the compact layout
+	 */
+	static constexpr t_vm_byte get_slot_size()
+	{
+		return g_vm_slot_size > 1 ? static_cast<t_vm_byte>(g_vm_slot_size) : 0;
+	}
+
+	static void write_padding(std::ostream& ostr, std::uint64_t len)
+	{
+		for(std::uint64_t i = 0; i < len; ++i)
+			ostr.put(0);
+	}
+
+
+private:
+	t_vm_byte m_addr_size{sizeof(t_vm_addr)};
+	t_vm_byte m_real_size{sizeof(t_vm_real)};
+	t_vm_byte m_int_size{sizeof(t_vm_int)};
+	t_vm_byte m_slot_size{get_slot_size()};
+
+	std::vector<Section> m_sections{};
+
+	// contents of the added sections
+	std::vector<std::vector<t_vm_byte>> m_owned{};
+};
+
+
+#endif
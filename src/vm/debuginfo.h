@@ -0,0 +1,236 @@
+/**
+ * zero-address code vm, debug info section
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __0ACVM_DEBUGINFO_H__
+#define __0ACVM_DEBUGINFO_H__
+
+
+#include <array>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+#include "types.h"
+#include "container.h"
+
+
+
+/**
+ * optional section of the program container, mapping code addresses
+ * to source lines and functions
+ *
+ * layout (all numbers are t_vm_addr values):
+ *   source file name: [length][chars]
+ *   function table:   [count] { [begin][end][line][name length][name chars] }
+ *   line table:       [count] { [address][line] }, line 0: no source line
+ */
+class DebugInfo
+{
+public:
+	/**
+	 * function covering the code range [addr, end_addr)
+	 */
+	struct Func
+	{
+		t_vm_str name{};
+		t_vm_addr addr{0};
+		t_vm_addr end_addr{0};
+		t_vm_addr line{0};
+	};
+
+
+	/**
+	 * first code address belonging to a source line
+	 */
+	struct Line
+	{
+		t_vm_addr addr{0};
+		t_vm_addr line{0};
+	};
+
+
+public:
+	void SetSourceFile(const t_vm_str& file) { m_srcfile = file; }
+	const t_vm_str& GetSourceFile() const { return m_srcfile; }
+
+	const std::vector<Func>& GetFuncs() const { return m_funcs; }
+	const std::vector<Line>& GetLines() const { return m_lines; }
+
+
+	/**
+	 * the code of a source line starts at the given address
+	 */
+	void AddLine(t_vm_addr addr, t_vm_addr line)
+	{
+		if(m_lines.size())
+		{
+			Line& last = m_lines.back();
+
+			// still the same line
+			if(last.line == line)
+				return;
+
+			// the statement contains other statements, use the innermost one
+			if(last.addr == addr)
+			{
+				last.line = line;
+				return;
+			}
+		}
+
+		m_lines.emplace_back(Line{ .addr = addr, .line = line });
+	}
+
+
+	void AddFunc(const t_vm_str& name, t_vm_addr addr, t_vm_addr end_addr, t_vm_addr line)
+	{
+		m_funcs.emplace_back(Func{ .name = name, .addr = addr,
+			.end_addr = end_addr, .line = line });
+	}
+
+
+	/**
+	 * get the function containing the code address
+	 */
+	const Func* GetFunc(t_vm_addr addr) const
+	{
+		auto iter = std::upper_bound(m_funcs.begin(), m_funcs.end(), addr,
+			[](t_vm_addr addr, const Func& func) -> bool
+		{
+			return addr < func.addr;
+		});
+
+		if(iter == m_funcs.begin())
+			return nullptr;
+		--iter;
+
+		if(addr >= iter->end_addr)
+			return nullptr;
+		return &*iter;
+	}
+
+
+	/**
+	 * get the source line of the code address
+	 */
+	std::optional<t_vm_addr> GetLine(t_vm_addr addr) const
+	{
+		auto iter = std::upper_bound(m_lines.begin(), m_lines.end(), addr,
+			[](t_vm_addr addr, const Line& line) -> bool
+		{
+			return addr < line.addr;
+		});
+
+		if(iter == m_lines.begin())
+			return std::nullopt;
+
+		const t_vm_addr line = std::prev(iter)->line;
+		if(line <= 0)
+			return std::nullopt;
+		return line;
+	}
+
+
+	/**
+	 * write the contents of the section
+	 */
+	void Write(std::ostream& ostr)
+	{
+		Sort();
+
+		write_section_str(ostr, m_srcfile);
+
+		write_section_val<t_vm_addr>(ostr, static_cast<t_vm_addr>(m_funcs.size()));
+		for(const Func& func : m_funcs)
+		{
+			write_section_val<t_vm_addr>(ostr, func.addr);
+			write_section_val<t_vm_addr>(ostr, func.end_addr);
+			write_section_val<t_vm_addr>(ostr, func.line);
+			write_section_str(ostr, func.name);
+		}
+
+		write_section_val<t_vm_addr>(ostr, static_cast<t_vm_addr>(m_lines.size()));
+		for(const Line& line : m_lines)
+		{
+			write_section_val<t_vm_addr>(ostr, line.addr);
+			write_section_val<t_vm_addr>(ostr, line.line);
+		}
+	}
+
+
+	/**
+	 * read the contents of the section
+	 */
+	bool Read(const t_vm_byte* data, std::size_t size)
+	{
+		const t_vm_byte* ptr = data;
+		const t_vm_byte* end = data + size;
+
+		m_funcs.clear();
+		m_lines.clear();
+
+		if(!read_section_str(ptr, end, m_srcfile))
+			return false;
+
+		t_vm_addr num_funcs = 0;
+		if(!read_section_val(ptr, end, num_funcs) || num_funcs < 0)
+			return false;
+		for(t_vm_addr idx = 0; idx < num_funcs; ++idx)
+		{
+			Func func{};
+			if(!read_section_val(ptr, end, func.addr) || !read_section_val(ptr, end, func.end_addr)
+				|| !read_section_val(ptr, end, func.line) || !read_section_str(ptr, end, func.name))
+				return false;
+			m_funcs.emplace_back(std::move(func));
+		}
+
+		t_vm_addr num_lines = 0;
+		if(!read_section_val(ptr, end, num_lines) || num_lines < 0)
+			return false;
+		for(t_vm_addr idx = 0; idx < num_lines; ++idx)
+		{
+			Line line{};
+			if(!read_section_val(ptr, end, line.addr) || !read_section_val(ptr, end, line.line))
+				return false;
+			m_lines.push_back(line);
+		}
+
+		Sort();
+		return true;
+	}
+
+
+protected:
+	/**
+	 * sort the tables by address for the lookups
+	 */
+	void Sort()
+	{
+		std::stable_sort(m_funcs.begin(), m_funcs.end(),
+			[](const Func& func1, const Func& func2) -> bool
+		{
+			return func1.addr < func2.addr;
+		});
+
+		std::stable_sort(m_lines.begin(), m_lines.end(),
+			[](const Line& line1, const Line& line2) -> bool
+		{
+			return line1.addr < line2.addr;
+		});
+	}
+
+
+private:
+	t_vm_str m_srcfile{};
+	std::vector<Func> m_funcs{};
+	std::vector<Line> m_lines{};
+};
+
+
+#endif
@@ -0,0 +1,268 @@
+/**
+ * zero-address code vm, load-time instruction decoder
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "vm.h"
+#include "mem.h"
+
+#include <iostream>
+
+
+/**
+ * get the size of the direct data (including its type descriptor)
+ * at the given address, if it can be pushed by a single copy
+ */
+std::optional<VM::t_addr> VM::GetDirectDataSize(t_addr addr) const
+{
+	if(addr < 0 || addr + m_descrsize > m_code_range[1])
+		return std::nullopt;
+
+	VMType ty = static_cast<VMType>(m_mem[addr]);
+	t_addr size = 0;
+
+	switch(ty)
+	{
+		case VMType::REAL: size = GetDataTypeSize<t_real>(); break;
+		case VMType::INT: size = GetDataTypeSize<t_int>(); break;
+		case VMType::CPLX: size = GetDataTypeSize<t_cplx>(); break;
+		case VMType::QUAT: size = GetDataTypeSize<t_quat>(); break;
+		case VMType::BOOL: size = GetDataTypeSize<t_bool>(); break;
+
+		case VMType::ADDR_MEM:
+		case VMType::ADDR_IP:
+		case VMType::ADDR_SP:
+		case VMType::ADDR_BP:
+		case VMType::ADDR_GBP:
+			size = m_addrsize;
+			break;
+
+		case VMType::STR:
+		{
+			if(addr + m_descrsize + m_addrsize > m_code_range[1])
+				return std::nullopt;
+
+			t_addr len = ReadMemRaw<t_addr>(addr + m_descrsize);
+			if(len < 0)
+				return std::nullopt;
+			size = m_addrsize + len*m_charsize;
+			break;
+		}
+
+		// arrays and unknown types are not decoded
+		default:
+			return std::nullopt;
+	}
+
+	size = vm_slot_size(size + m_descrsize);
+	if(addr + size > m_code_range[1])
+		return std::nullopt;
+
+	return size;
+}
+
+
+/**
+ * decode the instruction at the given address,
+ * fusing the pushes of jump addresses and frame sizes with the
+ * instructions that consume them
+ */
+std::optional<VM::DecodedInstr> VM::DecodeInstr(t_addr addr) const
+{
+	DecodedInstr instr{};
+	instr.op = static_cast<OpCode>(m_mem[addr]);
+	instr.next_ip = addr + m_bytesize;
+
+	// superinstructions with an inline address operand
+	if(has_vm_addr_operand(instr.op))
+	{
+		if(addr < 0 || addr + m_bytesize + m_addrsize > m_memsize)
+			return std::nullopt;
+
+		t_addr operand = ReadMemRaw<t_addr>(addr + m_bytesize);
+		instr.next_ip += m_addrsize;
+
+		switch(instr.op)
+		{
+			case OpCode::LOADLOCAL:
+			case OpCode::LOADGLOBAL:
+			case OpCode::STORELOCAL:
+			case OpCode::STOREGLOBAL:
+			case OpCode::LOADLOCAL_IU:
+			case OpCode::LOADLOCAL_RU:
+			case OpCode::LOADGLOBAL_IU:
+			case OpCode::LOADGLOBAL_RU:
+			case OpCode::STORELOCAL_IU:
+			case OpCode::STORELOCAL_RU:
+			case OpCode::STOREGLOBAL_IU:
+			case OpCode::STOREGLOBAL_RU:
+				instr.var_addr = operand;
+				break;
+
+			// jump address relative to the instruction pointer after the jump
+			default:
+				instr.target = operand + instr.next_ip;
+				break;
+		}
+
+		return instr;
+	}
+
+	if(instr.op != OpCode::PUSH)
+		return instr;
+
+	auto datasize = GetDirectDataSize(addr + m_bytesize);
+	if(!datasize)
+		return std::nullopt;
+
+	instr.op = OpCode::PUSHD;
+	instr.data_addr = addr + m_bytesize;
+	instr.data_size = *datasize;
+	instr.next_ip = instr.data_addr + instr.data_size;
+
+	// get the opcode following the current instruction
+	auto op_at = [this](t_addr addr) -> OpCode
+	{
+		if(addr < m_code_range[0] || addr >= m_code_range[1])
+			return OpCode::INVALID;
+		return static_cast<OpCode>(m_mem[addr]);
+	};
+
+	// get the integer or address operand and the size of a push instruction
+	auto push_operand_at = [this, &op_at](t_addr addr, VMType ty)
+		-> std::optional<std::tuple<t_int, t_addr>>
+	{
+		if(op_at(addr) != OpCode::PUSH)
+			return std::nullopt;
+
+		auto size = GetDirectDataSize(addr + m_bytesize);
+		if(!size || static_cast<VMType>(m_mem[addr + m_bytesize]) != ty)
+			return std::nullopt;
+
+		t_int val = 0;
+		if(ty == VMType::INT)
+			val = ReadMemRaw<t_int>(addr + m_bytesize + m_descrsize);
+		else
+			val = ReadMemRaw<t_addr>(addr + m_bytesize + m_descrsize);
+
+		return std::make_tuple(val, m_bytesize + *size);
+	};
+
+	VMType ty = static_cast<VMType>(m_mem[instr.data_addr]);
+
+	// relative jump address: push ADDR_IP, (jmp | jmpcnd)
+	if(ty == VMType::ADDR_IP)
+	{
+		OpCode next_op = op_at(instr.next_ip);
+		if(next_op == OpCode::JMP || next_op == OpCode::JMPCND)
+		{
+			instr.op = (next_op == OpCode::JMP ? OpCode::JMPD : OpCode::JMPCNDD);
+			instr.next_ip += m_bytesize;
+
+			// the address is relative to the instruction pointer after the jump
+			instr.target = ReadMemRaw<t_addr>(instr.data_addr + m_descrsize)
+				+ instr.next_ip;
+		}
+	}
+
+	else if(ty == VMType::INT)
+	{
+		t_int val = ReadMemRaw<t_int>(instr.data_addr + m_descrsize);
+		OpCode next_op = op_at(instr.next_ip);
+
+		// untagged constant: push INT, untag_i
+		if(next_op == OpCode::UNTAG_I)
+		{
+			instr.op = OpCode::PUSHUD;
+			instr.next_ip += m_bytesize;
+		}
+
+		// stack frame: push INT, (addframe | remframe)
+		else if(next_op == OpCode::ADDFRAME || next_op == OpCode::REMFRAME)
+		{
+			instr.op = (next_op == OpCode::ADDFRAME ? OpCode::ADDFRAMED : OpCode::REMFRAMED);
+			instr.framesize = val;
+			instr.next_ip += m_bytesize;
+		}
+
+		// function call: push INT framesize, push ADDR_IP, call
+		else if(auto funcaddr = push_operand_at(instr.next_ip, VMType::ADDR_IP);
+			funcaddr && op_at(instr.next_ip + std::get<1>(*funcaddr)) == OpCode::CALL)
+		{
+			instr.op = OpCode::CALLD;
+			instr.framesize = val;
+			instr.next_ip += std::get<1>(*funcaddr) + m_bytesize;
+			instr.target = static_cast<t_addr>(std::get<0>(*funcaddr)) + instr.next_ip;
+		}
+
+		// function return: push INT framesize, push INT num_args, ret
+		else if(auto num_args = push_operand_at(instr.next_ip, VMType::INT);
+			num_args && op_at(instr.next_ip + std::get<1>(*num_args)) == OpCode::RET)
+		{
+			instr.op = OpCode::RETD;
+			instr.framesize = val;
+			instr.num_args = std::get<0>(*num_args);
+			instr.next_ip += std::get<1>(*num_args) + m_bytesize;
+		}
+	}
+
+	// untagged constant: push REAL, untag_r
+	else if(ty == VMType::REAL && op_at(instr.next_ip) == OpCode::UNTAG_R)
+	{
+		instr.op = OpCode::PUSHUD;
+		instr.next_ip += m_bytesize;
+	}
+
+	return instr;
+}
+
+
+/**
+ * decode the instructions in the code range once before running them,
+ * the code is assumed not to be modified by the running program
+ */
+void VM::DecodeCode()
+{
+	if(m_code_decoded)
+		return;
+
+	m_decoded.clear();
+	m_code_decoded = true;
+
+	if(m_code_range[0] < 0 || m_code_range[1] < 0)
+		return;
+
+	m_decoded.resize(m_code_range[1] - m_code_range[0]);
+
+	// linear sweep over the code, every instruction gets its own entry, also
+	// those covered by fused instructions, so that jumps to them still work
+	t_addr num_decoded = 0;
+	for(t_addr addr = m_code_range[0]; addr < m_code_range[1];)
+	{
+		std::optional<DecodedInstr> instr = DecodeInstr(addr);
+
+		// not decodable, e.g. data after the code, run it undecoded
+		if(!instr)
+		{
+			++addr;
+			continue;
+		}
+
+		m_decoded[addr - m_code_range[0]] = *instr;
+		++num_decoded;
+
+		// advance to the next (non-fused) instruction
+		if(instr->data_size > 0)
+			addr = instr->data_addr + instr->data_size;
+		else
+			addr = instr->next_ip;
+	}
+
+	if(m_debug)
+	{
+		std::cout << "Decoded " << num_decoded << " instructions."
+			<< std::endl;
+	}
+}
@@ -9,194 +9,348 @@
 
 
 /**
- * call external function
+ * set the size of the program output buffer, zero for unbuffered output
+ */
+void VM::SetOutputBuffer(std::size_t size, bool flush_lines)
+{
+	FlushOutput();
+
+	m_outbuf_size = size;
+	m_outbuf_flushlines = flush_lines;
+	m_outbuf.reserve(size);
+}
+
+
+/**
+ * write program output, flush it if the buffer is full or a line is completed
+ */
+void VM::WriteOutput(const t_str& str)
+{
+	m_outbuf += str;
+
+	// don't buffer in debug mode to keep the order with the debug messages
+	if(m_outbuf.size() >= m_outbuf_size || m_debug ||
+		(m_outbuf_flushlines && str.find('\n') != t_str::npos))
+		FlushOutput();
+}
+
+
+/**
+ * write out the buffered program output
+ */
+void VM::FlushOutput()
+{
+	if(m_outbuf.size())
+	{
+		std::cout.write(m_outbuf.data(), m_outbuf.size());
+		m_outbuf.clear();
+	}
+
+	std::cout.flush();
+}
+
+
+/**
+ * call external function by name
  */
 VM::t_data VM::CallExternal(const t_str& func_name)
+{
+	const ExtFuncInfo* func = get_vm_ext_func(func_name);
+	if(!func)
+	{
+		if(m_debug)
+		{
+			std::cout << "unknown external function \"" << func_name << "\"."
+				<< std::endl;
+		}
+
+		return t_data{};
+	}
+
+	return CallExternal(func->id);
+}
+
+
+/**
+ * call external function by its id
+ */
+VM::t_data VM::CallExternal(ExtFunc func_id)
 {
 	t_data retval;
 
 	if(m_debug)
 	{
-		std::cout << "calling external function \"" << func_name << "\""
+		const ExtFuncInfo* func = get_vm_ext_func(func_id);
+		std::cout << "calling external function \""
+			<< (func ? func->name : "<invalid>") << "\""
 			//<< " with " << num_args << " arguments."
 			<< "." << std::endl;
 	}
 
-	// --------------------------------------------------------------------
-	// mathematical functions
-	// --------------------------------------------------------------------
-	if(func_name == "abs" || func_name == "fabs" || func_name == "norm")
+	switch(func_id)
 	{
-		t_data dat = PopData();
+		// --------------------------------------------------------------------
+		// mathematical functions
+		// --------------------------------------------------------------------
+		case ExtFunc::ABS:
+		case ExtFunc::FABS:
+		case ExtFunc::NORM:
+		{
+			t_data dat = PopData();
+
+			if(dat.index() == m_realidx)
+			{
+				t_real arg = std::get<m_realidx>(dat);
+				if(arg < t_real(0))
+					arg = -arg;
+				retval = t_data{std::in_place_index<m_realidx>, arg};
+			}
+			else if(dat.index() == m_intidx)
+			{
+				t_int arg = std::get<m_intidx>(dat);
+				if(arg < 0)
+					arg = -arg;
+				retval = t_data{std::in_place_index<m_intidx>, arg};
+			}
+			else if(dat.index() == m_realarridx)
+			{	// 2-norm for vectors
+				t_vec_real arg = std::get<m_realarridx>(dat);
+				t_real len = m::norm<t_vec_real>(arg);
+				retval = t_data{std::in_place_index<m_realidx>, len};
+			}
+			else
+			{
+				// keep original data for other types
+				retval = dat;
+			}
 
-		if(dat.index() == m_realidx)
+			break;
+		}
+
+		case ExtFunc::SQRT:
 		{
-			t_real arg = std::get<m_realidx>(dat);
-			if(arg < t_real(0))
-				arg = -arg;
-			retval = t_data{std::in_place_index<m_realidx>, arg};
+			OpCast<m_realidx>();
+			t_real arg = std::get<m_realidx>(PopData());
+
+			retval = t_data{std::in_place_index<m_realidx>, std::sqrt(arg)};
+
+			break;
 		}
-		else if(dat.index() == m_intidx)
+
+		case ExtFunc::POW:
 		{
-			t_real arg = std::get<m_realidx>(dat);
-			if(arg < 0)
-				arg = -arg;
-			retval = t_data{std::in_place_index<m_intidx>, arg};
+			OpCast<m_realidx>();
+			t_real arg1 = std::get<m_realidx>(PopData());
+			OpCast<m_realidx>();
+			t_real arg2 = std::get<m_realidx>(PopData());
+
+			retval = t_data{std::in_place_index<m_realidx>, std::pow(arg1, arg2)};
+
+			break;
 		}
-		else if(dat.index() == m_realarridx)
-		{	// 2-norm for vectors
-			t_vec_real arg = std::get<m_realarridx>(dat);
-			t_real len = m::norm<t_vec_real>(arg);
-			retval = t_data{std::in_place_index<m_realidx>, len};
+
+		case ExtFunc::EXP:
+		{
+			OpCast<m_realidx>();
+			t_real arg = std::get<m_realidx>(PopData());
+
+			retval = t_data{std::in_place_index<m_realidx>, std::exp(arg)};
+
+			break;
 		}
-		else
+
+		case ExtFunc::SIN:
 		{
-			// keep original data for other types
-			retval = dat;
+			OpCast<m_realidx>();
+			t_real arg = std::get<m_realidx>(PopData());
+
+			retval = t_data{std::in_place_index<m_realidx>, std::sin(arg)};
+
+			break;
 		}
-	}
-	else if(func_name == "sqrt")
-	{
-		OpCast<m_realidx>();
-		t_real arg = std::get<m_realidx>(PopData());
 
-		retval = t_data{std::in_place_index<m_realidx>, std::sqrt(arg)};
-	}
-	else if(func_name == "pow")
-	{
-		OpCast<m_realidx>();
-		t_real arg1 = std::get<m_realidx>(PopData());
-		OpCast<m_realidx>();
-		t_real arg2 = std::get<m_realidx>(PopData());
+		case ExtFunc::COS:
+		{
+			OpCast<m_realidx>();
+			t_real arg = std::get<m_realidx>(PopData());
 
-		retval = t_data{std::in_place_index<m_realidx>, std::pow(arg1, arg2)};
-	}
-	else if(func_name == "sin")
-	{
-		OpCast<m_realidx>();
-		t_real arg = std::get<m_realidx>(PopData());
+			retval = t_data{std::in_place_index<m_realidx>, std::cos(arg)};
 
-		retval = t_data{std::in_place_index<m_realidx>, std::sin(arg)};
-	}
-	else if(func_name == "cos")
-	{
-		OpCast<m_realidx>();
-		t_real arg = std::get<m_realidx>(PopData());
+			break;
+		}
 
-		retval = t_data{std::in_place_index<m_realidx>, std::cos(arg)};
-	}
-	else if(func_name == "tan")
-	{
-		OpCast<m_realidx>();
-		t_real arg = std::get<m_realidx>(PopData());
+		case ExtFunc::TAN:
+		{
+			OpCast<m_realidx>();
+			t_real arg = std::get<m_realidx>(PopData());
 
-		retval = t_data{std::in_place_index<m_realidx>, std::tan(arg)};
-	}
-	else if(func_name == "set_eps")
-	{
-		OpCast<m_realidx>();
-		m_eps = std::get<m_realidx>(PopData());
-	}
-	else if(func_name == "set_prec")
-	{
-		OpCast<m_intidx>();
-		m_prec = std::get<m_intidx>(PopData());
-		std::cout.precision(m_prec);
-	}
-	else if(func_name == "get_eps")
-	{
-		retval = t_data{std::in_place_index<m_realidx>, m_eps};
-	}
-	// --------------------------------------------------------------------
+			retval = t_data{std::in_place_index<m_realidx>, std::tan(arg)};
 
-	// --------------------------------------------------------------------
-	// string functions
-	// --------------------------------------------------------------------
-	else if(func_name == "to_string")
-	{
-		OpCast<m_stridx>();
-	}
-	else if(func_name == "strlen")
-	{
-		OpCast<m_stridx>();
-		std::string arg = std::get<m_stridx>(PopData());
+			break;
+		}
 
-		retval = t_data{std::in_place_index<m_intidx>, arg.length()};
-	}
-	else if(func_name == "write")
-	{
-		OpCast<m_stridx>();
-		const t_str/*&*/ arg = std::get<m_stridx>(PopData());
-		std::cout << arg << std::endl;
-	}
-	else if(func_name == "write_no_cr")
-	{
-		OpCast<m_stridx>();
-		const t_str/*&*/ arg = std::get<m_stridx>(PopData());
-		std::cout << arg;
-		std::cout.flush();
-	}
-	else if(func_name == "read_real")
-	{
-		OpCast<m_stridx>();
-		const t_str/*&*/ arg = std::get<m_stridx>(PopData());
-		std::cout << arg;
-		std::cout.flush();
+		case ExtFunc::SET_EPS:
+		{
+			OpCast<m_realidx>();
+			m_eps = std::get<m_realidx>(PopData());
 
-		t_real val{};
-		std::cin >> val;
+			break;
+		}
 
-		retval = t_data{std::in_place_index<m_realidx>, val};
-	}
-	else if(func_name == "read_integer")
-	{
-		OpCast<m_stridx>();
-		const t_str/*&*/ arg = std::get<m_stridx>(PopData());
-		std::cout << arg;
-		std::cout.flush();
+		case ExtFunc::SET_PREC:
+		{
+			OpCast<m_intidx>();
+			m_prec = std::get<m_intidx>(PopData());
+			std::cout.precision(m_prec);
 
-		t_int val{};
-		std::cin >> val;
+			break;
+		}
 
-		retval = t_data{std::in_place_index<m_intidx>, val};
-	}
-	// --------------------------------------------------------------------
+		case ExtFunc::GET_EPS:
+		{
+			retval = t_data{std::in_place_index<m_realidx>, m_eps};
 
-	else if(func_name == "set_isr")
-	{
-		OpCast<m_intidx>();
-		t_addr num = static_cast<t_addr>(std::get<m_intidx>(PopData()));
-		t_addr addr = PopAddress();
+			break;
+		}
+		// --------------------------------------------------------------------
 
-		SetISR(num, addr);
-	}
-	else if(func_name == "sleep")
-	{
-		OpCast<m_intidx>();
-		t_int num = std::get<m_intidx>(PopData());
+		// --------------------------------------------------------------------
+		// string functions
+		// --------------------------------------------------------------------
+		case ExtFunc::TO_STRING:
+		{
+			OpCast<m_stridx>();
 
-		std::chrono::milliseconds ms{num};
-		std::this_thread::sleep_for(ms);
-	}
-	else if(func_name == "set_timer")
-	{
-		OpCast<m_intidx>();
-		t_int delay = std::get<m_intidx>(PopData());
+			break;
+		}
+
+		case ExtFunc::STRLEN:
+		{
+			OpCast<m_stridx>();
+			std::string arg = std::get<m_stridx>(PopData());
+
+			retval = t_data{std::in_place_index<m_intidx>, arg.length()};
+
+			break;
+		}
+
+		case ExtFunc::WRITE:
+		{
+			OpCast<m_stridx>();
+			t_str arg = std::get<m_stridx>(PopData());
+			arg += '\n';
+			WriteOutput(arg);
+
+			break;
+		}
+
+		case ExtFunc::WRITE_NO_CR:
+		{
+			OpCast<m_stridx>();
+			const t_str/*&*/ arg = std::get<m_stridx>(PopData());
+			WriteOutput(arg);
+
+			break;
+		}
 
-		if(delay < 0)
+		case ExtFunc::PRINT:
 		{
+			// write all items and a newline at once
+			OpCast<m_intidx>();
+			t_int num_items = std::get<m_intidx>(PopData());
+
+			t_str line;
+			for(t_int item = 0; item < num_items; ++item)
+			{
+				OpCast<m_stridx>();
+				line += std::get<m_stridx>(PopData());
+			}
+			line += '\n';
+			WriteOutput(line);
+
+			break;
+		}
+
+		case ExtFunc::READ_REAL:
+		{
+			OpCast<m_stridx>();
+			const t_str/*&*/ arg = std::get<m_stridx>(PopData());
+			WriteOutput(arg);
+			FlushOutput();
+
+			t_real val{};
+			std::cin >> val;
+
+			retval = t_data{std::in_place_index<m_realidx>, val};
+
+			break;
+		}
+
+		case ExtFunc::READ_INTEGER:
+		{
+			OpCast<m_stridx>();
+			const t_str/*&*/ arg = std::get<m_stridx>(PopData());
+			WriteOutput(arg);
+			FlushOutput();
+
+			t_int val{};
+			std::cin >> val;
+
+			retval = t_data{std::in_place_index<m_intidx>, val};
+
+			break;
+		}
+		// --------------------------------------------------------------------
+
+		case ExtFunc::SET_ISR:
+		{
+			OpCast<m_intidx>();
+			t_addr num = static_cast<t_addr>(std::get<m_intidx>(PopData()));
+			t_addr addr = PopAddress();
+
+			SetISR(num, addr);
+
+			break;
+		}
+
+		case ExtFunc::SLEEP:
+		{
+			OpCast<m_intidx>();
+			t_int num = std::get<m_intidx>(PopData());
+			FlushOutput();
+
+			std::chrono::milliseconds ms{num};
+			std::this_thread::sleep_for(ms);
+
+			break;
+		}
+
+		case ExtFunc::SET_TIMER:
+		{
+			OpCast<m_intidx>();
+			t_int delay = std::get<m_intidx>(PopData());
+
 			StopTimer();
+			m_timer_irq = (delay >= 0);
+			if(m_timer_irq)
+				m_timer_ticks = std::chrono::milliseconds{delay};
+			UpdateTimer();
+
+			break;
 		}
-		else
+
+		case ExtFunc::SET_DEBUG:
 		{
-			m_timer_ticks = std::chrono::milliseconds{delay};
-			StartTimer();
+			OpCast<m_intidx>();
+			m_debug = (std::get<m_intidx>(PopData()) != 0);
+
+			break;
+		}
+
+		default:
+		{
+			throw std::runtime_error("Invalid external function id.");
 		}
-	}
-	else if(func_name == "set_debug")
-	{
-		OpCast<m_intidx>();
-		m_debug = (std::get<m_intidx>(PopData()) != 0);
 	}
 
 	return retval;
@@ -0,0 +1,133 @@
+/**
+ * registry of the vm's native (external) functions,
+ * shared by the compiler and the vm
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __0ACVM_EXTFUNCS_H__
+#define __0ACVM_EXTFUNCS_H__
+
+
+#include <array>
+#include <string_view>
+
+#include "types.h"
+
+
+
+/**
+ * native function ids, passed to the extcall instruction
+ */
+enum class ExtFunc : t_vm_int
+{
+	INVALID = 0,
+
+	// mathematical functions
+	ABS, FABS, NORM,
+	SQRT, POW, EXP,
+	SIN, COS, TAN,
+	SET_EPS, SET_PREC, GET_EPS,
+
+	// string functions
+	TO_STRING, STRLEN,
+	WRITE, WRITE_NO_CR, PRINT,
+	READ_REAL, READ_INTEGER,
+
+	// system functions
+	SET_ISR, SLEEP, SET_TIMER, SET_DEBUG,
+};
+
+
+/**
+ * how a native function is made known to the compiler
+ */
+enum class ExtFuncDecl : t_vm_byte
+{
+	NONE,      // only used internally
+	ALWAYS,    // always declared
+	OPTIONAL,  // could also be declared as an internal function
+};
+
+
+/**
+ * name and signature of a native function
+ */
+struct ExtFuncInfo
+{
+	ExtFunc id{ExtFunc::INVALID};
+	std::string_view name{};
+
+	// return and argument types, VMType::UNKNOWN for none
+	VMType retty{VMType::UNKNOWN};
+	std::array<VMType, 2> argtys{VMType::UNKNOWN, VMType::UNKNOWN};
+
+	ExtFuncDecl decl{ExtFuncDecl::NONE};
+
+	// takes any number of arguments, followed by their count
+	bool variadic{false};
+};
+
+
+constexpr const std::array<ExtFuncInfo, 23> g_vm_ext_funcs
+{{
+	{ ExtFunc::ABS, "abs", VMType::INT, { VMType::INT }, ExtFuncDecl::NONE },
+	{ ExtFunc::FABS, "fabs", VMType::REAL, { VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::NORM, "norm", VMType::REAL, { VMType::REALARR }, ExtFuncDecl::NONE },
+	{ ExtFunc::SQRT, "sqrt", VMType::REAL, { VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::POW, "pow", VMType::REAL, { VMType::REAL, VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::EXP, "exp", VMType::REAL, { VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::SIN, "sin", VMType::REAL, { VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::COS, "cos", VMType::REAL, { VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::TAN, "tan", VMType::REAL, { VMType::REAL }, ExtFuncDecl::NONE },
+	{ ExtFunc::SET_EPS, "set_eps", VMType::UNKNOWN, { VMType::REAL }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::SET_PREC, "set_prec", VMType::UNKNOWN, { VMType::INT }, ExtFuncDecl::NONE },
+	{ ExtFunc::GET_EPS, "get_eps", VMType::REAL, { }, ExtFuncDecl::ALWAYS },
+
+	{ ExtFunc::TO_STRING, "to_string", VMType::STR, { }, ExtFuncDecl::NONE },
+	{ ExtFunc::STRLEN, "strlen", VMType::INT, { VMType::STR }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::WRITE, "write", VMType::UNKNOWN, { VMType::STR }, ExtFuncDecl::OPTIONAL },
+	{ ExtFunc::WRITE_NO_CR, "write_no_cr", VMType::UNKNOWN, { VMType::STR }, ExtFuncDecl::OPTIONAL },
+	{ ExtFunc::PRINT, "print", VMType::UNKNOWN, { }, ExtFuncDecl::ALWAYS, true },
+	{ ExtFunc::READ_REAL, "read_real", VMType::REAL, { VMType::STR }, ExtFuncDecl::OPTIONAL },
+	{ ExtFunc::READ_INTEGER, "read_integer", VMType::INT, { VMType::STR }, ExtFuncDecl::OPTIONAL },
+
+	{ ExtFunc::SET_ISR, "set_isr", VMType::UNKNOWN, { VMType::INT, VMType::ADDR_MEM }, ExtFuncDecl::NONE },
+	{ ExtFunc::SLEEP, "sleep", VMType::UNKNOWN, { VMType::INT }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::SET_TIMER, "set_timer", VMType::UNKNOWN, { VMType::INT }, ExtFuncDecl::ALWAYS },
+	{ ExtFunc::SET_DEBUG, "set_debug", VMType::UNKNOWN, { VMType::INT }, ExtFuncDecl::ALWAYS },
+}};
+
+
+/**
+ * find a native function by its name
+ */
+constexpr const ExtFuncInfo* get_vm_ext_func(std::string_view name)
+{
+	for(const ExtFuncInfo& func : g_vm_ext_funcs)
+	{
+		if(func.name == name)
+			return &func;
+	}
+
+	return nullptr;
+}
+
+
+/**
+ * find a native function by its id
+ */
+constexpr const ExtFuncInfo* get_vm_ext_func(ExtFunc id)
+{
+	for(const ExtFuncInfo& func : g_vm_ext_funcs)
+	{
+		if(func.id == id)
+			return &func;
+	}
+
+	return nullptr;
+}
+
+
+#endif
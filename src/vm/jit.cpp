@@ -0,0 +1,1345 @@
+/**
+ * zero-address code vm, x86-64 template jit compiler
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ *
+ * The native code works directly on the vm's memory and keeps the stack
+ * layout of the interpreter, so that it can hand over to the interpreter
+ * at every instruction boundary. Instructions without a native template
+ * or operands of unexpected types leave the native code and let the
+ * interpreter continue at the current instruction.
+ *
+ * Register usage of the native code:
+ *   rbx: vm memory, r12: sp, r13: bp, r14: gbp, r15: JitState,
+ *   rax, rcx, rdx, rsi, rdi, r8, xmm0 - xmm1: scratch registers.
+ */
+
+#include "vm.h"
+#include "jit.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+
+#if VM_JIT != 0
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+
+#if VM_JIT != 0
+
+// ----------------------------------------------------------------------------
+// x86-64 machine code emitter
+// ----------------------------------------------------------------------------
+enum JitReg : t_vm_byte
+{
+	RAX = 0, RCX = 1, RDX = 2, RBX = 3,
+	RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+	R8 = 8, R9 = 9, R10 = 10, R11 = 11,
+	R12 = 12, R13 = 13, R14 = 14, R15 = 15,
+};
+
+
+enum JitXmm : t_vm_byte
+{
+	XMM0 = 0, XMM1 = 1,
+};
+
+
+enum JitCond : t_vm_byte
+{
+	CC_B = 0x2, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5,
+	CC_BE = 0x6, CC_A = 0x7, CC_L = 0xc, CC_GE = 0xd,
+	CC_LE = 0xe, CC_G = 0xf,
+};
+
+
+// the condition codes come in pairs differing in the lowest bit
+static inline JitCond negate_cond(JitCond cc)
+{
+	return static_cast<JitCond>(cc ^ 1);
+}
+
+
+// registers holding the vm state
+static constexpr const JitReg REG_SP = R12;
+static constexpr const JitReg REG_BP = R13;
+static constexpr const JitReg REG_GBP = R14;
+static constexpr const JitReg REG_STATE = R15;
+
+
+/**
+ * emits x86-64 machine code, vm memory operands are addressed as [rbx + reg + disp]
+ */
+class JitAsm
+{
+public:
+	using t_label = std::size_t;
+
+
+	const std::vector<t_vm_byte>& GetCode() const { return m_code; }
+
+	t_label NewLabel()
+	{
+		m_labels.push_back(std::nullopt);
+		return m_labels.size() - 1;
+	}
+
+	void Bind(t_label label) { m_labels[label] = m_code.size(); }
+	bool IsBound(t_label label) const { return m_labels[label].has_value(); }
+	std::size_t GetLabelPos(t_label label) const { return *m_labels[label]; }
+
+	/**
+	 * resolve the relative addresses of jumps and calls
+	 */
+	void Link()
+	{
+		for(const auto& [pos, label] : m_fixups)
+		{
+			if(!IsBound(label))
+				throw std::runtime_error("Jit: Unbound label.");
+
+			std::int32_t rel = static_cast<std::int32_t>(
+				GetLabelPos(label) - (pos + sizeof(std::int32_t)));
+			std::memcpy(m_code.data() + pos, &rel, sizeof(rel));
+		}
+	}
+
+	// ------------------------------------------------------------------------
+	// raw data
+	// ------------------------------------------------------------------------
+	void Byte(t_vm_byte b) { m_code.push_back(b); }
+
+	void Int32(std::int32_t val)
+	{
+		const t_vm_byte* bytes = reinterpret_cast<const t_vm_byte*>(&val);
+		m_code.insert(m_code.end(), bytes, bytes + sizeof(val));
+	}
+
+	void Int64(std::int64_t val)
+	{
+		const t_vm_byte* bytes = reinterpret_cast<const t_vm_byte*>(&val);
+		m_code.insert(m_code.end(), bytes, bytes + sizeof(val));
+	}
+	// ------------------------------------------------------------------------
+
+	// ------------------------------------------------------------------------
+	// instruction encodings
+	// ------------------------------------------------------------------------
+	/**
+	 * instruction with the operand [rbx + index + disp32]
+	 */
+	void InstrMem(t_vm_byte prefix, bool w, std::initializer_list<t_vm_byte> ops,
+		t_vm_byte reg, JitReg index, std::int32_t disp)
+	{
+		if(prefix)
+			Byte(prefix);
+		Rex(w, reg, index, RBX);
+		for(t_vm_byte op : ops)
+			Byte(op);
+		Byte(0x80 | ((reg & 7) << 3) | 0x04);       // modrm: disp32, sib
+		Byte(((index & 7) << 3) | (RBX & 7));        // sib: index, base
+		Int32(disp);
+	}
+
+	/**
+	 * instruction with register operands
+	 */
+	void InstrReg(t_vm_byte prefix, bool w, std::initializer_list<t_vm_byte> ops,
+		t_vm_byte reg, t_vm_byte rm)
+	{
+		if(prefix)
+			Byte(prefix);
+		Rex(w, reg, 0, rm);
+		for(t_vm_byte op : ops)
+			Byte(op);
+		Byte(0xc0 | ((reg & 7) << 3) | (rm & 7));
+	}
+
+	/**
+	 * instruction with the operand [base + disp32], base must not be rsp, r12
+	 */
+	void InstrBase(t_vm_byte prefix, bool w, std::initializer_list<t_vm_byte> ops,
+		t_vm_byte reg, JitReg base, std::int32_t disp)
+	{
+		if(prefix)
+			Byte(prefix);
+		Rex(w, reg, 0, base);
+		for(t_vm_byte op : ops)
+			Byte(op);
+		Byte(0x80 | ((reg & 7) << 3) | (base & 7));
+		Int32(disp);
+	}
+	// ------------------------------------------------------------------------
+
+	// ------------------------------------------------------------------------
+	// vm memory accesses
+	// ------------------------------------------------------------------------
+	void Load64(JitReg reg, JitReg idx, std::int32_t disp) { InstrMem(0, true, {0x8b}, reg, idx, disp); }
+	void Load32s(JitReg reg, JitReg idx, std::int32_t disp) { InstrMem(0, true, {0x63}, reg, idx, disp); }
+	void Load16(JitReg reg, JitReg idx, std::int32_t disp) { InstrMem(0, false, {0x0f, 0xb7}, reg, idx, disp); }
+	void Load8(JitReg reg, JitReg idx, std::int32_t disp) { InstrMem(0, false, {0x0f, 0xb6}, reg, idx, disp); }
+	void Store64(JitReg idx, std::int32_t disp, JitReg reg) { InstrMem(0, true, {0x89}, reg, idx, disp); }
+	void Store32(JitReg idx, std::int32_t disp, JitReg reg) { InstrMem(0, false, {0x89}, reg, idx, disp); }
+	void Store16(JitReg idx, std::int32_t disp, JitReg reg) { InstrMem(0x66, false, {0x89}, reg, idx, disp); }
+	void Store8(JitReg idx, std::int32_t disp, JitReg reg) { InstrMem(0, false, {0x88}, reg, idx, disp); }
+	void LoadSd(JitXmm reg, JitReg idx, std::int32_t disp) { InstrMem(0xf2, false, {0x0f, 0x10}, reg, idx, disp); }
+	void StoreSd(JitReg idx, std::int32_t disp, JitXmm reg) { InstrMem(0xf2, false, {0x0f, 0x11}, reg, idx, disp); }
+
+	void StoreImm8(JitReg idx, std::int32_t disp, t_vm_byte imm)
+	{
+		InstrMem(0, false, {0xc6}, 0, idx, disp);
+		Byte(imm);
+	}
+
+	void StoreImm32(JitReg idx, std::int32_t disp, std::int32_t imm)
+	{
+		InstrMem(0, false, {0xc7}, 0, idx, disp);
+		Int32(imm);
+	}
+
+	void CmpImm8(JitReg idx, std::int32_t disp, t_vm_byte imm)
+	{
+		InstrMem(0, false, {0x80}, 7, idx, disp);
+		Byte(imm);
+	}
+	// ------------------------------------------------------------------------
+
+	// ------------------------------------------------------------------------
+	// register operations
+	// ------------------------------------------------------------------------
+	void Mov(JitReg dst, JitReg src) { InstrReg(0, true, {0x89}, src, dst); }
+	void Add(JitReg dst, JitReg src) { InstrReg(0, true, {0x01}, src, dst); }
+	void Sub(JitReg dst, JitReg src) { InstrReg(0, true, {0x29}, src, dst); }
+	void Cmp(JitReg a, JitReg b) { InstrReg(0, true, {0x39}, b, a); }
+	void Test(JitReg a, JitReg b) { InstrReg(0, true, {0x85}, b, a); }
+	void Imul(JitReg dst, JitReg src) { InstrReg(0, true, {0x0f, 0xaf}, dst, src); }
+	void Idiv(JitReg src) { InstrReg(0, true, {0xf7}, 7, src); }
+	void Neg(JitReg reg) { InstrReg(0, true, {0xf7}, 3, reg); }
+	void Xor32(JitReg reg) { InstrReg(0, false, {0x31}, reg, reg); }
+	void Setcc(JitCond cc, JitReg reg) { InstrReg(0, false, {0x0f, t_vm_byte(0x90 | cc)}, 0, reg); }
+	void Btc(JitReg reg, t_vm_byte bit) { InstrReg(0, true, {0x0f, 0xba}, 7, reg); Byte(bit); }
+	void Btr(JitReg reg, t_vm_byte bit) { InstrReg(0, true, {0x0f, 0xba}, 6, reg); Byte(bit); }
+
+	// sign extension of rax into rdx
+	void Cqo() { Byte(0x48); Byte(0x99); }
+
+	void AddImm(JitReg reg, std::int32_t imm) { InstrReg(0, true, {0x81}, 0, reg); Int32(imm); }
+	void SubImm(JitReg reg, std::int32_t imm) { InstrReg(0, true, {0x81}, 5, reg); Int32(imm); }
+	void CmpImm(JitReg reg, std::int32_t imm) { InstrReg(0, true, {0x81}, 7, reg); Int32(imm); }
+	void CmpAlImm(t_vm_byte imm) { Byte(0x3c); Byte(imm); }
+
+	void MovImm64(JitReg reg, std::int64_t imm)
+	{
+		Rex(true, 0, 0, reg);
+		Byte(0xb8 + (reg & 7));
+		Int64(imm);
+	}
+
+	void MovImm32(JitReg reg, std::int32_t imm)
+	{
+		Rex(false, 0, 0, reg);
+		Byte(0xb8 + (reg & 7));
+		Int32(imm);
+	}
+	// ------------------------------------------------------------------------
+
+	// ------------------------------------------------------------------------
+	// floating point operations
+	// ------------------------------------------------------------------------
+	void AddSd(JitXmm dst, JitXmm src) { InstrReg(0xf2, false, {0x0f, 0x58}, dst, src); }
+	void MulSd(JitXmm dst, JitXmm src) { InstrReg(0xf2, false, {0x0f, 0x59}, dst, src); }
+	void SubSd(JitXmm dst, JitXmm src) { InstrReg(0xf2, false, {0x0f, 0x5c}, dst, src); }
+	void DivSd(JitXmm dst, JitXmm src) { InstrReg(0xf2, false, {0x0f, 0x5e}, dst, src); }
+	void Ucomisd(JitXmm a, JitXmm b) { InstrReg(0x66, false, {0x0f, 0x2e}, a, b); }
+	void Cvtsi2sd(JitXmm dst, JitReg src) { InstrReg(0xf2, true, {0x0f, 0x2a}, dst, src); }
+	void Cvttsd2si(JitReg dst, JitXmm src) { InstrReg(0xf2, true, {0x0f, 0x2c}, dst, src); }
+	void MovqToReg(JitReg dst, JitXmm src) { InstrReg(0x66, true, {0x0f, 0x7e}, src, dst); }
+	void MovqToXmm(JitXmm dst, JitReg src) { InstrReg(0x66, true, {0x0f, 0x6e}, dst, src); }
+	// ------------------------------------------------------------------------
+
+	// ------------------------------------------------------------------------
+	// jit state accesses
+	// ------------------------------------------------------------------------
+	void LoadState(JitReg reg, std::int32_t offs) { InstrBase(0, true, {0x8b}, reg, REG_STATE, offs); }
+	void StoreState(std::int32_t offs, JitReg reg) { InstrBase(0, true, {0x89}, reg, REG_STATE, offs); }
+
+	void StoreStateImm(std::int32_t offs, std::int32_t imm)
+	{
+		InstrBase(0, true, {0xc7}, 0, REG_STATE, offs);
+		Int32(imm);
+	}
+
+	// cmp dword [rax], 0
+	void CmpDerefRaxZero() { Byte(0x83); Byte(0x38); Byte(0x00); }
+
+	// movsd xmm, [rax]
+	void LoadSdDerefRax(JitXmm reg)
+	{
+		Byte(0xf2);
+		Rex(false, reg, 0, RAX);
+		Byte(0x0f); Byte(0x10);
+		Byte(((reg & 7) << 3) | (RAX & 7));
+	}
+	// ------------------------------------------------------------------------
+
+	// ------------------------------------------------------------------------
+	// control flow
+	// ------------------------------------------------------------------------
+	void Jcc(JitCond cc, t_label label)
+	{
+		Byte(0x0f);
+		Byte(0x80 | cc);
+		Fixup(label);
+	}
+
+	void Jmp(t_label label)
+	{
+		Byte(0xe9);
+		Fixup(label);
+	}
+
+	void Call(t_label label)
+	{
+		Byte(0xe8);
+		Fixup(label);
+	}
+
+	void CallAbs(const void* addr)
+	{
+		MovImm64(RAX, reinterpret_cast<std::int64_t>(addr));
+		InstrReg(0, false, {0xff}, 2, RAX);
+	}
+
+	void Ret() { Byte(0xc3); }
+
+	void Push(JitReg reg)
+	{
+		if(reg >= R8)
+			Byte(0x41);
+		Byte(0x50 + (reg & 7));
+	}
+
+	void Pop(JitReg reg)
+	{
+		if(reg >= R8)
+			Byte(0x41);
+		Byte(0x58 + (reg & 7));
+	}
+	// ------------------------------------------------------------------------
+
+
+protected:
+	void Rex(bool w, t_vm_byte reg, t_vm_byte index, t_vm_byte base)
+	{
+		Byte(0x40 | (w << 3) | (((reg >> 3) & 1) << 2)
+			| (((index >> 3) & 1) << 1) | ((base >> 3) & 1));
+	}
+
+	void Fixup(t_label label)
+	{
+		m_fixups.emplace_back(m_code.size(), label);
+		Int32(0);
+	}
+
+
+private:
+	std::vector<t_vm_byte> m_code{};
+	std::vector<std::optional<std::size_t>> m_labels{};
+	std::vector<std::pair<std::size_t, t_label>> m_fixups{};
+};
+// ----------------------------------------------------------------------------
+
+
+/**
+ * functions that are compiled together into one code buffer
+ */
+struct JitBatch
+{
+	JitAsm as{};
+
+	// entry labels of the functions in the batch
+	std::unordered_map<VM::t_addr, JitAsm::t_label> funcs{};
+
+	// functions still to be emitted: entry and end address
+	std::vector<std::pair<VM::t_addr, VM::t_addr>> pending{};
+};
+
+
+/**
+ * copies the code into executable memory
+ */
+JitCode::JitCode(const std::vector<t_vm_byte>& code)
+{
+	const std::size_t pagesize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+	m_size = (code.size() + pagesize - 1) / pagesize * pagesize;
+
+	void* mem = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(mem == MAP_FAILED)
+		throw std::runtime_error("Jit: Cannot allocate code memory.");
+
+	std::memcpy(mem, code.data(), code.size());
+	if(::mprotect(mem, m_size, PROT_READ | PROT_EXEC) != 0)
+	{
+		::munmap(mem, m_size);
+		throw std::runtime_error("Jit: Cannot make code memory executable.");
+	}
+
+	m_mem = static_cast<t_vm_byte*>(mem);
+}
+
+
+JitCode::~JitCode()
+{
+	if(m_mem)
+		::munmap(m_mem, m_size);
+}
+
+
+/**
+ * generates the code entering the native functions:
+ * int enter(JitState* state, const void* func)
+ */
+static std::vector<t_vm_byte> jit_enter_code()
+{
+	JitAsm as;
+
+	// save callee-saved registers, keeping the stack 16-byte aligned
+	for(JitReg reg : { RBX, RBP, R12, R13, R14, R15 })
+		as.Push(reg);
+	as.SubImm(RSP, 8);
+
+	// load the vm registers
+	as.Mov(REG_STATE, RDI);
+	as.LoadState(RBX, offsetof(JitState, mem));
+	as.LoadState(REG_SP, offsetof(JitState, sp));
+	as.LoadState(REG_BP, offsetof(JitState, bp));
+	as.LoadState(REG_GBP, offsetof(JitState, gbp));
+
+	// call native function: call rsi
+	as.InstrReg(0, false, {0xff}, 2, RSI);
+
+	// write back the vm registers, the instruction
+	// pointer has been set by the native code
+	as.StoreState(offsetof(JitState, sp), REG_SP);
+	as.StoreState(offsetof(JitState, bp), REG_BP);
+
+	as.AddImm(RSP, 8);
+	for(JitReg reg : { R15, R14, R13, R12, RBP, RBX })
+		as.Pop(reg);
+	as.Ret();
+
+	as.Link();
+	return as.GetCode();
+}
+
+#endif  // VM_JIT
+
+
+
+/**
+ * removes all generated code, e.g. after the program has been changed
+ */
+void VM::ClearNativeCode()
+{
+#if VM_JIT != 0
+	m_native_funcs.clear();
+	m_native_calls.clear();
+	m_native_code.clear();
+#endif
+}
+
+
+/**
+ * runs the function at the given address natively if it is hot,
+ * the function's stack frame has already been set up
+ */
+void VM::RunNative([[maybe_unused]] t_addr funcaddr)
+{
+#if VM_JIT != 0
+	// the native code does not zero popped values
+	if(m_zeropoppedvals)
+		return;
+
+	const void* func = GetNativeFunc(funcaddr);
+	if(!func)
+		return;
+
+	if(!m_native_enter.GetCode())
+		m_native_enter = JitCode(jit_enter_code());
+
+	JitState state
+	{
+		.mem = m_mem.get(),
+		.sp = m_sp, .bp = m_bp, .gbp = m_gbp, .ip = m_ip,
+		.irqs = &m_irqs,
+		.eps = &m_eps,
+	};
+
+	t_jit_enter enter = reinterpret_cast<t_jit_enter>(
+		const_cast<t_byte*>(m_native_enter.GetCode()));
+	enter(&state, func);
+
+	m_sp = static_cast<t_addr>(state.sp);
+	m_bp = static_cast<t_addr>(state.bp);
+	m_ip = static_cast<t_addr>(state.ip);
+#endif
+}
+
+
+#if VM_JIT != 0
+
+/**
+ * get the native code of a function, compiles it once it is hot
+ */
+const void* VM::GetNativeFunc(t_addr funcaddr)
+{
+	if(auto iter = m_native_funcs.find(funcaddr); iter != m_native_funcs.end())
+		return iter->second;
+
+	if(++m_native_calls[funcaddr] < m_jit_hot_calls)
+		return nullptr;
+	m_native_calls.erase(funcaddr);
+
+	CompileNative(funcaddr);
+	return m_native_funcs[funcaddr];
+}
+
+
+/**
+ * find the end of the function at the given address (after its ret instruction)
+ */
+std::optional<VM::t_addr> VM::GetNativeRegion(t_addr funcaddr) const
+{
+	if(m_decoded.empty() || funcaddr < m_code_range[0] || funcaddr >= m_code_range[1])
+		return std::nullopt;
+
+	for(t_addr addr = funcaddr; addr < m_code_range[1];)
+	{
+		const DecodedInstr& instr = m_decoded[addr - m_code_range[0]];
+
+		// not decoded, skip
+		if(instr.op == OpCode::INVALID)
+		{
+			++addr;
+			continue;
+		}
+
+		addr = instr.next_ip;
+		if(instr.op == OpCode::RET || instr.op == OpCode::RETD)
+			return addr;
+	}
+
+	return std::nullopt;
+}
+
+
+/**
+ * compile the function at the given address and the functions it calls
+ */
+void VM::CompileNative(t_addr funcaddr)
+{
+	std::optional<t_addr> funcend = GetNativeRegion(funcaddr);
+	if(!funcend)
+	{
+		m_native_funcs[funcaddr] = nullptr;
+		return;
+	}
+
+	JitBatch batch;
+	batch.funcs.emplace(funcaddr, batch.as.NewLabel());
+	batch.pending.emplace_back(funcaddr, *funcend);
+
+	while(!batch.pending.empty())
+	{
+		auto [entry, end] = batch.pending.back();
+		batch.pending.pop_back();
+
+		EmitNativeFunc(batch, entry, end);
+	}
+
+	batch.as.Link();
+	const JitCode& code = m_native_code.emplace_back(batch.as.GetCode());
+
+	for(const auto& [entry, label] : batch.funcs)
+		m_native_funcs[entry] = code.GetCode() + batch.as.GetLabelPos(label);
+
+	if(m_debug)
+	{
+		std::cout << "Compiled " << batch.funcs.size() << " function(s) at address "
+			<< funcaddr << " to " << batch.as.GetCode().size()
+			<< " bytes of native code." << std::endl;
+	}
+}
+
+
+/**
+ * emit the native code for a function
+ */
+void VM::EmitNativeFunc(JitBatch& batch, t_addr funcaddr, t_addr funcend)
+{
+	JitAsm& as = batch.as;
+
+	using t_label = JitAsm::t_label;
+	constexpr const t_byte ty_int = static_cast<t_byte>(VMType::INT);
+	constexpr const t_byte ty_real = static_cast<t_byte>(VMType::REAL);
+	constexpr const t_byte ty_bool = static_cast<t_byte>(VMType::BOOL);
+	constexpr const t_byte ty_addr = static_cast<t_byte>(VMType::ADDR_MEM);
+
+	// sizes including the type descriptor
+	constexpr const t_addr size_scalar = m_bytesize + sizeof(t_int);
+	constexpr const t_addr size_bool = m_bytesize + sizeof(t_bool);
+	constexpr const t_addr size_addr = m_bytesize + m_addrsize;
+
+	// test the variable accesses if neither the guard pages
+	// nor disabled memory checks make the tests unnecessary
+	const bool checks = m_checks && !m_mem.IsGuarded();
+
+	// labels of the native code of the instructions
+	std::unordered_map<t_addr, t_label> instr_labels;
+	// labels of the code leaving to the interpreter at the given address
+	std::unordered_map<t_addr, t_label> exit_labels;
+	// labels of the interrupt tests before backward jumps
+	std::unordered_map<t_addr, t_label> loop_labels;
+
+	auto get_label = [&as](std::unordered_map<t_addr, t_label>& labels, t_addr addr) -> t_label
+	{
+		if(auto iter = labels.find(addr); iter != labels.end())
+			return iter->second;
+		t_label label = as.NewLabel();
+		labels.emplace(addr, label);
+		return label;
+	};
+
+	// jump target, backward jumps test for interrupts first
+	auto jump_label = [&](t_addr from, t_addr target) -> t_label
+	{
+		if(target <= from)
+			return get_label(loop_labels, target);
+		return get_label(instr_labels, target);
+	};
+
+	// leave to the interpreter if an interrupt is pending
+	auto emit_irq_test = [&as](t_label exit)
+	{
+		as.LoadState(RAX, offsetof(JitState, irqs));
+		as.CmpDerefRaxZero();
+		as.Jcc(CC_NE, exit);
+	};
+
+	// get the int and real paths of typed and untyped operations
+	auto get_types = [](OpCode op) -> std::pair<bool, bool>
+	{
+		switch(op)
+		{
+			case OpCode::ADD_I: case OpCode::SUB_I: case OpCode::MUL_I: case OpCode::DIV_I:
+			case OpCode::GT_I: case OpCode::LT_I: case OpCode::GEQU_I:
+			case OpCode::LEQU_I: case OpCode::EQU_I: case OpCode::NEQU_I:
+				return std::make_pair(true, false);
+			case OpCode::ADD_R: case OpCode::SUB_R: case OpCode::MUL_R: case OpCode::DIV_R:
+			case OpCode::GT_R: case OpCode::LT_R: case OpCode::GEQU_R:
+			case OpCode::LEQU_R: case OpCode::EQU_R: case OpCode::NEQU_R:
+				return std::make_pair(false, true);
+			default:
+				return std::make_pair(true, true);
+		}
+	};
+
+	// get the comparison operation of typed, untyped and fused instructions
+	auto get_comparison = [](OpCode op) -> OpCode
+	{
+		switch(op)
+		{
+			case OpCode::GT_I: case OpCode::GT_R: case OpCode::JMPNOTGT: return OpCode::GT;
+			case OpCode::LT_I: case OpCode::LT_R: case OpCode::JMPNOTLT: return OpCode::LT;
+			case OpCode::GEQU_I: case OpCode::GEQU_R: case OpCode::JMPNOTGEQU: return OpCode::GEQU;
+			case OpCode::LEQU_I: case OpCode::LEQU_R: case OpCode::JMPNOTLEQU: return OpCode::LEQU;
+			case OpCode::EQU_I: case OpCode::EQU_R: case OpCode::JMPNOTEQU: return OpCode::EQU;
+			case OpCode::NEQU_I: case OpCode::NEQU_R: case OpCode::JMPNOTNEQU: return OpCode::NEQU;
+			default: return op;
+		}
+	};
+
+	// branches on the type descriptor in al: 9-byte scalars and bools, else exit
+	auto emit_scalar_switch = [&as](t_label scalar, t_label boolean, t_label exit)
+	{
+		as.CmpAlImm(ty_int);
+		as.Jcc(CC_E, scalar);
+		as.CmpAlImm(ty_real);
+		as.Jcc(CC_E, scalar);
+		as.CmpAlImm(ty_bool);
+		as.Jcc(CC_E, boolean);
+		as.Jmp(exit);
+	};
+
+	// leave to the interpreter if the memory at [base + disp, base + disp + size)
+	// is not between the code and the end of the memory, see CheckMemoryBounds()
+	auto emit_bounds_test = [&](JitReg base, t_addr disp, t_addr size, t_label exit)
+	{
+		if(!checks)
+			return;
+
+		as.Mov(RDX, base);
+		as.AddImm(RDX, static_cast<std::int32_t>(disp));
+		as.CmpImm(RDX, static_cast<std::int32_t>(m_code_range[1]));
+		as.Jcc(CC_L, exit);
+		as.AddImm(RDX, static_cast<std::int32_t>(size));
+		as.MovImm64(RSI, m_memsize);
+		as.Cmp(RDX, RSI);
+		as.Jcc(CC_G, exit);
+	};
+
+	// variable addresses that are out of bounds for every base pointer
+	// or that do not fit into the displacement are left to the interpreter
+	auto is_valid_disp = [this](t_addr disp) -> bool
+	{
+		constexpr const t_addr max_disp = std::numeric_limits<std::int32_t>::max() - size_scalar;
+		return disp >= -std::min(m_memsize, max_disp) && disp <= std::min(m_memsize, max_disp);
+	};
+
+	// copies a scalar from memory at [base + disp] onto the stack
+	auto emit_load = [&](JitReg base, t_addr disp, t_label exit)
+	{
+		if(!is_valid_disp(disp))
+		{
+			as.Jmp(exit);
+			return;
+		}
+
+		t_label scalar = as.NewLabel(), boolean = as.NewLabel(), done = as.NewLabel();
+
+		emit_bounds_test(base, disp, size_bool, exit);
+		as.Load8(RAX, base, disp);
+		emit_scalar_switch(scalar, boolean, exit);
+
+		as.Bind(boolean);
+		as.Load8(RCX, base, disp + m_bytesize);
+		as.SubImm(REG_SP, size_bool);
+		as.Store8(REG_SP, 0, RAX);
+		as.Store8(REG_SP, m_bytesize, RCX);
+		as.Jmp(done);
+
+		as.Bind(scalar);
+		emit_bounds_test(base, disp, size_scalar, exit);
+		as.Load64(RCX, base, disp + m_bytesize);
+		as.SubImm(REG_SP, size_scalar);
+		as.Store8(REG_SP, 0, RAX);
+		as.Store64(REG_SP, m_bytesize, RCX);
+
+		as.Bind(done);
+	};
+
+	// moves a scalar from the stack to memory at [base + disp]
+	auto emit_store = [&](JitReg base, t_addr disp, t_label exit)
+	{
+		if(!is_valid_disp(disp))
+		{
+			as.Jmp(exit);
+			return;
+		}
+
+		t_label scalar = as.NewLabel(), boolean = as.NewLabel(), done = as.NewLabel();
+
+		as.Load8(RAX, REG_SP, 0);
+		emit_scalar_switch(scalar, boolean, exit);
+
+		as.Bind(boolean);
+		emit_bounds_test(base, disp, size_bool, exit);
+		as.Load8(RCX, REG_SP, m_bytesize);
+		as.Store8(base, disp, RAX);
+		as.Store8(base, disp + m_bytesize, RCX);
+		as.AddImm(REG_SP, size_bool);
+		as.Jmp(done);
+
+		as.Bind(scalar);
+		emit_bounds_test(base, disp, size_scalar, exit);
+		as.Load64(RCX, REG_SP, m_bytesize);
+		as.Store8(base, disp, RAX);
+		as.Store64(base, disp + m_bytesize, RCX);
+		as.AddImm(REG_SP, size_scalar);
+
+		as.Bind(done);
+	};
+
+	// tests the type descriptors of the two values on top of the stack
+	auto emit_type_test = [&as](t_byte ty, t_label other)
+	{
+		as.CmpImm8(REG_SP, 0, ty);
+		as.Jcc(CC_NE, other);
+		as.CmpImm8(REG_SP, size_scalar, ty);
+		as.Jcc(CC_NE, other);
+	};
+
+	// arithmetic operation on the two ints or reals on top of the stack
+	auto emit_arithmetic = [&](char op, bool ints, bool reals, t_label exit)
+	{
+		t_label done = as.NewLabel();
+		t_label real_path = reals ? as.NewLabel() : exit;
+
+		if(ints)
+		{
+			emit_type_test(ty_int, real_path);
+
+			// stack layout: [descriptor 2] [value 2] [descriptor 1] [value 1]
+			as.Load64(RAX, REG_SP, size_scalar + m_bytesize);
+			as.Load64(RCX, REG_SP, m_bytesize);
+
+			switch(op)
+			{
+				case '+': as.Add(RAX, RCX); break;
+				case '-': as.Sub(RAX, RCX); break;
+				case '*': as.Imul(RAX, RCX); break;
+				case '/':
+				case '%':
+					// let the interpreter handle divisions by zero
+					as.Test(RCX, RCX);
+					as.Jcc(CC_E, exit);
+					as.Cqo();
+					as.Idiv(RCX);
+					if(op == '%')
+						as.Mov(RAX, RDX);
+					break;
+			}
+
+			as.AddImm(REG_SP, size_scalar);
+			as.Store64(REG_SP, m_bytesize, RAX);
+			as.Jmp(done);
+		}
+
+		if(reals)
+		{
+			as.Bind(real_path);
+			emit_type_test(ty_real, exit);
+
+			as.LoadSd(XMM0, REG_SP, size_scalar + m_bytesize);
+			as.LoadSd(XMM1, REG_SP, m_bytesize);
+
+			switch(op)
+			{
+				case '+': as.AddSd(XMM0, XMM1); break;
+				case '-': as.SubSd(XMM0, XMM1); break;
+				case '*': as.MulSd(XMM0, XMM1); break;
+				case '/': as.DivSd(XMM0, XMM1); break;
+				default: as.Jmp(exit); break;
+			}
+
+			as.AddImm(REG_SP, size_scalar);
+			as.StoreSd(REG_SP, m_bytesize, XMM0);
+		}
+
+		as.Bind(done);
+	};
+
+	// compares the two ints or reals on top of the stack and pops them,
+	// the result is passed as condition code to the consumer
+	auto emit_comparison = [&](OpCode cmp, bool ints, bool reals, t_label exit,
+		auto&& consume)
+	{
+		t_label done = as.NewLabel();
+		t_label real_path = reals ? as.NewLabel() : exit;
+
+		if(ints)
+		{
+			emit_type_test(ty_int, real_path);
+
+			as.Load64(RAX, REG_SP, size_scalar + m_bytesize);
+			as.Load64(RCX, REG_SP, m_bytesize);
+			as.AddImm(REG_SP, 2*size_scalar);
+			as.Cmp(RAX, RCX);
+
+			switch(cmp)
+			{
+				case OpCode::GT: consume(CC_G); break;
+				case OpCode::LT: consume(CC_L); break;
+				case OpCode::GEQU: consume(CC_GE); break;
+				case OpCode::LEQU: consume(CC_LE); break;
+				case OpCode::EQU: consume(CC_E); break;
+				default: consume(CC_NE); break;
+			}
+			as.Jmp(done);
+		}
+
+		if(reals)
+		{
+			as.Bind(real_path);
+			emit_type_test(ty_real, exit);
+
+			as.LoadSd(XMM0, REG_SP, size_scalar + m_bytesize);
+			as.LoadSd(XMM1, REG_SP, m_bytesize);
+			as.AddImm(REG_SP, 2*size_scalar);
+
+			// the conditions "above" and "above or equal" are false for nans
+			switch(cmp)
+			{
+				case OpCode::GT: as.Ucomisd(XMM0, XMM1); consume(CC_A); break;
+				case OpCode::LT: as.Ucomisd(XMM1, XMM0); consume(CC_A); break;
+				case OpCode::GEQU: as.Ucomisd(XMM0, XMM1); consume(CC_AE); break;
+				case OpCode::LEQU: as.Ucomisd(XMM1, XMM0); consume(CC_AE); break;
+				default:
+				{
+					// |val1 - val2| compared to epsilon
+					as.SubSd(XMM0, XMM1);
+					as.MovqToReg(RAX, XMM0);
+					as.Btr(RAX, 63);
+					as.MovqToXmm(XMM0, RAX);
+					as.LoadState(RAX, offsetof(JitState, eps));
+					as.LoadSdDerefRax(XMM1);
+
+					if(cmp == OpCode::EQU)
+					{
+						as.Ucomisd(XMM1, XMM0);
+						consume(CC_AE);
+					}
+					else
+					{
+						as.Ucomisd(XMM0, XMM1);
+						consume(CC_A);
+					}
+					break;
+				}
+			}
+		}
+
+		as.Bind(done);
+	};
+
+	// pops a bool or an int and jumps if it is (not) zero
+	auto emit_bool_jump = [&](JitCond cc, t_label target, t_label exit)
+	{
+		t_label int_path = as.NewLabel(), done = as.NewLabel();
+
+		as.Load8(RAX, REG_SP, 0);
+		as.CmpAlImm(ty_bool);
+		as.Jcc(CC_NE, int_path);
+		as.Load8(RCX, REG_SP, m_bytesize);
+		as.AddImm(REG_SP, size_bool);
+		as.Test(RCX, RCX);
+		as.Jcc(cc, target);
+		as.Jmp(done);
+
+		as.Bind(int_path);
+		as.CmpAlImm(ty_int);
+		as.Jcc(CC_NE, exit);
+		as.Load64(RCX, REG_SP, m_bytesize);
+		as.AddImm(REG_SP, size_scalar);
+		as.Test(RCX, RCX);
+		as.Jcc(cc, target);
+
+		as.Bind(done);
+	};
+
+	// pushes an address to the stack
+	auto emit_push_addr = [&as](JitReg reg)
+	{
+		as.SubImm(REG_SP, size_addr);
+		as.StoreImm8(REG_SP, 0, ty_addr);
+		if constexpr(m_addrsize == 4)
+			as.Store32(REG_SP, m_bytesize, reg);
+		else
+			as.Store64(REG_SP, m_bytesize, reg);
+	};
+
+	// reads an absolute address from memory at [base + disp]
+	auto emit_read_addr = [&as](JitReg reg, JitReg base, t_addr disp, t_label exit)
+	{
+		as.CmpImm8(base, disp, ty_addr);
+		as.Jcc(CC_NE, exit);
+		if constexpr(m_addrsize == 4)
+			as.Load32s(reg, base, disp + m_bytesize);
+		else
+			as.Load64(reg, base, disp + m_bytesize);
+	};
+
+	// the interpreter handles values that are not scalars or bools
+	auto emit_scalar_size = [&as](JitReg size, JitReg idx, t_label exit)
+	{
+		t_label scalar = as.NewLabel(), done = as.NewLabel();
+
+		as.Load8(RAX, idx, 0);
+		as.CmpAlImm(ty_int);
+		as.Jcc(CC_E, scalar);
+		as.CmpAlImm(ty_real);
+		as.Jcc(CC_E, scalar);
+		as.CmpAlImm(ty_bool);
+		as.Jcc(CC_NE, exit);
+		as.MovImm32(size, size_bool);
+		as.Jmp(done);
+
+		as.Bind(scalar);
+		as.MovImm32(size, size_scalar);
+		as.Bind(done);
+	};
+
+	// maximum growth of the stack within the function
+	t_addr stack_growth = 0;
+	for(t_addr addr = funcaddr; addr < funcend;)
+	{
+		const DecodedInstr& instr = m_decoded[addr - m_code_range[0]];
+		if(instr.op == OpCode::INVALID)
+		{
+			++addr;
+			continue;
+		}
+
+		switch(instr.op)
+		{
+			case OpCode::PUSHD: stack_growth += instr.data_size; break;
+			case OpCode::LOADLOCAL: case OpCode::LOADGLOBAL: stack_growth += size_scalar; break;
+			case OpCode::ADDFRAMED: stack_growth += static_cast<t_addr>(instr.framesize); break;
+			case OpCode::CALLD: stack_growth += 2*size_addr; break;
+			default: break;
+		}
+
+		addr = instr.next_ip;
+	}
+
+	// function entry: leave to the interpreter if an interrupt is
+	// pending or if the stack could grow into the code
+	as.Bind(batch.funcs.at(funcaddr));
+	{
+		t_label exit = get_label(exit_labels, funcaddr);
+		emit_irq_test(exit);
+
+		as.Mov(RAX, REG_SP);
+		as.SubImm(RAX, stack_growth);
+		as.CmpImm(RAX, m_code_range[1]);
+		as.Jcc(CC_L, exit);
+	}
+
+	// translate the instructions
+	for(t_addr addr = funcaddr; addr < funcend;)
+	{
+		const DecodedInstr& instr = m_decoded[addr - m_code_range[0]];
+		if(instr.op == OpCode::INVALID)
+		{
+			as.Bind(get_label(instr_labels, addr));
+			as.Jmp(get_label(exit_labels, addr));
+			++addr;
+			continue;
+		}
+
+		as.Bind(get_label(instr_labels, addr));
+		t_label exit = get_label(exit_labels, addr);
+		auto [ints, reals] = get_types(instr.op);
+
+		switch(instr.op)
+		{
+			case OpCode::NOP:
+				break;
+
+			case OpCode::PUSHD:
+			{
+				// copy the direct data from the code
+				as.SubImm(REG_SP, instr.data_size);
+
+				t_addr offs = 0;
+				for(; offs + 4 <= instr.data_size; offs += 4)
+				{
+					std::int32_t val{};
+					std::memcpy(&val, m_mem.get() + instr.data_addr + offs, sizeof(val));
+					as.StoreImm32(REG_SP, offs, val);
+				}
+				for(; offs < instr.data_size; ++offs)
+					as.StoreImm8(REG_SP, offs, m_mem[instr.data_addr + offs]);
+				break;
+			}
+
+			case OpCode::LOADLOCAL:
+				emit_load(REG_BP, instr.var_addr, exit);
+				break;
+
+			case OpCode::LOADGLOBAL:
+				emit_load(REG_GBP, instr.var_addr, exit);
+				break;
+
+			case OpCode::STORELOCAL:
+				emit_store(REG_BP, instr.var_addr, exit);
+				break;
+
+			case OpCode::STOREGLOBAL:
+				emit_store(REG_GBP, instr.var_addr, exit);
+				break;
+
+			case OpCode::ADD: case OpCode::ADD_I: case OpCode::ADD_R:
+				emit_arithmetic('+', ints, reals, exit);
+				break;
+
+			case OpCode::SUB: case OpCode::SUB_I: case OpCode::SUB_R:
+				emit_arithmetic('-', ints, reals, exit);
+				break;
+
+			case OpCode::MUL: case OpCode::MUL_I: case OpCode::MUL_R:
+				emit_arithmetic('*', ints, reals, exit);
+				break;
+
+			case OpCode::DIV: case OpCode::DIV_I: case OpCode::DIV_R:
+				emit_arithmetic('/', ints, reals, exit);
+				break;
+
+			case OpCode::MOD:
+				emit_arithmetic('%', true, false, exit);
+				break;
+
+			case OpCode::USUB:
+			{
+				t_label int_path = as.NewLabel(), done = as.NewLabel();
+
+				as.Load8(RAX, REG_SP, 0);
+				as.Load64(RCX, REG_SP, m_bytesize);
+				as.CmpAlImm(ty_int);
+				as.Jcc(CC_E, int_path);
+				as.CmpAlImm(ty_real);
+				as.Jcc(CC_NE, exit);
+
+				// flip the sign bit of the real
+				as.Btc(RCX, 63);
+				as.Store64(REG_SP, m_bytesize, RCX);
+				as.Jmp(done);
+
+				as.Bind(int_path);
+				as.Neg(RCX);
+				as.Store64(REG_SP, m_bytesize, RCX);
+				as.Bind(done);
+				break;
+			}
+
+			case OpCode::TOI:
+			{
+				t_label done = as.NewLabel();
+
+				as.Load8(RAX, REG_SP, 0);
+				as.CmpAlImm(ty_int);
+				as.Jcc(CC_E, done);
+				as.CmpAlImm(ty_real);
+				as.Jcc(CC_NE, exit);
+
+				as.LoadSd(XMM0, REG_SP, m_bytesize);
+				as.Cvttsd2si(RCX, XMM0);
+				as.StoreImm8(REG_SP, 0, ty_int);
+				as.Store64(REG_SP, m_bytesize, RCX);
+				as.Bind(done);
+				break;
+			}
+
+			case OpCode::TOR:
+			{
+				t_label done = as.NewLabel();
+
+				as.Load8(RAX, REG_SP, 0);
+				as.CmpAlImm(ty_real);
+				as.Jcc(CC_E, done);
+				as.CmpAlImm(ty_int);
+				as.Jcc(CC_NE, exit);
+
+				as.Load64(RCX, REG_SP, m_bytesize);
+				as.Cvtsi2sd(XMM0, RCX);
+				as.StoreImm8(REG_SP, 0, ty_real);
+				as.StoreSd(REG_SP, m_bytesize, XMM0);
+				as.Bind(done);
+				break;
+			}
+
+			case OpCode::GT: case OpCode::LT: case OpCode::GEQU:
+			case OpCode::LEQU: case OpCode::EQU: case OpCode::NEQU:
+			case OpCode::GT_I: case OpCode::LT_I: case OpCode::GEQU_I:
+			case OpCode::LEQU_I: case OpCode::EQU_I: case OpCode::NEQU_I:
+			case OpCode::GT_R: case OpCode::LT_R: case OpCode::GEQU_R:
+			case OpCode::LEQU_R: case OpCode::EQU_R: case OpCode::NEQU_R:
+			{
+				// push the result as bool
+				emit_comparison(get_comparison(instr.op), ints, reals, exit,
+					[&as](JitCond cc)
+				{
+					as.Setcc(cc, RCX);
+					as.SubImm(REG_SP, size_bool);
+					as.StoreImm8(REG_SP, 0, ty_bool);
+					as.Store8(REG_SP, m_bytesize, RCX);
+				});
+				break;
+			}
+
+			case OpCode::JMPNOTGT: case OpCode::JMPNOTLT: case OpCode::JMPNOTGEQU:
+			case OpCode::JMPNOTLEQU: case OpCode::JMPNOTEQU: case OpCode::JMPNOTNEQU:
+			{
+				t_label target = jump_label(addr, instr.target);
+				emit_comparison(get_comparison(instr.op), true, true, exit,
+					[&as, target](JitCond cc)
+				{
+					as.Jcc(negate_cond(cc), target);
+				});
+				break;
+			}
+
+			case OpCode::JMPIFNOT:
+				emit_bool_jump(CC_E, jump_label(addr, instr.target), exit);
+				break;
+
+			case OpCode::JMPCNDD:
+				emit_bool_jump(CC_NE, jump_label(addr, instr.target), exit);
+				break;
+
+			case OpCode::JMPD:
+				as.Jmp(jump_label(addr, instr.target));
+				break;
+
+			case OpCode::ADDFRAMED:
+				as.SubImm(REG_SP, static_cast<std::int32_t>(instr.framesize));
+				break;
+
+			case OpCode::REMFRAMED:
+				as.AddImm(REG_SP, static_cast<std::int32_t>(instr.framesize));
+				break;
+
+			case OpCode::CALLD:
+			{
+				// get the native code of the called function
+				const void* native_func = nullptr;
+				std::optional<t_label> func_label;
+
+				if(auto iter = m_native_funcs.find(instr.target); iter != m_native_funcs.end())
+				{
+					native_func = iter->second;
+				}
+				else if(auto iter = batch.funcs.find(instr.target); iter != batch.funcs.end())
+				{
+					func_label = iter->second;
+				}
+				else if(std::optional<t_addr> end = GetNativeRegion(instr.target); end)
+				{
+					func_label = as.NewLabel();
+					batch.funcs.emplace(instr.target, *func_label);
+					batch.pending.emplace_back(instr.target, *end);
+				}
+				else
+				{
+					m_native_funcs[instr.target] = nullptr;
+				}
+
+				// let the interpreter call functions without native code
+				if(!native_func && !func_label)
+				{
+					as.Jmp(exit);
+					break;
+				}
+
+				// save instruction and base pointer and set up the stack frame
+				as.MovImm64(RAX, instr.next_ip);
+				emit_push_addr(RAX);
+				emit_push_addr(REG_BP);
+				as.Mov(REG_BP, REG_SP);
+				as.SubImm(REG_SP, static_cast<std::int32_t>(instr.framesize));
+
+				if(func_label)
+					as.Call(*func_label);
+				else
+					as.CallAbs(native_func);
+
+				// the called function has left to the interpreter
+				t_label leave = get_label(exit_labels, -1);
+				as.Test(RAX, RAX);
+				as.Jcc(CC_NE, leave);
+				break;
+			}
+
+			case OpCode::RETD:
+			{
+				// size of the return value
+				t_label no_retval = as.NewLabel();
+				as.Mov(RSI, REG_BP);
+				as.SubImm(RSI, static_cast<std::int32_t>(instr.framesize));
+				as.Sub(RSI, REG_SP);
+				as.Test(RSI, RSI);
+				as.Jcc(CC_E, no_retval);
+				emit_scalar_size(RCX, REG_SP, exit);
+				as.Cmp(RSI, RCX);
+				as.Jcc(CC_NE, exit);
+				as.Bind(no_retval);
+
+				// skip the saved pointers and the function arguments
+				as.Mov(RDX, REG_BP);
+				as.AddImm(RDX, 2*size_addr);
+				for(t_int arg = 0; arg < instr.num_args; ++arg)
+				{
+					emit_scalar_size(RCX, RDX, exit);
+					as.Add(RDX, RCX);
+				}
+
+				// restore instruction and base pointer
+				emit_read_addr(RDI, REG_BP, size_addr, exit);
+				emit_read_addr(R8, REG_BP, 0, exit);
+				as.StoreState(offsetof(JitState, ip), RDI);
+
+				// move the return value in place of the arguments
+				t_label retval_bool = as.NewLabel(), done = as.NewLabel();
+				as.Sub(RDX, RSI);
+				as.CmpImm(RSI, size_scalar);
+				as.Jcc(CC_NE, retval_bool);
+				as.Load64(RAX, REG_SP, 0);
+				as.Load8(RCX, REG_SP, sizeof(std::int64_t));
+				as.Store64(RDX, 0, RAX);
+				as.Store8(RDX, sizeof(std::int64_t), RCX);
+				as.Jmp(done);
+				as.Bind(retval_bool);
+				as.CmpImm(RSI, size_bool);
+				as.Jcc(CC_NE, done);
+				as.Load16(RAX, REG_SP, 0);
+				as.Store16(RDX, 0, RAX);
+				as.Bind(done);
+
+				as.Mov(REG_SP, RDX);
+				as.Mov(REG_BP, R8);
+				as.Xor32(RAX);
+				as.Ret();
+				break;
+			}
+
+			// let the interpreter run all other instructions
+			default:
+				as.Jmp(exit);
+				break;
+		}
+
+		addr = instr.next_ip;
+
+		// fall through to the following instruction
+		if(addr >= funcend)
+			as.Jmp(get_label(instr_labels, addr));
+	}
+
+	// interrupt tests before backward jumps
+	for(const auto& [addr, label] : loop_labels)
+	{
+		as.Bind(label);
+		emit_irq_test(get_label(exit_labels, addr));
+		as.Jmp(get_label(instr_labels, addr));
+	}
+
+	// jumps to instructions without native code leave to the interpreter
+	for(const auto& [addr, label] : instr_labels)
+	{
+		if(!as.IsBound(label))
+		{
+			as.Bind(label);
+			as.Jmp(get_label(exit_labels, addr));
+		}
+	}
+
+	// leave to the interpreter at the given address, the
+	// label at address -1 is used if a called function has left already
+	for(const auto& [addr, label] : exit_labels)
+	{
+		as.Bind(label);
+		if(addr >= 0)
+		{
+			as.StoreStateImm(offsetof(JitState, ip), addr);
+			as.MovImm32(RAX, 1);
+		}
+		as.Ret();
+	}
+}
+
+#endif  // VM_JIT
@@ -0,0 +1,89 @@
+/**
+ * zero-address code vm, x86-64 template jit compiler
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __0ACVM_JIT_H__
+#define __0ACVM_JIT_H__
+
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+#include "types.h"
+
+
+// the jit compiler emits x86-64 code for linux hosts
+// and expects 32 bit vm addresses and the compact value layout
+#if defined(USE_JIT) && defined(__x86_64__) && defined(__linux__) && !defined(USE_ADDR64) && !defined(USE_ALIGNED_STACK)
+	#define VM_JIT 1
+#else
+	#define VM_JIT 0
+#endif
+
+
+
+/**
+ * vm registers and pointers handed over to the native code
+ */
+struct JitState
+{
+	t_vm_byte* mem{nullptr};               // vm memory
+	std::int64_t sp{0};                    // stack pointer
+	std::int64_t bp{0};                    // base pointer
+	std::int64_t gbp{0};                   // global base pointer
+	std::int64_t ip{0};                    // instruction pointer after leaving the native code
+	const void* irqs{nullptr};             // pending interrupt mask (32 bits)
+	const t_vm_real* eps{nullptr};         // epsilon for real comparisons
+};
+
+
+/**
+ * enters the native code, returns 0 if the function returned normally
+ * and 1 if the interpreter has to continue at the instruction pointer
+ */
+using t_jit_enter = int(*)(JitState*, const void*);
+
+
+/**
+ * executable memory holding generated machine code
+ */
+class JitCode
+{
+public:
+	JitCode() = default;
+	JitCode(const std::vector<t_vm_byte>& code);
+	~JitCode();
+
+	JitCode(const JitCode&) = delete;
+	JitCode& operator=(const JitCode&) = delete;
+
+	JitCode(JitCode&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	JitCode& operator=(JitCode&& other) noexcept
+	{
+		std::swap(m_mem, other.m_mem);
+		std::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	const t_vm_byte* GetCode() const { return m_mem; }
+
+
+private:
+	t_vm_byte* m_mem{nullptr};
+	std::size_t m_size{0};
+};
+
+
+struct JitBatch;
+
+
+#endif
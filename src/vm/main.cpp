@@ -6,11 +6,13 @@
  */
 
 #include "vm.h"
+#include "container.h"
 #include "common/helpers.h"
 #include "common/version.h"
 
 #include <vector>
 #include <iostream>
+#include <sstream>
 #include <fstream>
 
 #if __has_include(<filesystem>)
@@ -25,6 +27,10 @@
 namespace args = boost::program_options;
 
 
+// memory size reserved for lazily allocated memory
+static constexpr const t_vm_addr g_lazy_mem_size = 1 << 30;
+
+
 struct VMOptions
 {
 	t_vm_addr mem_size { 4096 };
@@ -32,36 +38,189 @@ struct VMOptions
 	bool zero_mem { false };
 	bool enable_memimages { false };
 	bool enable_checks { true };
+	bool verify { true };
+	bool guard_pages { false };
+	bool lazy_mem { false };
+	bool mem_stats { false };
+	std::size_t outbuf_size { 4096 };
+	bool flush_lines { true };
+	bool enable_jit { false };
+	std::string profile_file { };
+	std::string sample_file { };
+	std::size_t sample_interval { 1000 };
 };
 
 
 
-static bool run_vm(const fs::path& prog, const VMOptions& opts)
+static bool run_vm(const fs::path& prog, const VMOptions& opts,
+	std::size_t* num_ops = nullptr)
 {
 	using namespace m_ops;
 
-	std::size_t filesize = fs::file_size(prog);
-	std::ifstream ifstr(prog, std::ios_base::binary);
-	if(!ifstr)
+	// the file is mapped if possible, so that only the pages
+	// of the header and the needed sections are read here
+	ProgramFile progfile;
+	if(!progfile.Open(prog.string()))
 		return false;
 
-	std::vector<VM::t_byte> bytes;
-	bytes.resize(filesize);
+	const VM::t_byte* bytes = progfile.GetData();
+	const std::size_t filesize = progfile.GetSize();
 
-	ifstr.read(reinterpret_cast<char*>(bytes.data()), filesize);
-	if(ifstr.fail())
-		return false;
+	// validate the program container once before loading anything,
+	// files without its header are a raw image of the code and constants
+	ProgContainer container;
+	const bool is_container = ProgContainer::IsContainer(bytes, filesize);
+	if(is_container)
+	{
+		auto err = container.Read(bytes, filesize);
+		if(!err)
+			err = container.CheckTypes();
+		if(err)
+			throw std::runtime_error("\"" + prog.string() + "\": " + *err);
+	}
+	else if(sizeof(t_vm_addr) != 4)
+	{
+		std::ostringstream msg;
+		msg << "\"" << prog.string() << "\" has been compiled for 32 bit addresses,"
+			<< " but the vm uses " << sizeof(t_vm_addr)*8 << " bit addresses.";
+		throw std::runtime_error(msg.str());
+	}
 
-	VM vm(opts.mem_size);
+	// the debug info and function table sections are not loaded
+	// into the vm's memory and only read if needed
+	std::optional<DebugInfo> debuginfo;
+	if(is_container && (opts.enable_debug || !opts.profile_file.empty() || !opts.sample_file.empty()))
+	{
+		if(const auto* section = container.GetSection(SectionType::DEBUG))
+		{
+			debuginfo = DebugInfo{};
+			if(!debuginfo->Read(section->data, section->size))
+			{
+				std::cerr << "Invalid debug info in \"" << prog.string()
+					<< "\"." << std::endl;
+				debuginfo.reset();
+			}
+		}
+		else if(const auto* section = container.GetSection(SectionType::FUNCS))
+		{
+			// without debug info, the function table still names the functions
+			FuncTable functab;
+			if(functab.Read(section->data, section->size))
+			{
+				debuginfo = DebugInfo{};
+				for(const FuncTable::Func& func : functab.GetFuncs())
+					debuginfo->AddFunc(func.name, func.addr, func.end_addr, 0);
+			}
+		}
+	}
+
+	VM vm(opts.mem_size, opts.guard_pages, opts.lazy_mem);
 	VM::t_addr sp_initial = vm.GetSP();
 
 	vm.SetDebug(opts.enable_debug);
 	vm.SetChecks(opts.enable_checks);
+	vm.SetVerify(opts.verify);
 	vm.SetZeroPoppedVals(opts.zero_mem);
 	vm.SetDrawMemImages(opts.enable_memimages);
-	vm.SetMem(0, bytes.data(), filesize, true);
+	vm.SetOutputBuffer(opts.outbuf_size, opts.flush_lines);
+	vm.SetJit(opts.enable_jit);
+	vm.SetProfile(!opts.profile_file.empty());
+	if(!opts.sample_file.empty())
+		vm.SetSampleInterval(std::chrono::microseconds(opts.sample_interval));
+	if(debuginfo)
+		vm.SetDebugInfo(std::move(*debuginfo));
+
+	// map the code directly into the vm's memory if it is mapped itself,
+	// otherwise copy it
+	if(is_container)
+	{
+		const auto* code = container.GetSection(SectionType::CODE);
+		if(!code)
+			throw std::runtime_error("\"" + prog.string() + "\" has no code section.");
+		if(code->addr != 0 || !vm.MapCode(progfile.GetDescriptor(), code->offset, code->size))
+			vm.SetMem(static_cast<VM::t_addr>(code->addr), code->data, code->size, true);
+
+		// the constants are part of the read-only code range
+		if(const auto* consts = container.GetSection(SectionType::CONSTS))
+			vm.SetMem(static_cast<VM::t_addr>(consts->addr), consts->data, consts->size, true);
+	}
+	else
+	{
+		if(!vm.MapCode(progfile.GetDescriptor(), 0, filesize))
+			vm.SetMem(0, bytes, filesize, true);
+	}
+
 	vm.Run();
 
+	if(num_ops)
+		*num_ops = vm.GetNumOps();
+
+	// write the opcode and function profile, as json for .json files
+	if(!opts.profile_file.empty())
+	{
+		if(opts.profile_file == "-")
+		{
+			vm.GetProfiler().WriteReport(std::cout, false, vm.GetDebugInfo());
+		}
+		else
+		{
+			fs::path profile_file = opts.profile_file;
+			std::ofstream ofstr(profile_file);
+			if(!ofstr)
+			{
+				std::cerr << "Could not write profile \""
+					<< profile_file.string() << "\"." << std::endl;
+			}
+			else
+			{
+				vm.GetProfiler().WriteReport(ofstr,
+					profile_file.extension() == ".json", vm.GetDebugInfo());
+			}
+		}
+	}
+
+	// write the call stack samples
+	if(!opts.sample_file.empty())
+	{
+		if(opts.sample_file == "-")
+		{
+			vm.GetProfiler().WriteFoldedStacks(std::cout, vm.GetDebugInfo());
+		}
+		else
+		{
+			fs::path sample_file = opts.sample_file;
+			std::ofstream ofstr(sample_file);
+			if(!ofstr)
+			{
+				std::cerr << "Could not write samples \""
+					<< sample_file.string() << "\"." << std::endl;
+			}
+			else
+			{
+				vm.GetProfiler().WriteFoldedStacks(ofstr, vm.GetDebugInfo());
+			}
+		}
+	}
+
+	// print the peak memory usage
+	if(opts.mem_stats)
+	{
+		const VM::t_addr stack_size = vm.GetPeakStackSize();
+		std::cout << "Peak stack size: " << stack_size << " bytes, memory usage: "
+			<< vm.GetCodeSize() + stack_size << " of " << vm.GetMemSize() << " bytes";
+		if(auto resident = vm.GetResidentMemSize())
+			std::cout << ", " << *resident << " bytes resident";
+		std::cout << "." << std::endl;
+
+		if(auto verified = vm.GetCodeVerified(); verified)
+		{
+			if(*verified)
+				std::cout << "Code verified, running without operand type tests." << std::endl;
+			else
+				std::cout << "Code not verified: " << vm.GetVerifyError() << std::endl;
+		}
+	}
+
 	// print remaining stack
 	std::size_t stack_idx = 0;
 	while(vm.GetSP() < sp_initial)
@@ -104,19 +263,47 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 			.zero_mem = false,
 			.enable_memimages = false,
 			.enable_checks = true,
+			.verify = true,
+			.guard_pages = false,
+			.lazy_mem = false,
+			.mem_stats = false,
+			.outbuf_size = 4096,
+			.flush_lines = true,
+			.enable_jit = false,
+			.profile_file = "",
+			.sample_file = "",
+			.sample_interval = 1000,
 		};
 		bool enable_timer = false;
 
 		args::options_description arg_descr("Virtual machine arguments");
 		arg_descr.add_options()
 			("debug,d", args::bool_switch(&vmopts.enable_debug), "enable debug output")
-			("timer,t", args::bool_switch(&enable_timer), "time code execution")
+			("timer,t", args::bool_switch(&enable_timer), "time code execution and show the peak memory usage")
 			("zeromem,z", args::bool_switch(&vmopts.zero_mem), "zero memory after use")
 #ifdef USE_BOOST_GIL
 			("memimages,i", args::bool_switch(&vmopts.enable_memimages), "write memory images")
 #endif
+#if VM_JIT != 0
+			("jit,j", args::bool_switch(&vmopts.enable_jit), "compile hot functions to native code")
+#endif
+			("profile,p", args::value<decltype(vmopts.profile_file)>(&vmopts.profile_file),
+				"write an opcode and function profile to a file (json for .json files), -: stdout")
+			("sample,s", args::value<decltype(vmopts.sample_file)>(&vmopts.sample_file),
+				"write call stack samples in folded format for flamegraphs to a file, -: stdout")
+			("interval,n", args::value<decltype(vmopts.sample_interval)>(&vmopts.sample_interval),
+				"set the sampling interval in microseconds")
 			("checks,c", args::value<bool>(&vmopts.enable_checks), "enable memory checks")
+			("verify,y", args::value<bool>(&vmopts.verify), "verify the code to run it without operand type tests")
+#if VM_MMAP != 0
+			("grow,a", args::bool_switch(&vmopts.lazy_mem), "reserve a large memory (or the -m size), whose pages are only allocated when used")
+#endif
+#if VM_GUARD_PAGES != 0
+			("guard,g", args::bool_switch(&vmopts.guard_pages), "protect the memory using guard pages instead of checks")
+#endif
 			("mem,m", args::value<decltype(vmopts.mem_size)>(&vmopts.mem_size), "set memory size")
+			("outbuf,o", args::value<decltype(vmopts.outbuf_size)>(&vmopts.outbuf_size), "set output buffer size, 0: unbuffered")
+			("flushlines,l", args::value<bool>(&vmopts.flush_lines), "flush the output buffer at line ends")
 			("prog", args::value<decltype(progs)>(&progs), "input program to run");
 
 		args::positional_options_description posarg_descr;
@@ -149,6 +336,11 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 		}
                 // --------------------------------------------------------------------
 
+		// use a large memory if its size is not given
+		if(vmopts.lazy_mem && !mapArgs.count("mem"))
+			vmopts.mem_size = g_lazy_mem_size;
+		vmopts.mem_stats = enable_timer;
+
                 // input file
 		fs::path inprog = progs[0];
 
@@ -156,7 +348,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 		if(enable_timer)
 			start_time  = t_clock::now();
 
-		if(!run_vm(inprog, vmopts))
+		std::size_t num_ops = 0;
+		if(!run_vm(inprog, vmopts, &num_ops))
 		{
 			std::cerr << "Could not run \"" << inprog.string()
 				<< "\"." << std::endl;
@@ -167,9 +360,15 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 		{
 			auto [run_time, time_unit] = get_elapsed_time<
 				t_real, t_timepoint>(start_time);
+			using t_duration_s = std::chrono::duration<t_real, std::ratio<1, 1>>;
+			t_real run_time_s = t_duration_s(t_clock::now() - start_time).count();
+
 			std::cout << "Program run time: "
-				<< run_time << " " << time_unit << "."
-				<< std::endl;
+				<< run_time << " " << time_unit << ", "
+				<< num_ops << " instructions";
+			if(run_time_s > t_real(0))
+				std::cout << " (" << t_real(num_ops) / run_time_s << " instructions/s)";
+			std::cout << "." << std::endl;
 		}
 
 		if(vmopts.enable_memimages)
@@ -15,12 +15,32 @@
 #include <sstream>
 
 
+/**
+ * check that the memory range [addr, addr + size) is inside the memory,
+ * the checks are compiled out if they are disabled for the interpreter loop
+ */
+template<bool checks>
+void VM::CheckMemoryBounds(typename VM::t_addr addr, typename VM::t_addr size) const
+{
+	if constexpr(checks)
+	{
+		// guard pages catch the out-of-bounds accesses while running
+		if(!m_checks || m_mem.IsGuarded())
+			return;
+
+		t_addr new_addr = addr + size;
+		if(new_addr > m_memsize || new_addr < 0 || addr < 0)
+			ThrowMemoryBounds(addr, size);
+	}
+}
+
+
 /**
  * pop an array from the stack
  * an array consists of an t_addr giving the length
  * following by the array elements
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 t_vec VM::PopArray(bool raw_elems)
 {
 	using t_elem = typename t_vec::value_type;
@@ -31,8 +51,8 @@ t_vec VM::PopArray(bool raw_elems)
 	// raw real array and array size follow without descriptors
 	if(raw_elems)
 	{
-		t_addr num_elems = PopRaw<t_addr, m_addrsize>();
-		CheckMemoryBounds(m_sp, num_elems*elem_size);
+		t_addr num_elems = PopRaw<t_addr, m_addrsize, checks>();
+		CheckMemoryBounds<checks>(m_sp, num_elems*elem_size);
 
 		t_elem* begin = reinterpret_cast<t_elem*>(m_mem.get() + m_sp);
 		t_vec vec(begin, num_elems);
@@ -58,12 +78,12 @@ t_vec VM::PopArray(bool raw_elems)
 	// individual elements and array size with descriptor are on the stack
 	else
 	{
-		t_addr num_elems = PopAddress();
+		t_addr num_elems = PopAddress<checks>();
 		t_vec vec(num_elems);
 
 		for(t_addr i = 0; i < num_elems; ++i)
 		{
-			t_data val = PopData();
+			t_data val = PopData<checks>();
 			if(val.index() != elem_type_idx)
 				throw std::runtime_error("Wrong element type for array.");
 
@@ -86,16 +106,16 @@ t_vec VM::PopArray(bool raw_elems)
 /**
  * get the array on top of the stack
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 t_vec VM::TopArray(typename VM::t_addr sp_offs) const
 {
 	using t_elem = typename t_vec::value_type;
 	constexpr const t_addr elem_size = GetDataTypeSize<t_elem>();
 
-	t_addr num_elems = TopRaw<t_addr, m_addrsize>(sp_offs);
+	t_addr num_elems = TopRaw<t_addr, m_addrsize, checks>(sp_offs);
 	t_addr addr = m_sp + sp_offs + m_addrsize;
 
-	CheckMemoryBounds(addr, num_elems*elem_size);
+	CheckMemoryBounds<checks>(addr, num_elems*elem_size);
 	const t_elem* begin = reinterpret_cast<t_elem*>(m_mem.get() + addr);
 	return t_vec(begin, num_elems);
 }
@@ -104,7 +124,7 @@ t_vec VM::TopArray(typename VM::t_addr sp_offs) const
 /**
  * push an array onto the stack
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 void VM::PushArray(const t_vec& vec, bool raw)
 {
 	using t_elem = typename t_vec::value_type;
@@ -112,18 +132,20 @@ void VM::PushArray(const t_vec& vec, bool raw)
 	constexpr const t_addr elem_size = GetDataTypeSize<t_elem>();
 
 	t_addr num_elems = static_cast<t_addr>(vec.size());
-	CheckMemoryBounds(m_sp, -num_elems*elem_size);
+	if(!raw)
+		PushPadding<checks>(m_addrsize + num_elems*elem_size);
+	CheckMemoryBounds<checks>(m_sp, -num_elems*elem_size);
 
 	m_sp -= num_elems*elem_size;
 	t_elem* begin = reinterpret_cast<t_elem*>(m_mem.get() + m_sp);
 	std::memcpy(begin, vec.data(), num_elems*elem_size);
 
-	PushRaw<t_addr, m_addrsize>(num_elems);
+	PushRaw<t_addr, m_addrsize, checks>(num_elems);
 
 	if(!raw)
 	{
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(
 			GetArraySymbolType<t_elem>()));
 
 		if(m_debug)
@@ -139,16 +161,16 @@ void VM::PushArray(const t_vec& vec, bool raw)
 /**
  * read an array from a memory address
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 t_vec VM::ReadArrayRaw(typename VM::t_addr addr) const
 {
 	using t_elem = typename t_vec::value_type;
 	constexpr const t_addr elem_size = GetDataTypeSize<t_elem>();
 
-	t_addr num_elems = ReadMemRaw<t_addr>(addr);
+	t_addr num_elems = ReadMemRaw<t_addr, checks>(addr);
 	addr += m_addrsize;
 
-	CheckMemoryBounds(addr, num_elems*elem_size);
+	CheckMemoryBounds<checks>(addr, num_elems*elem_size);
 	const t_elem *begin = reinterpret_cast<t_elem*>(&m_mem[addr]);
 
 	return t_vec(begin, num_elems);
@@ -158,7 +180,7 @@ t_vec VM::ReadArrayRaw(typename VM::t_addr addr) const
 /**
  * write an array to a memory address
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 void VM::WriteArray(typename VM::t_addr addr, const t_vec& vec, bool raw)
 {
 	using t_elem = typename t_vec::value_type;
@@ -176,16 +198,16 @@ void VM::WriteArray(typename VM::t_addr addr, const t_vec& vec, bool raw)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(
 			GetArraySymbolType<t_elem>()));
-		addr += m_bytesize;
+		addr += m_descrsize;
 	}
 
 	t_addr num_elems = static_cast<t_addr>(vec.size());
-	CheckMemoryBounds(addr, m_addrsize + num_elems*elem_size);
+	CheckMemoryBounds<checks>(addr, m_addrsize + num_elems*elem_size);
 
 	// write array length
-	WriteMemRaw<t_addr>(addr, num_elems);
+	WriteMemRaw<t_addr, checks>(addr, num_elems);
 	addr += m_addrsize;
 
 	// write array
@@ -197,7 +219,7 @@ void VM::WriteArray(typename VM::t_addr addr, const t_vec& vec, bool raw)
 /**
  * read an array element from a given index and push it onto the stack
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 void VM::ReadArrayElem(const t_data& arr, typename VM::t_int idx)
 {
 	using t_elem = typename t_vec::value_type;
@@ -208,7 +230,29 @@ void VM::ReadArrayElem(const t_data& arr, typename VM::t_int idx)
 	const t_vec& vec = std::get<vec_idx>(arr);
 	idx = safe_array_index<t_int>(idx, vec.size());
 
-	PushData(t_data{std::in_place_index<elem_idx>, vec[idx]});
+	PushData<checks>(t_data{std::in_place_index<elem_idx>, vec[idx]});
+}
+
+
+/**
+ * read an array element directly from a memory address
+ * and push it onto the stack without copying the whole array
+ */
+template<class t_vec, bool checks>
+void VM::ReadArrayElem(typename VM::t_addr addr, typename VM::t_int idx)
+{
+	using t_elem = typename t_vec::value_type;
+	constexpr const t_addr elem_size = GetDataTypeSize<t_elem>();
+	constexpr const std::size_t elem_idx = GetDataTypeIndex<t_elem>();
+
+	// get array length indicator
+	t_addr veclen = ReadMemRaw<t_addr, checks>(addr);
+	addr += m_addrsize;
+
+	// skip to element and read it
+	idx = safe_array_index<t_addr>(idx, veclen);
+	addr += idx * elem_size;
+	PushData<checks>(t_data{std::in_place_index<elem_idx>, ReadMemRaw<t_elem, checks>(addr)});
 }
 
 
@@ -216,7 +260,7 @@ void VM::ReadArrayElem(const t_data& arr, typename VM::t_int idx)
  * read an array element range from given indices
  * and push the new array onto the stack
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 void VM::ReadArrayElemRange(const t_data& arr,
 	typename VM::t_int idx1, typename VM::t_int idx2)
 {
@@ -234,14 +278,60 @@ void VM::ReadArrayElemRange(const t_data& arr,
 	t_int new_idx = 0;
 	for(t_int idx = idx1; idx != idx2; idx += delta)
 		newvec[new_idx++] = vec[idx];
-	PushData(t_data{std::in_place_index<vec_idx>, newvec});
+	PushData<checks>(t_data{std::in_place_index<vec_idx>, newvec});
+}
+
+
+/**
+ * read an array element range directly from a memory address
+ * and push the new array onto the stack, only the range is copied
+ */
+template<class t_vec, bool checks>
+void VM::ReadArrayElemRange(typename VM::t_addr addr,
+	typename VM::t_int idx1, typename VM::t_int idx2)
+{
+	using t_elem = typename t_vec::value_type;
+	constexpr const t_addr elem_size = GetDataTypeSize<t_elem>();
+
+	// get array length indicator
+	t_addr veclen = ReadMemRaw<t_addr, checks>(addr);
+	addr += m_addrsize;
+
+	idx1 = safe_array_index<t_addr>(idx1, veclen);
+	idx2 = safe_array_index<t_addr>(idx2, veclen);
+	t_addr num_elems = static_cast<t_addr>(std::abs(idx2 - idx1) + 1);
+	CheckMemoryBounds<checks>(addr + std::min(idx1, idx2)*elem_size, num_elems*elem_size);
+
+	// copy the range directly onto the stack
+	PushPadding<checks>(m_addrsize + num_elems*elem_size);
+	CheckMemoryBounds<checks>(m_sp, -num_elems*elem_size);
+	m_sp -= num_elems*elem_size;
+
+	if(idx2 >= idx1)
+	{
+		std::memmove(m_mem.get() + m_sp, m_mem.get() + addr + idx1*elem_size,
+			num_elems*elem_size);
+	}
+	else
+	{
+		// reversed range
+		for(t_addr elem = 0; elem < num_elems; ++elem)
+		{
+			std::memcpy(m_mem.get() + m_sp + elem*elem_size,
+				m_mem.get() + addr + (idx1 - elem)*elem_size, elem_size);
+		}
+	}
+
+	PushRaw<t_addr, m_addrsize, checks>(num_elems);
+	PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(
+		GetArraySymbolType<t_elem>()));
 }
 
 
 /**
  * write an array element to a memory address
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 void VM::WriteArrayElem(typename VM::t_addr addr, const t_data& data,
 	typename VM::t_int idx)
 {
@@ -256,20 +346,20 @@ void VM::WriteArrayElem(typename VM::t_addr addr, const t_data& data,
 	}
 
 	// get array length indicator
-	t_addr veclen = ReadMemRaw<t_addr>(addr);
+	t_addr veclen = ReadMemRaw<t_addr, checks>(addr);
 	addr += m_addrsize;
 
 	// skip to element and overwrite it
 	idx = safe_array_index<t_addr>(idx, veclen);
 	addr += idx * elem_size;
-	WriteMemRaw(addr, std::get<elem_idx>(data));
+	WriteMemRaw<t_elem, checks>(addr, std::get<elem_idx>(data));
 }
 
 
 /**
  * write an array element range to a memory address
  */
-template<class t_vec>
+template<class t_vec, bool checks>
 void VM::WriteArrayElemRange(typename VM::t_addr addr, const t_data& data,
 	typename VM::t_int idx1, typename VM::t_int idx2)
 {
@@ -290,7 +380,7 @@ void VM::WriteArrayElemRange(typename VM::t_addr addr, const t_data& data,
 			"Array range has to be of array or scalar type.");
 
 	// get array length indicator
-	t_addr veclen = ReadMemRaw<t_addr>(addr);
+	t_addr veclen = ReadMemRaw<t_addr, checks>(addr);
 	addr += m_addrsize;
 
 	idx1 = safe_array_index<t_addr>(idx1, veclen);
@@ -317,25 +407,84 @@ void VM::WriteArrayElemRange(typename VM::t_addr addr, const t_data& data,
 			elem = *rhsreal;
 		}
 
-		WriteMemRaw(addr, elem);
+		WriteMemRaw<t_elem, checks>(addr, elem);
 		addr += elem_size * delta;
 	}
 }
 
 
+/**
+ * copy an array element range between two memory addresses
+ * without creating temporary arrays
+ */
+template<class t_vec, bool checks>
+void VM::CopyArrayElemRange(
+	typename VM::t_addr dst_addr, typename VM::t_int dst_idx1, typename VM::t_int dst_idx2,
+	typename VM::t_addr src_addr, typename VM::t_int src_idx1, typename VM::t_int src_idx2)
+{
+	using t_elem = typename t_vec::value_type;
+	constexpr const t_addr elem_size = GetDataTypeSize<t_elem>();
+
+	// get array length indicators
+	t_addr dst_len = ReadMemRaw<t_addr, checks>(dst_addr);
+	dst_addr += m_addrsize;
+	t_addr src_len = ReadMemRaw<t_addr, checks>(src_addr);
+	src_addr += m_addrsize;
+
+	dst_idx1 = safe_array_index<t_addr>(dst_idx1, dst_len);
+	dst_idx2 = safe_array_index<t_addr>(dst_idx2, dst_len);
+	src_idx1 = safe_array_index<t_addr>(src_idx1, src_len);
+	src_idx2 = safe_array_index<t_addr>(src_idx2, src_len);
+
+	t_addr dst_num = static_cast<t_addr>(std::abs(dst_idx2 - dst_idx1) + 1);
+	t_addr src_num = static_cast<t_addr>(std::abs(src_idx2 - src_idx1) + 1);
+	if(src_num < dst_num)
+		throw std::runtime_error("Array index out of bounds.");
+
+	t_addr dst_begin = dst_addr + std::min(dst_idx1, dst_idx2)*elem_size;
+	t_addr src_begin = src_addr + std::min(src_idx1, src_idx2)*elem_size;
+	CheckMemoryBounds<checks>(dst_begin, dst_num*elem_size);
+	CheckMemoryBounds<checks>(src_begin, dst_num*elem_size);
+
+	// both ranges are ascending: a single (possibly overlapping) move
+	if(dst_idx2 >= dst_idx1 && src_idx2 >= src_idx1)
+	{
+		std::memmove(m_mem.get() + dst_begin, m_mem.get() + src_begin,
+			dst_num*elem_size);
+		return;
+	}
+
+	// reversed ranges: copy the source range first, since it may overlap
+	t_vec src_elems = m::zero<t_vec>(dst_num);
+	t_int src_delta = (src_idx2 >= src_idx1 ? 1 : -1);
+	for(t_addr elem = 0; elem < dst_num; ++elem)
+	{
+		src_elems[elem] = ReadMemRaw<t_elem, checks>(
+			src_addr + (src_idx1 + elem*src_delta)*elem_size);
+	}
+
+	t_int dst_delta = (dst_idx2 >= dst_idx1 ? 1 : -1);
+	for(t_addr elem = 0; elem < dst_num; ++elem)
+	{
+		WriteMemRaw<t_elem, checks>(dst_addr + (dst_idx1 + elem*dst_delta)*elem_size,
+			src_elems[elem]);
+	}
+}
+
+
 /**
  * read a raw value from memory
  */
-template<class t_val>
+template<class t_val, bool checks>
 t_val VM::ReadMemRaw(typename VM::t_addr addr) const
 {
 	// string type
 	if constexpr(std::is_same_v<std::decay_t<t_val>, t_str>)
 	{
-		t_addr len = ReadMemRaw<t_addr>(addr);
+		t_addr len = ReadMemRaw<t_addr, checks>(addr);
 		addr += m_addrsize;
 
-		CheckMemoryBounds(addr, len*m_charsize);
+		CheckMemoryBounds<checks>(addr, len*m_charsize);
 		const t_char* begin = reinterpret_cast<t_char*>(&m_mem[addr]);
 
 		return t_str(begin, len);
@@ -344,7 +493,7 @@ t_val VM::ReadMemRaw(typename VM::t_addr addr) const
 	// complex type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_cplx>)
 	{
-		CheckMemoryBounds(addr, GetDataTypeSize<t_cplx>());
+		CheckMemoryBounds<checks>(addr, GetDataTypeSize<t_cplx>());
 		const t_real* real = reinterpret_cast<t_real*>(
 			&m_mem[addr]);
 		const t_real* imag = reinterpret_cast<t_real*>(
@@ -356,7 +505,7 @@ t_val VM::ReadMemRaw(typename VM::t_addr addr) const
 	// quaternion type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_quat>)
 	{
-		CheckMemoryBounds(addr, GetDataTypeSize<t_quat>());
+		CheckMemoryBounds<checks>(addr, GetDataTypeSize<t_quat>());
 		const t_real* real = reinterpret_cast<t_real*>(
 			&m_mem[addr]);
 		const t_real* imag1 = reinterpret_cast<t_real*>(
@@ -372,31 +521,31 @@ t_val VM::ReadMemRaw(typename VM::t_addr addr) const
 	// real array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_real>)
 	{
-		return ReadArrayRaw<t_vec_real>(addr);
+		return ReadArrayRaw<t_vec_real, checks>(addr);
 	}
 
 	// int array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_int>)
 	{
-		return ReadArrayRaw<t_vec_int>(addr);
+		return ReadArrayRaw<t_vec_int, checks>(addr);
 	}
 
 	// complex array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_cplx>)
 	{
-		return ReadArrayRaw<t_vec_cplx>(addr);
+		return ReadArrayRaw<t_vec_cplx, checks>(addr);
 	}
 
 	// quaterion array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_quat>)
 	{
-		return ReadArrayRaw<t_vec_quat>(addr);
+		return ReadArrayRaw<t_vec_quat, checks>(addr);
 	}
 
 	// primitive types
 	else
 	{
-		CheckMemoryBounds(addr, sizeof(t_val));
+		CheckMemoryBounds<checks>(addr, sizeof(t_val));
 		t_val val = *reinterpret_cast<t_val*>(&m_mem[addr]);
 
 		return val;
@@ -407,17 +556,17 @@ t_val VM::ReadMemRaw(typename VM::t_addr addr) const
 /**
  * write a raw value to memory
  */
-template<class t_val>
+template<class t_val, bool checks>
 void VM::WriteMemRaw(typename VM::t_addr addr, const t_val& val)
 {
 	// string type
 	if constexpr(std::is_same_v<std::decay_t<t_val>, t_str>)
 	{
 		t_addr len = static_cast<t_addr>(val.length());
-		CheckMemoryBounds(addr, m_addrsize + len*m_charsize);
+		CheckMemoryBounds<checks>(addr, m_addrsize + len*m_charsize);
 
 		// write string length
-		WriteMemRaw<t_addr>(addr, len);
+		WriteMemRaw<t_addr, checks>(addr, len);
 		addr += m_addrsize;
 
 		// write string
@@ -428,7 +577,7 @@ void VM::WriteMemRaw(typename VM::t_addr addr, const t_val& val)
 	// complex type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_cplx>)
 	{
-		CheckMemoryBounds(addr, GetDataTypeSize<t_cplx>());
+		CheckMemoryBounds<checks>(addr, GetDataTypeSize<t_cplx>());
 
 		t_real* begin = reinterpret_cast<t_real*>(&m_mem[addr]);
 		*(begin + 0) = val.real();
@@ -438,7 +587,7 @@ void VM::WriteMemRaw(typename VM::t_addr addr, const t_val& val)
 	// quaternion type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_quat>)
 	{
-		CheckMemoryBounds(addr, GetDataTypeSize<t_quat>());
+		CheckMemoryBounds<checks>(addr, GetDataTypeSize<t_quat>());
 
 		t_real* begin = reinterpret_cast<t_real*>(&m_mem[addr]);
 		*(begin + 0) = val.real();
@@ -450,31 +599,31 @@ void VM::WriteMemRaw(typename VM::t_addr addr, const t_val& val)
 	// real array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_real>)
 	{
-		WriteArray<t_vec_real>(addr, val, true);
+		WriteArray<t_vec_real, checks>(addr, val, true);
 	}
 
 	// int array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_int>)
 	{
-		WriteArray<t_vec_int>(addr, val, true);
+		WriteArray<t_vec_int, checks>(addr, val, true);
 	}
 
 	// complex array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_cplx>)
 	{
-		WriteArray<t_vec_cplx>(addr, val, true);
+		WriteArray<t_vec_cplx, checks>(addr, val, true);
 	}
 
 	// quaternion array type
 	else if constexpr(std::is_same_v<std::decay_t<t_val>, t_vec_quat>)
 	{
-		WriteArray<t_vec_quat>(addr, val, true);
+		WriteArray<t_vec_quat, checks>(addr, val, true);
 	}
 
 	// primitive types
 	else
 	{
-		CheckMemoryBounds(addr, sizeof(t_val));
+		CheckMemoryBounds<checks>(addr, sizeof(t_val));
 		*reinterpret_cast<t_val*>(&m_mem[addr]) = val;
 	}
 }
@@ -483,11 +632,12 @@ void VM::WriteMemRaw(typename VM::t_addr addr, const t_val& val)
 /**
  * get the value on top of the stack
  */
-template<class t_val, typename VM::t_addr valsize>
+template<class t_val, typename VM::t_addr valsize, bool checks>
 t_val VM::TopRaw(typename VM::t_addr sp_offs) const
 {
 	t_addr addr = m_sp + sp_offs;
-	CheckMemoryBounds(addr, valsize);
+	if constexpr(checks)
+		CheckMemoryBounds(addr, valsize);
 
 	return *reinterpret_cast<t_val*>(m_mem.get() + addr);
 }
@@ -496,10 +646,11 @@ t_val VM::TopRaw(typename VM::t_addr sp_offs) const
 /**
  * pop a raw value from the stack
  */
-template<class t_val, typename VM::t_addr valsize>
+template<class t_val, typename VM::t_addr valsize, bool checks>
 t_val VM::PopRaw()
 {
-	CheckMemoryBounds(m_sp, valsize);
+	if constexpr(checks)
+		CheckMemoryBounds(m_sp, valsize);
 
 	t_val *valptr = reinterpret_cast<t_val*>(m_mem.get() + m_sp);
 	t_val val = *valptr;
@@ -516,14 +667,93 @@ t_val VM::PopRaw()
 /**
  * push a raw value onto the stack
  */
-template<class t_val, typename VM::t_addr valsize>
+template<class t_val, typename VM::t_addr valsize, bool checks>
 void VM::PushRaw(const t_val& val)
 {
-	CheckMemoryBounds(m_sp, valsize);
+	if constexpr(checks)
+		CheckMemoryBounds(m_sp, valsize);
 
 	m_sp -= valsize;	// stack grows to lower addresses
 	*reinterpret_cast<t_val*>(m_mem.get() + m_sp) = val;
 }
 
 
+/**
+ * push the padding behind a value with the given data size,
+ * it has to be pushed before the data, see vm_padding_size()
+ */
+template<bool checks>
+void VM::PushPadding(typename VM::t_addr size)
+{
+	if constexpr(g_vm_slot_size > 1)
+	{
+		const t_addr pad = vm_padding_size(size);
+		if constexpr(checks)
+			CheckMemoryBounds(m_sp, -pad);
+
+		m_sp -= pad;
+	}
+}
+
+
+/**
+ * pop the padding behind a value with the given data size
+ */
+template<bool checks>
+void VM::PopPadding(typename VM::t_addr size)
+{
+	if constexpr(g_vm_slot_size > 1)
+	{
+		const t_addr pad = vm_padding_size(size);
+		if constexpr(checks)
+			CheckMemoryBounds(m_sp, pad);
+
+		m_sp += pad;
+	}
+}
+
+
+/**
+ * pop an integer or real without type descriptor from the stack
+ */
+template<class t_val, bool checks>
+t_val VM::PopUntagged()
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const t_addr pad = vm_untagged_padding_size(valsize);
+
+	t_val val = PopRaw<t_val, valsize, checks>();
+	if constexpr(pad > 0)
+	{
+		if constexpr(checks)
+			CheckMemoryBounds<checks>(m_sp, pad);
+
+		m_sp += pad;
+	}
+
+	return val;
+}
+
+
+/**
+ * push an integer or real without type descriptor onto the stack
+ */
+template<class t_val, bool checks>
+void VM::PushUntagged(const t_val& val)
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const t_addr pad = vm_untagged_padding_size(valsize);
+
+	if constexpr(pad > 0)
+	{
+		if constexpr(checks)
+			CheckMemoryBounds<checks>(m_sp, -pad);
+
+		m_sp -= pad;
+	}
+
+	PushRaw<t_val, valsize, checks>(val);
+}
+
+
 #endif
@@ -0,0 +1,258 @@
+/**
+ * micro-benchmarks of the vm's stack and memory primitives
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "vm.h"
+#include "mem.h"
+#include "common/helpers.h"
+#include "common/version.h"
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+
+#include <boost/program_options.hpp>
+namespace args = boost::program_options;
+
+
+
+/**
+ * gives access to the vm's stack and memory primitives
+ */
+class BenchVM : public VM
+{
+public:
+	BenchVM(t_addr memsize) : VM(memsize) {}
+
+	using VM::PushData;
+	using VM::PopData;
+	using VM::ReadMemData;
+	using VM::WriteMemData;
+	using VM::PushArray;
+	using VM::PopArray;
+	using VM::PushString;
+	using VM::PopString;
+	using VM::PushAddress;
+	using VM::PopAddress;
+};
+
+
+struct BenchOptions
+{
+	std::size_t repeats { 5 };
+	std::size_t max_size { 1000000 };
+	std::size_t elems_per_run { 1000000 };
+	VM::t_addr mem_size { 64*1024*1024 };
+	bool enable_checks { true };
+};
+
+
+// prevents the compiler from removing the benchmarked calls
+static volatile std::size_t g_sink = 0;
+
+
+
+/**
+ * runs a benchmark repeatedly and prints the fastest time per operation
+ */
+template<class t_func>
+static void measure(const BenchOptions& opts,
+	const char* primitive, const char* type, std::size_t size, t_func&& func)
+{
+	// fewer iterations for larger data
+	const std::size_t iters = std::max<std::size_t>(opts.elems_per_run / size, 16);
+
+	// warm-up
+	func();
+
+	double best_ns = std::numeric_limits<double>::max();
+	for(std::size_t rep = 0; rep < opts.repeats; ++rep)
+	{
+		t_timepoint start_time = t_clock::now();
+		for(std::size_t iter = 0; iter < iters; ++iter)
+			func();
+		std::chrono::duration<double, std::nano> dur = t_clock::now() - start_time;
+
+		best_ns = std::min(best_ns, dur.count() / double(iters));
+	}
+
+	std::cout << std::left
+		<< std::setw(24) << primitive
+		<< std::setw(10) << type
+		<< std::right
+		<< std::setw(10) << size
+		<< std::setw(12) << iters
+		<< std::setw(16) << std::fixed << std::setprecision(2) << best_ns
+		<< std::setw(16) << best_ns / double(size)
+		<< std::endl;
+}
+
+
+
+/**
+ * benchmarks the primitives on a value of a given data type
+ */
+static void bench_data(BenchVM& vm, const BenchOptions& opts,
+	const char* type, const VM::t_data& data, std::size_t size = 1)
+{
+	measure(opts, "PushData/PopData", type, size, [&vm, &data]()
+	{
+		vm.PushData(data, VMType::UNKNOWN, false);
+		g_sink = g_sink + vm.PopData().index();
+	});
+
+	measure(opts, "WriteMemData", type, size, [&vm, &data]()
+	{
+		vm.WriteMemData(0, data);
+	});
+
+	measure(opts, "ReadMemData", type, size, [&vm]()
+	{
+		auto [ty, val] = vm.ReadMemData(0);
+		g_sink = g_sink + val.index();
+	});
+}
+
+
+
+/**
+ * benchmarks the raw array primitives
+ */
+template<class t_vec, std::size_t data_idx>
+static void bench_array(BenchVM& vm, const BenchOptions& opts,
+	const char* type, std::size_t size)
+{
+	using t_elem = typename t_vec::value_type;
+
+	t_vec vec(size);
+	for(std::size_t i = 0; i < size; ++i)
+		vec[i] = t_elem(i % 7);
+
+	measure(opts, "PushArray/PopArray", type, size, [&vm, &vec]()
+	{
+		vm.PushArray<t_vec>(vec);
+		g_sink = g_sink + vm.PopArray<t_vec>().size();
+	});
+
+	bench_data(vm, opts, type,
+		VM::t_data{std::in_place_index<data_idx>, vec}, size);
+}
+
+
+
+/**
+ * benchmarks the string primitives
+ */
+static void bench_string(BenchVM& vm, const BenchOptions& opts, std::size_t size)
+{
+	const VM::t_str str(size, 'x');
+
+	measure(opts, "PushString/PopString", "str", size, [&vm, &str]()
+	{
+		vm.PushString(str);
+		g_sink = g_sink + vm.PopString().size();
+	});
+
+	bench_data(vm, opts, "str",
+		VM::t_data{std::in_place_index<VM::m_stridx>, str}, size);
+}
+
+
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		std::ios_base::sync_with_stdio(false);
+
+		// --------------------------------------------------------------------
+		// get program arguments
+		// --------------------------------------------------------------------
+		BenchOptions opts
+		{
+			.repeats = 5,
+			.max_size = 1000000,
+			.elems_per_run = 1000000,
+			.mem_size = 64*1024*1024,
+			.enable_checks = true,
+		};
+
+		args::options_description arg_descr("Micro-benchmark arguments");
+		arg_descr.add_options()
+			("help,h", "show help")
+			("repeats,r", args::value<decltype(opts.repeats)>(&opts.repeats), "number of runs per benchmark, the fastest is shown")
+			("maxsize,n", args::value<decltype(opts.max_size)>(&opts.max_size), "maximum array and string size")
+			("elems,e", args::value<decltype(opts.elems_per_run)>(&opts.elems_per_run), "number of elements to process per run")
+			("mem,m", args::value<decltype(opts.mem_size)>(&opts.mem_size), "set memory size")
+			("checks,c", args::value<bool>(&opts.enable_checks), "enable memory checks");
+
+		args::variables_map mapArgs;
+		args::store(args::parse_command_line(argc, argv, arg_descr), mapArgs);
+		args::notify(mapArgs);
+
+		if(mapArgs.count("help"))
+		{
+			std::cout << arg_descr << std::endl;
+			return 0;
+		}
+		if(opts.repeats == 0 || opts.elems_per_run == 0)
+			throw std::runtime_error("Invalid number of runs or elements.");
+		// --------------------------------------------------------------------
+
+		BenchVM vm(opts.mem_size);
+		vm.SetChecks(opts.enable_checks);
+
+		std::cout << "0ac vm micro-benchmarks, version " << VM_VER << "." << std::endl;
+		std::cout << "Times are the fastest of " << opts.repeats << " runs." << std::endl;
+		std::cout << std::left
+			<< std::setw(24) << "primitive"
+			<< std::setw(10) << "type"
+			<< std::right
+			<< std::setw(10) << "size"
+			<< std::setw(12) << "iterations"
+			<< std::setw(16) << "ns/op"
+			<< std::setw(16) << "ns/element"
+			<< std::endl;
+
+		// scalar types
+		bench_data(vm, opts, "real",
+			VM::t_data{std::in_place_index<VM::m_realidx>, 1.5});
+		bench_data(vm, opts, "int",
+			VM::t_data{std::in_place_index<VM::m_intidx>, 123});
+		bench_data(vm, opts, "cplx",
+			VM::t_data{std::in_place_index<VM::m_cplxidx>, VM::t_cplx{1., 2.}});
+		bench_data(vm, opts, "quat",
+			VM::t_data{std::in_place_index<VM::m_quatidx>, VM::t_quat{1., 2., 3., 4.}});
+		bench_data(vm, opts, "bool",
+			VM::t_data{std::in_place_index<VM::m_boolidx>, 1});
+
+		measure(opts, "PushAddress/PopAddress", "addr", 1, [&vm]()
+		{
+			vm.PushAddress(1234, VMType::ADDR_MEM);
+			g_sink = g_sink + vm.PopAddress();
+		});
+
+		// strings and arrays of increasing sizes
+		for(std::size_t size = 1; size <= opts.max_size; size *= 10)
+		{
+			bench_string(vm, opts, size);
+			bench_array<VM::t_vec_real, VM::m_realarridx>(vm, opts, "realarr", size);
+			bench_array<VM::t_vec_int, VM::m_intarridx>(vm, opts, "intarr", size);
+			bench_array<VM::t_vec_cplx, VM::m_cplxarridx>(vm, opts, "cplxarr", size);
+			bench_array<VM::t_vec_quat, VM::m_quatarridx>(vm, opts, "quatarr", size);
+		}
+	}
+	catch(const std::exception& err)
+	{
+		std::cerr << "Error: " << err.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
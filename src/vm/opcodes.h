@@ -24,6 +24,14 @@ enum class OpCode : t_vm_byte
 	WRMEM       = 0x11,  // write memory
 	RDMEM       = 0x12,  // read memory
 
+	// untagged values, i.e. integers or reals without type descriptor,
+	// the untagged instructions use spare opcodes of the other categories,
+	// so they must not be tested by ranges, see get_vm_untagged_type()
+	TAG_I       = 0x13,  // add the descriptor to an untagged integer
+	TAG_R       = 0x14,  // add the descriptor to an untagged real
+	UNTAG_I     = 0x15,  // remove the descriptor from an integer
+	UNTAG_R     = 0x16,  // remove the descriptor from a real
+
 	// arithmetic operations
 	USUB        = 0x20,  // unary -
 	ADD         = 0x21,  // +
@@ -34,6 +42,16 @@ enum class OpCode : t_vm_byte
 	POW         = 0x26,  // ^
 	MATMUL      = 0x27,  // matrix multiplication
 
+	// statically typed arithmetic operations
+	ADD_I       = 0x28,  // integer +
+	SUB_I       = 0x29,  // integer -
+	MUL_I       = 0x2a,  // integer *
+	DIV_I       = 0x2b,  // integer /
+	ADD_R       = 0x2c,  // real +
+	SUB_R       = 0x2d,  // real -
+	MUL_R       = 0x2e,  // real *
+	DIV_R       = 0x2f,  // real /
+
 	// conversions
 	TOR         = 0x31,  // cast to real
 	TOI         = 0x32,  // cast to int
@@ -41,6 +59,8 @@ enum class OpCode : t_vm_byte
 	TOQ         = 0x34,  // cast to quaternion
 	TOB         = 0x35,  // cast to bool
 	TOS         = 0x36,  // cast to string
+	TOR_IU      = 0x37,  // cast untagged integer to untagged real
+	TOI_RU      = 0x38,  // cast untagged real to untagged integer
 
 	// array conversions
 	TOREALARR   = 0x41,  // cast to real array
@@ -66,6 +86,20 @@ enum class OpCode : t_vm_byte
 	EQU         = 0x74,  // ==
 	NEQU        = 0x75,  // !=
 
+	// comparisons of untagged values
+	GT_IU       = 0x64,  // untagged integer >
+	LT_IU       = 0x65,  // untagged integer <
+	GEQU_IU     = 0x66,  // untagged integer >=
+	LEQU_IU     = 0x67,  // untagged integer <=
+	EQU_IU      = 0x68,  // untagged integer ==
+	NEQU_IU     = 0x69,  // untagged integer !=
+	GT_RU       = 0x6a,  // untagged real >
+	LT_RU       = 0x6b,  // untagged real <
+	GEQU_RU     = 0x6c,  // untagged real >=
+	LEQU_RU     = 0x6d,  // untagged real <=
+	EQU_RU      = 0x6e,  // untagged real ==
+	NEQU_RU     = 0x6f,  // untagged real !=
+
 	// function calls
 	CALL        = 0x80,  // call function
 	RET         = 0x81,  // return from function
@@ -92,8 +126,81 @@ enum class OpCode : t_vm_byte
 	// array memory operations
 	RDARR       = 0xb0,  // read element from an array type
 	RDARRR      = 0xb1,  // read range from an array type
+	RDARRM      = 0xb2,  // read element from an array in memory
+	RDARRRM     = 0xb3,  // read range from an array in memory
 	WRARR       = 0xb4,  // write element to an array type
 	WRARRR      = 0xb5,  // write range to an array type
+	CPARRR      = 0xb6,  // copy range between arrays in memory
+
+	// statically typed comparisons
+	GT_I        = 0xd0,  // integer >
+	LT_I        = 0xd1,  // integer <
+	GEQU_I      = 0xd2,  // integer >=
+	LEQU_I      = 0xd3,  // integer <=
+	EQU_I       = 0xd4,  // integer ==
+	NEQU_I      = 0xd5,  // integer !=
+	GT_R        = 0xd8,  // real >
+	LT_R        = 0xd9,  // real <
+	GEQU_R      = 0xda,  // real >=
+	LEQU_R      = 0xdb,  // real <=
+	EQU_R       = 0xdc,  // real ==
+	NEQU_R      = 0xdd,  // real !=
+
+	// arithmetic operations on untagged values
+	ADD_IU      = 0xf0,  // untagged integer +
+	SUB_IU      = 0xf1,  // untagged integer -
+	MUL_IU      = 0xf2,  // untagged integer *
+	DIV_IU      = 0xf3,  // untagged integer /
+	ADD_RU      = 0xf4,  // untagged real +
+	SUB_RU      = 0xf5,  // untagged real -
+	MUL_RU      = 0xf6,  // untagged real *
+	DIV_RU      = 0xf7,  // untagged real /
+
+	// fused instructions (superinstructions) with an inline address operand
+	LOADLOCAL   = 0xc0,  // read local variable
+	LOADGLOBAL  = 0xc1,  // read global variable
+	STORELOCAL  = 0xc2,  // write local variable
+	STOREGLOBAL = 0xc3,  // write global variable
+	JMPIFNOT    = 0xc8,  // conditional jump if the condition is false
+	JMPNOTGT    = 0xc9,  // compare and jump if not >
+	JMPNOTLT    = 0xca,  // compare and jump if not <
+	JMPNOTGEQU  = 0xcb,  // compare and jump if not >=
+	JMPNOTLEQU  = 0xcc,  // compare and jump if not <=
+	JMPNOTEQU   = 0xcd,  // compare and jump if not ==
+	JMPNOTNEQU  = 0xce,  // compare and jump if not !=
+
+	// fused instructions on untagged values with an inline address operand
+	LOADLOCAL_IU    = 0x17,  // read local integer variable untagged
+	LOADLOCAL_RU    = 0x18,  // read local real variable untagged
+	LOADGLOBAL_IU   = 0x19,  // read global integer variable untagged
+	LOADGLOBAL_RU   = 0x1a,  // read global real variable untagged
+	STORELOCAL_IU   = 0x1b,  // write untagged integer to local variable
+	STORELOCAL_RU   = 0x1c,  // write untagged real to local variable
+	STOREGLOBAL_IU  = 0x1d,  // write untagged integer to global variable
+	STOREGLOBAL_RU  = 0x1e,  // write untagged real to global variable
+	JMPNOTGT_IU     = 0x52,  // compare untagged integers and jump if not >
+	JMPNOTLT_IU     = 0x53,  // compare untagged integers and jump if not <
+	JMPNOTGEQU_IU   = 0x54,  // compare untagged integers and jump if not >=
+	JMPNOTLEQU_IU   = 0x55,  // compare untagged integers and jump if not <=
+	JMPNOTEQU_IU    = 0x56,  // compare untagged integers and jump if not ==
+	JMPNOTNEQU_IU   = 0x57,  // compare untagged integers and jump if not !=
+	JMPNOTGT_RU     = 0x58,  // compare untagged reals and jump if not >
+	JMPNOTLT_RU     = 0x59,  // compare untagged reals and jump if not <
+	JMPNOTGEQU_RU   = 0x5a,  // compare untagged reals and jump if not >=
+	JMPNOTLEQU_RU   = 0x5b,  // compare untagged reals and jump if not <=
+	JMPNOTEQU_RU    = 0x5c,  // compare untagged reals and jump if not ==
+	JMPNOTNEQU_RU   = 0x5d,  // compare untagged reals and jump if not !=
+
+	// instructions with pre-decoded operands,
+	// these are only generated internally by the vm's decoder
+	PUSHD       = 0xe0,  // push pre-decoded direct data
+	JMPD        = 0xe1,  // jump to resolved address
+	JMPCNDD     = 0xe2,  // conditional jump to resolved address
+	CALLD       = 0xe3,  // call function at resolved address
+	RETD        = 0xe4,  // return with resolved frame size and argument count
+	ADDFRAMED   = 0xe5,  // create stack frame of resolved size
+	REMFRAMED   = 0xe6,  // remove stack frame of resolved size
+	PUSHUD      = 0xe7,  // push pre-decoded direct data without its descriptor
 };
 
 
@@ -114,6 +221,11 @@ constexpr t_str get_vm_opcode_name(OpCode op)
 		case OpCode::WRMEM:       return "wrmem";
 		case OpCode::RDMEM:       return "rdmem";
 
+		case OpCode::TAG_I:       return "tag_i";
+		case OpCode::TAG_R:       return "tag_r";
+		case OpCode::UNTAG_I:     return "untag_i";
+		case OpCode::UNTAG_R:     return "untag_r";
+
 		case OpCode::USUB:        return "usub";
 		case OpCode::ADD:         return "add";
 		case OpCode::SUB:         return "sub";
@@ -123,12 +235,32 @@ constexpr t_str get_vm_opcode_name(OpCode op)
 		case OpCode::POW:         return "pow";
 		case OpCode::MATMUL:      return "matmul";
 
+		case OpCode::ADD_I:       return "add_i";
+		case OpCode::SUB_I:       return "sub_i";
+		case OpCode::MUL_I:       return "mul_i";
+		case OpCode::DIV_I:       return "div_i";
+		case OpCode::ADD_R:       return "add_r";
+		case OpCode::SUB_R:       return "sub_r";
+		case OpCode::MUL_R:       return "mul_r";
+		case OpCode::DIV_R:       return "div_r";
+
+		case OpCode::ADD_IU:      return "add_iu";
+		case OpCode::SUB_IU:      return "sub_iu";
+		case OpCode::MUL_IU:      return "mul_iu";
+		case OpCode::DIV_IU:      return "div_iu";
+		case OpCode::ADD_RU:      return "add_ru";
+		case OpCode::SUB_RU:      return "sub_ru";
+		case OpCode::MUL_RU:      return "mul_ru";
+		case OpCode::DIV_RU:      return "div_ru";
+
 		case OpCode::TOR:         return "tor";
 		case OpCode::TOI:         return "toi";
 		case OpCode::TOC:         return "toc";
 		case OpCode::TOQ:         return "toq";
 		case OpCode::TOB:         return "tob";
 		case OpCode::TOS:         return "tos";
+		case OpCode::TOR_IU:      return "tor_iu";
+		case OpCode::TOI_RU:      return "toi_ru";
 
 		case OpCode::TOREALARR:   return "torealarr";
 		case OpCode::TOINTARR:    return "tointarr";
@@ -150,6 +282,32 @@ constexpr t_str get_vm_opcode_name(OpCode op)
 		case OpCode::EQU:         return "equ";
 		case OpCode::NEQU:        return "nequ";
 
+		case OpCode::GT_I:        return "gt_i";
+		case OpCode::LT_I:        return "lt_i";
+		case OpCode::GEQU_I:      return "gequ_i";
+		case OpCode::LEQU_I:      return "lequ_i";
+		case OpCode::EQU_I:       return "equ_i";
+		case OpCode::NEQU_I:      return "nequ_i";
+		case OpCode::GT_R:        return "gt_r";
+		case OpCode::LT_R:        return "lt_r";
+		case OpCode::GEQU_R:      return "gequ_r";
+		case OpCode::LEQU_R:      return "lequ_r";
+		case OpCode::EQU_R:       return "equ_r";
+		case OpCode::NEQU_R:      return "nequ_r";
+
+		case OpCode::GT_IU:       return "gt_iu";
+		case OpCode::LT_IU:       return "lt_iu";
+		case OpCode::GEQU_IU:     return "gequ_iu";
+		case OpCode::LEQU_IU:     return "lequ_iu";
+		case OpCode::EQU_IU:      return "equ_iu";
+		case OpCode::NEQU_IU:     return "nequ_iu";
+		case OpCode::GT_RU:       return "gt_ru";
+		case OpCode::LT_RU:       return "lt_ru";
+		case OpCode::GEQU_RU:     return "gequ_ru";
+		case OpCode::LEQU_RU:     return "lequ_ru";
+		case OpCode::EQU_RU:      return "equ_ru";
+		case OpCode::NEQU_RU:     return "nequ_ru";
+
 		case OpCode::CALL:        return "call";
 		case OpCode::RET:         return "ret";
 		case OpCode::EXTCALL:     return "extcall";
@@ -171,12 +329,296 @@ constexpr t_str get_vm_opcode_name(OpCode op)
 
 		case OpCode::RDARR:       return "rdarr";
 		case OpCode::RDARRR:      return "rdarrr";
+		case OpCode::RDARRM:      return "rdarrm";
+		case OpCode::RDARRRM:     return "rdarrrm";
 		case OpCode::WRARR:       return "wrarr";
 		case OpCode::WRARRR:      return "wrarrr";
+		case OpCode::CPARRR:      return "cparrr";
+
+		case OpCode::LOADLOCAL:   return "loadlocal";
+		case OpCode::LOADGLOBAL:  return "loadglobal";
+		case OpCode::STORELOCAL:  return "storelocal";
+		case OpCode::STOREGLOBAL: return "storeglobal";
+		case OpCode::JMPIFNOT:    return "jmpifnot";
+		case OpCode::JMPNOTGT:    return "jmpnotgt";
+		case OpCode::JMPNOTLT:    return "jmpnotlt";
+		case OpCode::JMPNOTGEQU:  return "jmpnotgequ";
+		case OpCode::JMPNOTLEQU:  return "jmpnotlequ";
+		case OpCode::JMPNOTEQU:   return "jmpnotequ";
+		case OpCode::JMPNOTNEQU:  return "jmpnotnequ";
+
+		case OpCode::LOADLOCAL_IU:   return "loadlocal_iu";
+		case OpCode::LOADLOCAL_RU:   return "loadlocal_ru";
+		case OpCode::LOADGLOBAL_IU:  return "loadglobal_iu";
+		case OpCode::LOADGLOBAL_RU:  return "loadglobal_ru";
+		case OpCode::STORELOCAL_IU:  return "storelocal_iu";
+		case OpCode::STORELOCAL_RU:  return "storelocal_ru";
+		case OpCode::STOREGLOBAL_IU: return "storeglobal_iu";
+		case OpCode::STOREGLOBAL_RU: return "storeglobal_ru";
+		case OpCode::JMPNOTGT_IU:    return "jmpnotgt_iu";
+		case OpCode::JMPNOTLT_IU:    return "jmpnotlt_iu";
+		case OpCode::JMPNOTGEQU_IU:  return "jmpnotgequ_iu";
+		case OpCode::JMPNOTLEQU_IU:  return "jmpnotlequ_iu";
+		case OpCode::JMPNOTEQU_IU:   return "jmpnotequ_iu";
+		case OpCode::JMPNOTNEQU_IU:  return "jmpnotnequ_iu";
+		case OpCode::JMPNOTGT_RU:    return "jmpnotgt_ru";
+		case OpCode::JMPNOTLT_RU:    return "jmpnotlt_ru";
+		case OpCode::JMPNOTGEQU_RU:  return "jmpnotgequ_ru";
+		case OpCode::JMPNOTLEQU_RU:  return "jmpnotlequ_ru";
+		case OpCode::JMPNOTEQU_RU:   return "jmpnotequ_ru";
+		case OpCode::JMPNOTNEQU_RU:  return "jmpnotnequ_ru";
+
+		case OpCode::PUSHD:       return "pushd";
+		case OpCode::JMPD:        return "jmpd";
+		case OpCode::JMPCNDD:     return "jmpcndd";
+		case OpCode::CALLD:       return "calld";
+		case OpCode::RETD:        return "retd";
+		case OpCode::ADDFRAMED:   return "addframed";
+		case OpCode::REMFRAMED:   return "remframed";
+		case OpCode::PUSHUD:      return "pushud";
 
 		default:                  return "<unknown>";
 	}
 }
 
 
+/**
+ * does the instruction have an inline address operand?
+ */
+constexpr bool has_vm_addr_operand(OpCode op)
+{
+	switch(op)
+	{
+		case OpCode::LOADLOCAL:
+		case OpCode::LOADGLOBAL:
+		case OpCode::STORELOCAL:
+		case OpCode::STOREGLOBAL:
+		case OpCode::JMPIFNOT:
+		case OpCode::JMPNOTGT:
+		case OpCode::JMPNOTLT:
+		case OpCode::JMPNOTGEQU:
+		case OpCode::JMPNOTLEQU:
+		case OpCode::JMPNOTEQU:
+		case OpCode::JMPNOTNEQU:
+		case OpCode::LOADLOCAL_IU:
+		case OpCode::LOADLOCAL_RU:
+		case OpCode::LOADGLOBAL_IU:
+		case OpCode::LOADGLOBAL_RU:
+		case OpCode::STORELOCAL_IU:
+		case OpCode::STORELOCAL_RU:
+		case OpCode::STOREGLOBAL_IU:
+		case OpCode::STOREGLOBAL_RU:
+		case OpCode::JMPNOTGT_IU:
+		case OpCode::JMPNOTLT_IU:
+		case OpCode::JMPNOTGEQU_IU:
+		case OpCode::JMPNOTLEQU_IU:
+		case OpCode::JMPNOTEQU_IU:
+		case OpCode::JMPNOTNEQU_IU:
+		case OpCode::JMPNOTGT_RU:
+		case OpCode::JMPNOTLT_RU:
+		case OpCode::JMPNOTGEQU_RU:
+		case OpCode::JMPNOTLEQU_RU:
+		case OpCode::JMPNOTEQU_RU:
+		case OpCode::JMPNOTNEQU_RU:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+
+/**
+ * get the fused compare-and-branch instruction that
+ * jumps if the given comparison is false
+ */
+constexpr OpCode get_vm_jump_if_not(OpCode comp)
+{
+	switch(comp)
+	{
+		case OpCode::GT:
+		case OpCode::GT_I:
+		case OpCode::GT_R:        return OpCode::JMPNOTGT;
+		case OpCode::LT:
+		case OpCode::LT_I:
+		case OpCode::LT_R:        return OpCode::JMPNOTLT;
+		case OpCode::GEQU:
+		case OpCode::GEQU_I:
+		case OpCode::GEQU_R:      return OpCode::JMPNOTGEQU;
+		case OpCode::LEQU:
+		case OpCode::LEQU_I:
+		case OpCode::LEQU_R:      return OpCode::JMPNOTLEQU;
+		case OpCode::EQU:
+		case OpCode::EQU_I:
+		case OpCode::EQU_R:       return OpCode::JMPNOTEQU;
+		case OpCode::NEQU:
+		case OpCode::NEQU_I:
+		case OpCode::NEQU_R:      return OpCode::JMPNOTNEQU;
+
+		case OpCode::GT_IU:       return OpCode::JMPNOTGT_IU;
+		case OpCode::LT_IU:       return OpCode::JMPNOTLT_IU;
+		case OpCode::GEQU_IU:     return OpCode::JMPNOTGEQU_IU;
+		case OpCode::LEQU_IU:     return OpCode::JMPNOTLEQU_IU;
+		case OpCode::EQU_IU:      return OpCode::JMPNOTEQU_IU;
+		case OpCode::NEQU_IU:     return OpCode::JMPNOTNEQU_IU;
+		case OpCode::GT_RU:       return OpCode::JMPNOTGT_RU;
+		case OpCode::LT_RU:       return OpCode::JMPNOTLT_RU;
+		case OpCode::GEQU_RU:     return OpCode::JMPNOTGEQU_RU;
+		case OpCode::LEQU_RU:     return OpCode::JMPNOTLEQU_RU;
+		case OpCode::EQU_RU:      return OpCode::JMPNOTEQU_RU;
+		case OpCode::NEQU_RU:     return OpCode::JMPNOTNEQU_RU;
+
+		default:                  return OpCode::INVALID;
+	}
+}
+
+
+/**
+ * get the statically typed variant of an arithmetic or comparison
+ * instruction for integer or real operands, if available
+ */
+constexpr OpCode get_vm_typed_opcode(OpCode op, VMType ty)
+{
+	if(ty == VMType::INT)
+	{
+		switch(op)
+		{
+			case OpCode::ADD:         return OpCode::ADD_I;
+			case OpCode::SUB:         return OpCode::SUB_I;
+			case OpCode::MUL:         return OpCode::MUL_I;
+			case OpCode::DIV:         return OpCode::DIV_I;
+			case OpCode::GT:          return OpCode::GT_I;
+			case OpCode::LT:          return OpCode::LT_I;
+			case OpCode::GEQU:        return OpCode::GEQU_I;
+			case OpCode::LEQU:        return OpCode::LEQU_I;
+			case OpCode::EQU:         return OpCode::EQU_I;
+			case OpCode::NEQU:        return OpCode::NEQU_I;
+			default:                  return op;
+		}
+	}
+	else if(ty == VMType::REAL)
+	{
+		switch(op)
+		{
+			case OpCode::ADD:         return OpCode::ADD_R;
+			case OpCode::SUB:         return OpCode::SUB_R;
+			case OpCode::MUL:         return OpCode::MUL_R;
+			case OpCode::DIV:         return OpCode::DIV_R;
+			case OpCode::GT:          return OpCode::GT_R;
+			case OpCode::LT:          return OpCode::LT_R;
+			case OpCode::GEQU:        return OpCode::GEQU_R;
+			case OpCode::LEQU:        return OpCode::LEQU_R;
+			case OpCode::EQU:         return OpCode::EQU_R;
+			case OpCode::NEQU:        return OpCode::NEQU_R;
+			default:                  return op;
+		}
+	}
+
+	return op;
+}
+
+
+/**
+ * get the type of the untagged operands of an instruction,
+ * the untagged instructions have no contiguous opcode range
+ */
+constexpr VMType get_vm_untagged_type(OpCode op)
+{
+	switch(op)
+	{
+		case OpCode::ADD_IU:
+		case OpCode::SUB_IU:
+		case OpCode::MUL_IU:
+		case OpCode::DIV_IU:
+		case OpCode::GT_IU:
+		case OpCode::LT_IU:
+		case OpCode::GEQU_IU:
+		case OpCode::LEQU_IU:
+		case OpCode::EQU_IU:
+		case OpCode::NEQU_IU:
+		case OpCode::LOADLOCAL_IU:
+		case OpCode::LOADGLOBAL_IU:
+		case OpCode::STORELOCAL_IU:
+		case OpCode::STOREGLOBAL_IU:
+		case OpCode::JMPNOTGT_IU:
+		case OpCode::JMPNOTLT_IU:
+		case OpCode::JMPNOTGEQU_IU:
+		case OpCode::JMPNOTLEQU_IU:
+		case OpCode::JMPNOTEQU_IU:
+		case OpCode::JMPNOTNEQU_IU:
+			return VMType::INT;
+
+		case OpCode::ADD_RU:
+		case OpCode::SUB_RU:
+		case OpCode::MUL_RU:
+		case OpCode::DIV_RU:
+		case OpCode::GT_RU:
+		case OpCode::LT_RU:
+		case OpCode::GEQU_RU:
+		case OpCode::LEQU_RU:
+		case OpCode::EQU_RU:
+		case OpCode::NEQU_RU:
+		case OpCode::LOADLOCAL_RU:
+		case OpCode::LOADGLOBAL_RU:
+		case OpCode::STORELOCAL_RU:
+		case OpCode::STOREGLOBAL_RU:
+		case OpCode::JMPNOTGT_RU:
+		case OpCode::JMPNOTLT_RU:
+		case OpCode::JMPNOTGEQU_RU:
+		case OpCode::JMPNOTLEQU_RU:
+		case OpCode::JMPNOTEQU_RU:
+		case OpCode::JMPNOTNEQU_RU:
+			return VMType::REAL;
+
+		default:
+			return VMType::UNKNOWN;
+	}
+}
+
+
+/**
+ * get the variant of an arithmetic or comparison instruction
+ * for untagged integer or real operands, if available
+ */
+constexpr OpCode get_vm_untagged_opcode(OpCode op, VMType ty)
+{
+	if(ty == VMType::INT)
+	{
+		switch(op)
+		{
+			case OpCode::ADD:         return OpCode::ADD_IU;
+			case OpCode::SUB:         return OpCode::SUB_IU;
+			case OpCode::MUL:         return OpCode::MUL_IU;
+			case OpCode::DIV:         return OpCode::DIV_IU;
+			case OpCode::GT:          return OpCode::GT_IU;
+			case OpCode::LT:          return OpCode::LT_IU;
+			case OpCode::GEQU:        return OpCode::GEQU_IU;
+			case OpCode::LEQU:        return OpCode::LEQU_IU;
+			case OpCode::EQU:         return OpCode::EQU_IU;
+			case OpCode::NEQU:        return OpCode::NEQU_IU;
+			default:                  return OpCode::INVALID;
+		}
+	}
+	else if(ty == VMType::REAL)
+	{
+		switch(op)
+		{
+			case OpCode::ADD:         return OpCode::ADD_RU;
+			case OpCode::SUB:         return OpCode::SUB_RU;
+			case OpCode::MUL:         return OpCode::MUL_RU;
+			case OpCode::DIV:         return OpCode::DIV_RU;
+			case OpCode::GT:          return OpCode::GT_RU;
+			case OpCode::LT:          return OpCode::LT_RU;
+			case OpCode::GEQU:        return OpCode::GEQU_RU;
+			case OpCode::LEQU:        return OpCode::LEQU_RU;
+			case OpCode::EQU:         return OpCode::EQU_RU;
+			case OpCode::NEQU:        return OpCode::NEQU_RU;
+			default:                  return OpCode::INVALID;
+		}
+	}
+
+	return OpCode::INVALID;
+}
+
+
 #endif
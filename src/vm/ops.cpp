@@ -9,15 +9,16 @@
 #include "ops.h"
 
 
+template<bool checks>
 void VM::OpMatrixMultiplication()
 {
-	t_int M2_cols = std::get<m_intidx>(PopData());
-	t_int M2_rows = std::get<m_intidx>(PopData());
-	t_int M1_cols = std::get<m_intidx>(PopData());
-	t_int M1_rows = std::get<m_intidx>(PopData());
+	t_int M2_cols = std::get<m_intidx>(PopData<checks>());
+	t_int M2_rows = std::get<m_intidx>(PopData<checks>());
+	t_int M1_cols = std::get<m_intidx>(PopData<checks>());
+	t_int M1_rows = std::get<m_intidx>(PopData<checks>());
 
-	t_data M2 = PopData();
-	t_data M1 = PopData();
+	t_data M2 = PopData<checks>();
+	t_data M1 = PopData<checks>();
 
 	auto mat_mult = [&M1, &M2, M1_cols, M1_rows, M2_cols, M2_rows]<class t_vec>()
 		-> std::pair<bool, t_data>
@@ -60,5 +61,9 @@ void VM::OpMatrixMultiplication()
 	else if(auto [ ok, res ] = mat_mult.template operator()<t_vec_cplx>(); ok)
 		result = std::move(res);
 
-	PushData(result);
+	PushData<checks>(result);
 }
+
+
+template void VM::OpMatrixMultiplication<true>();
+template void VM::OpMatrixMultiplication<false>();
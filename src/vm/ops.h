@@ -21,11 +21,11 @@
 /**
  * cast from one variable type to the other
  */
-template<std::size_t toidx>
+template<std::size_t toidx, bool checks>
 void VM::OpCast()
 {
 	using t_to = std::variant_alternative_t<toidx, t_data>;
-	t_data data = TopData();
+	t_data data = TopData<checks>();
 
 	// casting from real
 	if(data.index() == m_realidx)
@@ -44,15 +44,15 @@ void VM::OpCast()
 			std::ostringstream ostr;
 			ostr.precision(m_prec);
 			ostr << val;
-			PopData();
-			PushData(t_data{std::in_place_index<m_stridx>, ostr.str()});
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<m_stridx>, ostr.str()});
 		}
 
 		// convert to primitive type
 		else
 		{
-			PopData();
-			PushData(t_data{std::in_place_index<toidx>,
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<toidx>,
 				static_cast<t_to>(val)});
 		}
 	}
@@ -71,15 +71,15 @@ void VM::OpCast()
 			std::ostringstream ostr;
 			ostr.precision(m_prec);
 			ostr << val;
-			PopData();
-			PushData(t_data{std::in_place_index<m_stridx>, ostr.str()});
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<m_stridx>, ostr.str()});
 		}
 
 		// convert to primitive type
 		else
 		{
-			PopData();
-			PushData(t_data{std::in_place_index<toidx>,
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<toidx>,
 				static_cast<t_to>(val)});
 		}
 	}
@@ -106,8 +106,8 @@ void VM::OpCast()
 			std::ostringstream ostr;
 			ostr.precision(m_prec);
 			ostr << "(" << real << ", " << imag << ")";
-			PopData();
-			PushData(t_data{std::in_place_index<m_stridx>, ostr.str()});
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<m_stridx>, ostr.str()});
 		}
 
 		// convert to primitive type
@@ -148,8 +148,8 @@ void VM::OpCast()
 			std::ostringstream ostr;
 			ostr.precision(m_prec);
 			ostr << "(" << real << ", " << imag1 << ", " << imag2 << ", " << imag3 << ")";
-			PopData();
-			PushData(t_data{std::in_place_index<m_stridx>, ostr.str()});
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<m_stridx>, ostr.str()});
 		}
 
 		// convert to primitive type
@@ -176,15 +176,15 @@ void VM::OpCast()
 			std::ostringstream ostr;
 			ostr.precision(m_prec);
 			ostr << std::boolalpha << val;
-			PopData();
-			PushData(t_data{std::in_place_index<m_stridx>, ostr.str()});
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<m_stridx>, ostr.str()});
 		}
 
 		// convert to primitive type
 		else
 		{
-			PopData();
-			PushData(t_data{std::in_place_index<toidx>,
+			PopData<checks>();
+			PushData<checks>(t_data{std::in_place_index<toidx>,
 				static_cast<t_to>(val)});
 		}
 	}
@@ -201,32 +201,32 @@ void VM::OpCast()
 
 		t_to conv_val{};
 		std::istringstream{val} >> conv_val;
-		PopData();
-		PushData(t_data{std::in_place_index<toidx>, conv_val});
+		PopData<checks>();
+		PushData<checks>(t_data{std::in_place_index<toidx>, conv_val});
 	}
 
 	// casting from real array
 	else if(data.index() == m_realarridx)
 	{
-		OpCastFromArray<t_to, t_vec_real>(data);
+		OpCastFromArray<t_to, t_vec_real, checks>(data);
 	}
 
 	// casting from int array
 	else if(data.index() == m_intarridx)
 	{
-		OpCastFromArray<t_to, t_vec_int>(data);
+		OpCastFromArray<t_to, t_vec_int, checks>(data);
 	}
 
 	// casting from complex array
 	else if(data.index() == m_cplxarridx)
 	{
-		OpCastFromArray<t_to, t_vec_cplx>(data);
+		OpCastFromArray<t_to, t_vec_cplx, checks>(data);
 	}
 
 	// casting from quaternion array
 	else if(data.index() == m_quatarridx)
 	{
-		OpCastFromArray<t_to, t_vec_quat>(data);
+		OpCastFromArray<t_to, t_vec_quat, checks>(data);
 	}
 }
 
@@ -234,7 +234,7 @@ void VM::OpCast()
 /**
  * cast from an array variable type
  */
-template<class t_to, class t_vec>
+template<class t_to, class t_vec, bool checks>
 void VM::OpCastFromArray(const t_data& data)
 {
         using t_elem = typename t_vec::value_type;
@@ -265,8 +265,8 @@ void VM::OpCastFromArray(const t_data& data)
 		}
 		ostr << " ]";
 
-		PopData();
-		PushData(t_data{std::in_place_index<m_stridx>, ostr.str()});
+		PopData<checks>();
+		PushData<checks>(t_data{std::in_place_index<m_stridx>, ostr.str()});
 	}
 	else
 	{
@@ -281,14 +281,14 @@ void VM::OpCastFromArray(const t_data& data)
 /**
  * cast to an array variable type
  */
-template<class t_vec_to>
+template<class t_vec_to, bool checks>
 void VM::OpCastToArray(t_addr size)
 {
 	using t_elem = typename t_vec_to::value_type;
 	constexpr const std::size_t vec_idx = GetDataTypeIndex<t_vec_to>();
 
 	//using t_to = std::variant_alternative_t<toidx, t_data>;
-	t_data data = TopData();
+	t_data data = TopData<checks>();
 
 	// conversion error
 	auto throw_err = [&data]()
@@ -308,26 +308,26 @@ void VM::OpCastToArray(t_addr size)
 	else if(data.index() == m_realidx)
 	{
 		t_real val = std::get<m_realidx>(data);
-		PopData();
+		PopData<checks>();
 
 		// set every element of the array to the real value
 		t_vec_to vec = m::create<t_vec_to>(size);
 		for(t_addr i = 0; i < size; ++i)
 			vec[i] = t_elem(val);
-		PushData(t_data{std::in_place_index<vec_idx>, vec});
+		PushData<checks>(t_data{std::in_place_index<vec_idx>, vec});
 	}
 
 	// casting from int
 	else if(data.index() == m_intidx)
 	{
 		t_int val = std::get<m_intidx>(data);
-		PopData();
+		PopData<checks>();
 
 		// set every element of the array to the int value
 		t_vec_to vec = m::create<t_vec_to>(size);
 		for(t_addr i = 0; i < size; ++i)
 			vec[i] = t_elem(val);
-		PushData(t_data{std::in_place_index<vec_idx>, vec});
+		PushData<checks>(t_data{std::in_place_index<vec_idx>, vec});
 	}
 
 	// casting from complex scalar
@@ -337,13 +337,13 @@ void VM::OpCastToArray(t_addr size)
 		if constexpr(std::is_same_v<std::decay_t<t_elem>, t_cplx>)
 		{
 			const t_elem& val = std::get<m_cplxidx>(data);
-			PopData();
+			PopData<checks>();
 
 			// set every element of the array to the int value
 			t_vec_to vec = m::create<t_vec_to>(size);
 			for(t_addr i = 0; i < size; ++i)
 				vec[i] = val;
-			PushData(t_data{std::in_place_index<vec_idx>, vec});
+			PushData<checks>(t_data{std::in_place_index<vec_idx>, vec});
 		}
 		else
 		{
@@ -358,13 +358,13 @@ void VM::OpCastToArray(t_addr size)
 		if constexpr(std::is_same_v<std::decay_t<t_elem>, t_quat>)
 		{
 			const t_elem& val = std::get<m_quatidx>(data);
-			PopData();
+			PopData<checks>();
 
 			// set every element of the array to the int value
 			t_vec_to vec = m::create<t_vec_to>(size);
 			for(t_addr i = 0; i < size; ++i)
 				vec[i] = val;
-			PushData(t_data{std::in_place_index<vec_idx>, vec});
+			PushData<checks>(t_data{std::in_place_index<vec_idx>, vec});
 		}
 		else
 		{
@@ -462,11 +462,23 @@ t_val VM::OpArithmeticSameType(const t_val& val1, const t_val& val2)
 /**
  * arithmetic operation
  */
-template<char op>
-void VM::OpArithmetic()
+template<char op, bool checks>
+void VM::OpArithmetic(VMType proven)
 {
-	t_data val2 = PopData();
-	t_data val1 = PopData();
+	// operand types proven by the verifier
+	if(proven == VMType::INT)
+	{
+		OpArithmeticRaw<t_int, op>();
+		return;
+	}
+	else if(proven == VMType::REAL)
+	{
+		OpArithmeticRaw<t_real, op>();
+		return;
+	}
+
+	t_data val2 = PopData<checks>();
+	t_data val1 = PopData<checks>();
 	std::optional<t_data> result;
 
 	auto dot_prod = []<class t_vec>(const t_data& val1, const t_data& val2)
@@ -669,18 +681,18 @@ void VM::OpArithmetic()
 		throw std::runtime_error(err.str());
 	}
 
-	PushData(*result);
+	PushData<checks>(*result);
 }
 
 
 /**
  * logical operation
  */
-template<char op>
+template<char op, bool checks>
 void VM::OpLogical()
 {
-	bool val2 = PopBool();
-	bool val1 = PopBool();
+	bool val2 = PopBool<checks>();
+	bool val1 = PopBool<checks>();
 
 	bool result = false;
 
@@ -691,7 +703,7 @@ void VM::OpLogical()
 	else if constexpr(op == '^')
 		result = val1 ^ val2;
 
-	PushBool(result);
+	PushBool<checks>(result);
 }
 
 
@@ -729,11 +741,11 @@ t_val VM::OpBinarySameType(const t_val& val1, const t_val& val2)
 /**
  * binary operation
  */
-template<char op>
+template<char op, bool checks>
 void VM::OpBinary()
 {
-	t_data val2 = PopData();
-	t_data val1 = PopData();
+	t_data val2 = PopData<checks>();
+	t_data val1 = PopData<checks>();
 
 	if(val1.index() != val2.index())
 	{
@@ -758,7 +770,7 @@ void VM::OpBinary()
 		throw std::runtime_error("Invalid type in binary operation.");
 	}
 
-	PushData(result);
+	PushData<checks>(result);
 }
 
 
@@ -821,13 +833,25 @@ bool VM::OpComparisonSameType(const t_val& val1, const t_val& val2)
 
 
 /**
- * comparison operation
+ * comparison operation, returning the result instead of pushing it
  */
-template<OpCode op>
-void VM::OpComparison()
+template<OpCode op, bool checks>
+bool VM::OpCompare(VMType proven)
 {
-	t_data val2 = PopData();
-	t_data val1 = PopData();
+	// operand types proven by the verifier
+	if(proven == VMType::INT)
+		return OpCompareRaw<t_int, op, checks>();
+	if(proven == VMType::REAL)
+		return OpCompareRaw<t_real, op, checks>();
+
+	// directly compare integers or reals
+	if(HasTopScalars<t_int, checks>())
+		return OpCompareRaw<t_int, op, checks>();
+	if(HasTopScalars<t_real, checks>())
+		return OpCompareRaw<t_real, op, checks>();
+
+	t_data val2 = PopData<checks>();
+	t_data val1 = PopData<checks>();
 
 	if(val1.index() != val2.index())
 	{
@@ -871,7 +895,276 @@ void VM::OpComparison()
 		throw std::runtime_error("Invalid type in comparison operation.");
 	}
 
-	PushBool(result);
+	return result;
+}
+
+
+/**
+ * comparison operation
+ */
+template<OpCode op, bool checks>
+void VM::OpComparison(VMType proven)
+{
+	// the result of operands with proven types is directly pushed,
+	// it is smaller than the popped operands
+	if(proven == VMType::INT || proven == VMType::REAL)
+	{
+		const bool result = OpCompare<op, checks>(proven);
+		PushPadding<checks>(GetDataTypeSize<t_bool>());
+		PushRaw<t_bool, GetDataTypeSize<t_bool>(), checks>(static_cast<t_bool>(result));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::BOOL));
+		return;
+	}
+
+	PushBool<checks>(OpCompare<op, checks>());
+}
+
+
+/**
+ * are the two values on top of the stack scalars of the given type?
+ */
+template<class t_val, bool checks>
+bool VM::HasTopScalars() const
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const t_byte ty = static_cast<t_byte>(
+		std::is_same_v<std::decay_t<t_val>, t_int> ? VMType::INT : VMType::REAL);
+
+	// stack layout: [descriptor 2] [value 2] [descriptor 1] [value 1]
+	return TopRaw<t_byte, m_descrsize, checks>() == ty &&
+		TopRaw<t_byte, m_descrsize, checks>(vm_slot_size(m_descrsize + valsize)) == ty;
+}
+
+
+/**
+ * arithmetic operation on raw integers or reals on the stack,
+ * the operand types are not tested
+ */
+template<class t_val, char op, bool checks>
+void VM::OpArithmeticRaw()
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+
+	const t_byte ty = PopRaw<t_byte, m_descrsize, checks>();
+	t_val val2 = PopRaw<t_val, valsize, checks>();
+	PopPadding<checks>(valsize);
+	PopRaw<t_byte, m_descrsize, checks>();
+	t_val val1 = PopRaw<t_val, valsize, checks>();
+	PopPadding<checks>(valsize);
+
+	PushPadding<checks>(valsize);
+	PushRaw<t_val, valsize, checks>(OpArithmeticSameType<t_val, op>(val1, val2));
+	PushRaw<t_byte, m_descrsize, checks>(ty);
+}
+
+
+/**
+ * comparison operation on raw integers or reals on the stack,
+ * the operand types are not tested
+ */
+template<class t_val, OpCode op, bool checks>
+bool VM::OpCompareRaw()
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+
+	PopRaw<t_byte, m_descrsize, checks>();
+	t_val val2 = PopRaw<t_val, valsize, checks>();
+	PopPadding<checks>(valsize);
+	PopRaw<t_byte, m_descrsize, checks>();
+	t_val val1 = PopRaw<t_val, valsize, checks>();
+	PopPadding<checks>(valsize);
+
+	return OpComparisonSameType<t_val, op>(val1, val2);
+}
+
+
+/**
+ * arithmetic operation on raw integers or reals on the stack,
+ * falls back to the generic operation for other operand types
+ */
+template<class t_val, char op, bool checks>
+void VM::OpArithmeticTyped(VMType proven)
+{
+	// operand types proven by the verifier
+	if(proven == VMType::INT)
+		OpArithmeticRaw<t_int, op, checks>();
+	else if(proven == VMType::REAL)
+		OpArithmeticRaw<t_real, op, checks>();
+	else if(HasTopScalars<t_val, checks>())
+		OpArithmeticRaw<t_val, op, checks>();
+	else
+		OpArithmetic<op, checks>();
+}
+
+
+/**
+ * comparison operation on raw integers or reals on the stack,
+ * falls back to the generic operation for other operand types
+ */
+template<class t_val, OpCode op, bool checks>
+bool VM::OpCompareTyped(VMType proven)
+{
+	if(proven != VMType::UNKNOWN || !HasTopScalars<t_val, checks>())
+		return OpCompare<op, checks>(proven);
+
+	return OpCompareRaw<t_val, op, checks>();
+}
+
+
+/**
+ * comparison operation on raw integers or reals on the stack
+ */
+template<class t_val, OpCode op, bool checks>
+void VM::OpComparisonTyped(VMType proven)
+{
+	if(proven != VMType::UNKNOWN)
+		OpComparison<op, checks>(proven);
+	else
+		PushBool<checks>(OpCompareTyped<t_val, op, checks>());
+}
+
+
+/**
+ * add the type descriptor to the untagged integer or real on top of the stack
+ */
+template<class t_val, bool checks>
+void VM::OpTag()
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const t_byte ty = static_cast<t_byte>(
+		std::is_same_v<std::decay_t<t_val>, t_int> ? VMType::INT : VMType::REAL);
+
+	t_val val = PopUntagged<t_val, checks>();
+	PushPadding<checks>(valsize);
+	PushRaw<t_val, valsize, checks>(val);
+	PushRaw<t_byte, m_descrsize, checks>(ty);
+}
+
+
+/**
+ * remove the type descriptor from the integer or real on top of the stack,
+ * the type is only tested if it has not been proven by the verifier
+ */
+template<class t_val, bool checks>
+void VM::OpUntag(VMType proven)
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const VMType ty = std::is_same_v<std::decay_t<t_val>, t_int>
+		? VMType::INT : VMType::REAL;
+
+	if(proven != ty && TopRaw<t_byte, m_descrsize, checks>() != static_cast<t_byte>(ty))
+	{
+		std::ostringstream err;
+		err << "Type mismatch in untagging operation, expected "
+			<< GetDataTypeName(GetDataTypeIndex<t_val>()) << ".";
+		throw std::runtime_error(err.str());
+	}
+
+	PopRaw<t_byte, m_descrsize, checks>();
+	t_val val = PopRaw<t_val, valsize, checks>();
+	PopPadding<checks>(valsize);
+	PushUntagged<t_val, checks>(val);
+}
+
+
+/**
+ * push the integer or real variable at the given address without its type descriptor,
+ * the type is only tested if it has not been proven by the verifier
+ */
+template<class t_val, bool checks>
+void VM::OpLoadUntagged(t_addr addr, VMType proven)
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const VMType ty = std::is_same_v<std::decay_t<t_val>, t_int>
+		? VMType::INT : VMType::REAL;
+
+	if constexpr(checks)
+		CheckMemoryBounds<checks>(addr, m_descrsize + valsize);
+
+	if(proven != ty && m_mem[addr] != static_cast<t_byte>(ty))
+	{
+		std::ostringstream err;
+		err << "Type mismatch in untagged read of variable at address "
+			<< addr << ", expected " << GetDataTypeName(GetDataTypeIndex<t_val>()) << ".";
+		throw std::runtime_error(err.str());
+	}
+
+	t_val val{};
+	std::memcpy(&val, m_mem.get() + addr + m_descrsize, valsize);
+	PushUntagged<t_val, checks>(val);
+}
+
+
+/**
+ * write the untagged integer or real on top of the stack to
+ * the variable at the given address, including its type descriptor
+ */
+template<class t_val, bool checks>
+void VM::OpStoreUntagged(t_addr addr)
+{
+	constexpr const t_addr valsize = GetDataTypeSize<t_val>();
+	constexpr const t_byte ty = static_cast<t_byte>(
+		std::is_same_v<std::decay_t<t_val>, t_int> ? VMType::INT : VMType::REAL);
+
+	t_val val = PopUntagged<t_val, checks>();
+
+	if constexpr(checks)
+		CheckMemoryBounds<checks>(addr, m_descrsize + valsize);
+
+	m_mem[addr] = ty;
+	std::memcpy(m_mem.get() + addr + m_descrsize, &val, valsize);
+}
+
+
+/**
+ * cast between untagged integers and reals
+ */
+template<class t_from, class t_to, bool checks>
+void VM::OpCastUntagged()
+{
+	PushUntagged<t_to, checks>(static_cast<t_to>(PopUntagged<t_from, checks>()));
+}
+
+
+/**
+ * arithmetic operation on untagged integers or reals on the stack
+ */
+template<class t_val, char op, bool checks>
+void VM::OpArithmeticUntagged()
+{
+	t_val val2 = PopUntagged<t_val, checks>();
+	t_val val1 = PopUntagged<t_val, checks>();
+
+	PushUntagged<t_val, checks>(OpArithmeticSameType<t_val, op>(val1, val2));
+}
+
+
+/**
+ * comparison operation on untagged integers or reals on the stack,
+ * returning the result instead of pushing it
+ */
+template<class t_val, OpCode op, bool checks>
+bool VM::OpCompareUntagged()
+{
+	t_val val2 = PopUntagged<t_val, checks>();
+	t_val val1 = PopUntagged<t_val, checks>();
+
+	return OpComparisonSameType<t_val, op>(val1, val2);
+}
+
+
+/**
+ * comparison operation on untagged integers or reals on the stack,
+ * the result is pushed as (tagged) bool
+ */
+template<class t_val, OpCode op, bool checks>
+void VM::OpComparisonUntagged()
+{
+	const bool result = OpCompareUntagged<t_val, op, checks>();
+
+	PushPadding<checks>(GetDataTypeSize<t_bool>());
+	PushRaw<t_bool, GetDataTypeSize<t_bool>(), checks>(static_cast<t_bool>(result));
+	PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::BOOL));
 }
 
 
@@ -0,0 +1,317 @@
+/**
+ * zero-address code vm, opcode and function profiler
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+
+/**
+ * clear all statistics
+ */
+void VMProfiler::Reset()
+{
+	m_op_counts.fill(0);
+	m_op_ticks.fill(0);
+	m_funcs.clear();
+	m_callstack.clear();
+
+	m_cur_op = OpCode::INVALID;
+	m_cur_start = m_start = 0;
+	m_total_ticks = 0;
+	m_running = false;
+}
+
+
+/**
+ * start the time measurement
+ */
+void VMProfiler::Start()
+{
+	if(m_running)
+		return;
+
+	m_running = true;
+	m_cur_op = OpCode::INVALID;
+	m_cur_start = m_start = GetTicks();
+}
+
+
+/**
+ * stop the time measurement, ends the last instruction
+ * and the functions that have not returned (e.g. after a halt)
+ */
+void VMProfiler::Stop()
+{
+	if(!m_running)
+		return;
+
+	CountOp(OpCode::INVALID);
+	while(!m_callstack.empty())
+		ExitFunc();
+
+	m_total_ticks += GetTicks() - m_start;
+	m_running = false;
+}
+
+
+/**
+ * a function has been called
+ */
+void VMProfiler::EnterFunc(t_vm_addr funcaddr)
+{
+	FuncProfile& func = m_funcs[funcaddr];
+	++func.calls;
+	++func.active;
+
+	m_callstack.emplace_back(ActiveFunc
+	{
+		.addr = funcaddr,
+		.start = GetTicks(),
+		.child_ticks = 0,
+	});
+}
+
+
+/**
+ * the innermost function has returned
+ */
+void VMProfiler::ExitFunc()
+{
+	// return without a call, e.g. from an interrupt service routine
+	// that has been entered before the profiling was started
+	if(m_callstack.empty())
+		return;
+
+	const ActiveFunc active = m_callstack.back();
+	m_callstack.pop_back();
+
+	const t_ticks ticks = GetTicks() - active.start;
+	FuncProfile& func = m_funcs[active.addr];
+	func.self_ticks += ticks - std::min(ticks, active.child_ticks);
+
+	// only count the outermost of recursive calls for the total time
+	if(--func.active == 0)
+		func.ticks += ticks;
+
+	if(!m_callstack.empty())
+		m_callstack.back().child_ticks += ticks;
+}
+
+
+/**
+ * write a report sorted by the time spent in the opcodes and functions
+ */
+void VMProfiler::WriteReport(std::ostream& ostr, bool json,
+	const DebugInfo* debuginfo) const
+{
+	// opcodes sorted by time
+	std::vector<t_byte_idx> ops;
+	for(std::size_t op = 0; op < m_op_counts.size(); ++op)
+	{
+		// the invalid opcode holds the time before the first instruction
+		if(m_op_counts[op] == 0 || static_cast<OpCode>(op) == OpCode::INVALID)
+			continue;
+		ops.push_back(static_cast<t_byte_idx>(op));
+	}
+
+	std::stable_sort(ops.begin(), ops.end(),
+		[this](t_byte_idx op1, t_byte_idx op2) -> bool
+	{
+		return m_op_ticks[op1] > m_op_ticks[op2];
+	});
+
+	// functions sorted by total time
+	std::vector<std::pair<t_vm_addr, FuncProfile>> funcs{m_funcs.begin(), m_funcs.end()};
+	std::sort(funcs.begin(), funcs.end(),
+		[](const auto& func1, const auto& func2) -> bool
+	{
+		if(func1.second.ticks == func2.second.ticks)
+			return func1.first < func2.first;
+		return func1.second.ticks > func2.second.ticks;
+	});
+
+	std::size_t total_ops = 0;
+	for(t_byte_idx op : ops)
+		total_ops += m_op_counts[op];
+
+	// function names and lines from the debug info
+	auto get_func = [debuginfo](t_vm_addr addr) -> const DebugInfo::Func*
+	{
+		if(!debuginfo)
+			return nullptr;
+
+		const DebugInfo::Func* func = debuginfo->GetFunc(addr);
+		if(func && func->addr != addr)
+			return nullptr;
+		return func;
+	};
+
+	auto percentage = [this](t_ticks ticks) -> double
+	{
+		if(m_total_ticks == 0)
+			return 0.;
+		return double(ticks) / double(m_total_ticks) * 100.;
+	};
+
+	if(json)
+	{
+		ostr << "{\n";
+		ostr << "\t\"unit\": \"" << GetTickUnit() << "\",\n";
+		ostr << "\t\"total_ticks\": " << m_total_ticks << ",\n";
+		ostr << "\t\"total_instructions\": " << total_ops << ",\n";
+
+		ostr << "\t\"opcodes\": [";
+		for(std::size_t idx = 0; idx < ops.size(); ++idx)
+		{
+			const t_byte_idx op = ops[idx];
+			ostr << (idx == 0 ? "\n" : ",\n")
+				<< "\t\t{ \"name\": \"" << get_vm_opcode_name(static_cast<OpCode>(op)) << "\""
+				<< ", \"opcode\": " << static_cast<unsigned>(op)
+				<< ", \"count\": " << m_op_counts[op]
+				<< ", \"ticks\": " << m_op_ticks[op] << " }";
+		}
+		ostr << "\n\t],\n";
+
+		ostr << "\t\"functions\": [";
+		for(std::size_t idx = 0; idx < funcs.size(); ++idx)
+		{
+			const auto& [addr, func] = funcs[idx];
+			ostr << (idx == 0 ? "\n" : ",\n")
+				<< "\t\t{ \"address\": " << addr;
+			if(const DebugInfo::Func* dbgfunc = get_func(addr))
+			{
+				ostr << ", \"name\": \"" << dbgfunc->name << "\"";
+				// no line if the name is from the function table
+				if(dbgfunc->line > 0)
+					ostr << ", \"line\": " << dbgfunc->line;
+			}
+			ostr << ", \"calls\": " << func.calls
+				<< ", \"ticks\": " << func.ticks
+				<< ", \"self_ticks\": " << func.self_ticks << " }";
+		}
+		ostr << "\n\t]\n";
+		ostr << "}" << std::endl;
+		return;
+	}
+
+	const std::ios_base::fmtflags flags = ostr.flags();
+	const std::streamsize prec = ostr.precision();
+	ostr << std::fixed << std::setprecision(2);
+
+	ostr << "Profile: " << total_ops << " instructions, "
+		<< m_total_ticks << " " << GetTickUnit() << ".\n";
+
+	ostr << "\n"
+		<< std::left << std::setw(16) << "opcode"
+		<< std::right << std::setw(16) << "count"
+		<< std::setw(20) << GetTickUnit()
+		<< std::setw(10) << "%"
+		<< std::setw(14) << "per op" << "\n";
+	for(t_byte_idx op : ops)
+	{
+		ostr << std::left << std::setw(16) << get_vm_opcode_name(static_cast<OpCode>(op))
+			<< std::right << std::setw(16) << m_op_counts[op]
+			<< std::setw(20) << m_op_ticks[op]
+			<< std::setw(10) << percentage(m_op_ticks[op])
+			<< std::setw(14) << double(m_op_ticks[op]) / double(m_op_counts[op])
+			<< "\n";
+	}
+
+	if(funcs.size())
+	{
+		ostr << "\n"
+			<< std::left << std::setw(24) << "function"
+			<< std::right << std::setw(16) << "calls"
+			<< std::setw(20) << GetTickUnit()
+			<< std::setw(10) << "%"
+			<< std::setw(20) << "self"
+			<< std::setw(10) << "self %" << "\n";
+		for(const auto& [addr, func] : funcs)
+		{
+			std::ostringstream name;
+			if(const DebugInfo::Func* dbgfunc = get_func(addr))
+			{
+				name << dbgfunc->name;
+				if(dbgfunc->line > 0)
+					name << " (line " << dbgfunc->line << ")";
+			}
+			else
+				name << addr;
+
+			ostr << std::left << std::setw(24) << name.str()
+				<< std::right << std::setw(16) << func.calls
+				<< std::setw(20) << func.ticks
+				<< std::setw(10) << percentage(func.ticks)
+				<< std::setw(20) << func.self_ticks
+				<< std::setw(10) << percentage(func.self_ticks)
+				<< "\n";
+		}
+	}
+
+	ostr.flush();
+	ostr.flags(flags);
+	ostr.precision(prec);
+}
+
+
+/**
+ * total number of call stack samples
+ */
+std::size_t VMProfiler::GetNumSamples() const
+{
+	std::size_t num = 0;
+	for(const auto& [stack, count] : m_samples)
+		num += count;
+	return num;
+}
+
+
+/**
+ * write the samples in the folded stack format, one line per call stack:
+ * "outermost;...;innermost count", using the function names from the
+ * debug info or the raw code addresses if none is available
+ */
+void VMProfiler::WriteFoldedStacks(std::ostream& ostr, const DebugInfo* debuginfo) const
+{
+	auto get_name = [debuginfo](t_vm_addr addr) -> t_vm_str
+	{
+		if(!debuginfo)
+		{
+			std::ostringstream ostr;
+			ostr << "0x" << std::hex << addr;
+			return ostr.str();
+		}
+
+		if(const DebugInfo::Func* func = debuginfo->GetFunc(addr))
+			return func->name;
+
+		// code outside of functions
+		return debuginfo->GetSourceFile().size() ? debuginfo->GetSourceFile() : "main";
+	};
+
+	// merge the stacks that map to the same functions
+	std::map<t_vm_str, std::size_t> folded;
+	for(const auto& [stack, count] : m_samples)
+	{
+		t_vm_str names;
+		for(auto iter = stack.rbegin(); iter != stack.rend(); ++iter)
+		{
+			if(names.size())
+				names += ";";
+			names += get_name(*iter);
+		}
+
+		folded[names] += count;
+	}
+
+	for(const auto& [names, count] : folded)
+		ostr << names << " " << count << "\n";
+	ostr.flush();
+}
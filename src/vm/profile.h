@@ -0,0 +1,152 @@
+/**
+ * zero-address code vm, opcode and function profiler
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __0ACVM_PROFILE_H__
+#define __0ACVM_PROFILE_H__
+
+
+#include <array>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <iostream>
+#include <chrono>
+#include <cstdint>
+
+#include "opcodes.h"
+#include "types.h"
+#include "debuginfo.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	#include <x86intrin.h>
+	#define VM_PROFILE_RDTSC 1
+#else
+	#define VM_PROFILE_RDTSC 0
+#endif
+
+
+
+/**
+ * counts the executed instructions and accumulates the time spent
+ * in each opcode and function while the interpreter is running,
+ * and collects the call stack samples of the sampling profiler
+ */
+class VMProfiler
+{
+public:
+	using t_ticks = std::uint64_t;
+
+
+	/**
+	 * statistics of a function, identified by its entry address
+	 */
+	struct FuncProfile
+	{
+		std::size_t calls{0};        // number of calls
+		t_ticks ticks{0};            // time including the called functions
+		t_ticks self_ticks{0};       // time excluding the called functions
+		std::size_t active{0};       // number of currently running (recursive) calls
+	};
+
+
+	/**
+	 * reads the time stamp counter or, if not available,
+	 * the monotonic clock in nanoseconds
+	 */
+	static t_ticks GetTicks()
+	{
+#if VM_PROFILE_RDTSC != 0
+		return static_cast<t_ticks>(__rdtsc());
+#else
+		return static_cast<t_ticks>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+
+	/**
+	 * name of the time unit used by GetTicks()
+	 */
+	static constexpr const char* GetTickUnit()
+	{
+#if VM_PROFILE_RDTSC != 0
+		return "cycles";
+#else
+		return "ns";
+#endif
+	}
+
+
+public:
+	void Reset();
+	void Start();
+	void Stop();
+
+	/**
+	 * the given opcode has been fetched, this ends the previous instruction
+	 */
+	void CountOp(OpCode op)
+	{
+		const t_ticks now = GetTicks();
+		const t_byte_idx prev = static_cast<t_byte_idx>(m_cur_op);
+
+		++m_op_counts[prev];
+		m_op_ticks[prev] += now - m_cur_start;
+
+		m_cur_op = op;
+		m_cur_start = now;
+	}
+
+	void EnterFunc(t_vm_addr funcaddr);
+	void ExitFunc();
+
+	// write a report sorted by the time spent, with function names if debug info is given
+	void WriteReport(std::ostream& ostr, bool json = false,
+		const DebugInfo* debuginfo = nullptr) const;
+
+	// call stack samples, innermost code address first
+	void ResetSamples() { m_samples.clear(); }
+	void AddSample(std::vector<t_vm_addr>&& stack) { ++m_samples[std::move(stack)]; }
+	std::size_t GetNumSamples() const;
+
+	// write the samples in the folded stack format used by flamegraph tools
+	void WriteFoldedStacks(std::ostream& ostr, const DebugInfo* debuginfo = nullptr) const;
+
+
+private:
+	using t_byte_idx = std::uint8_t;
+
+	// running function: [ entry address, start time, time spent in called functions ]
+	struct ActiveFunc
+	{
+		t_vm_addr addr{0};
+		t_ticks start{0};
+		t_ticks child_ticks{0};
+	};
+
+	// number of executions and time per opcode
+	std::array<std::size_t, 256> m_op_counts{};
+	std::array<t_ticks, 256> m_op_ticks{};
+
+	// currently executing opcode and its start time
+	OpCode m_cur_op{OpCode::INVALID};
+	t_ticks m_cur_start{0};
+	bool m_running{false};
+
+	// total profiled time
+	t_ticks m_start{0}, m_total_ticks{0};
+
+	// statistics per function entry address
+	std::unordered_map<t_vm_addr, FuncProfile> m_funcs{};
+	std::vector<ActiveFunc> m_callstack{};
+
+	// number of samples per call stack
+	std::map<std::vector<t_vm_addr>, std::size_t> m_samples{};
+};
+
+
+#endif
@@ -12,34 +12,236 @@
 #include <iostream>
 
 
+/**
+ * dispatch the instructions using a table of handler labels
+ * (computed goto, a gcc and clang extension) if available,
+ * otherwise fall back to the switch statement
+ */
+#if defined(USE_COMPUTED_GOTO) && (defined(__GNUC__) || defined(__clang__))
+	#define VM_THREADED_DISPATCH 1
+#else
+	#define VM_THREADED_DISPATCH 0
+#endif
+
+#if VM_THREADED_DISPATCH != 0
+	#define VM_CASE(opcode) case OpCode::opcode: op_##opcode
+	#define VM_DEFAULT default: op_invalid
+	#define VM_HANDLER(opcode) dispatch_table[static_cast<t_byte>(OpCode::opcode)] = &&op_##opcode
+
+	// directly jump to the next instruction's handler,
+	// only use outside of scopes with local objects, as their
+	// destructors are not called when leaving via a computed goto
+	#define VM_NEXT { ++num_ops; op = fetch_op(); \
+		goto *dispatch_table[static_cast<t_byte>(op)]; }
+#else
+	#define VM_CASE(opcode) case OpCode::opcode
+	#define VM_DEFAULT default
+	#define VM_NEXT break
+#endif
+
+
+/**
+ * run the program, selects the interpreter loop specialised
+ * for the debug, memory check and memory image modes
+ */
 bool VM::Run()
+{
+	m_num_ops = 0;
+
+	if(m_profile)
+	{
+		m_profiler.Reset();
+		m_profiler.Start();
+	}
+
+	// start taking call stack samples in the timer thread
+	if(m_sample_ticks.count() > 0)
+	{
+		m_profiler.ResetSamples();
+		m_sampling = true;
+		UpdateTimer();
+	}
+
+	bool result = false;
+#if VM_GUARD_PAGES != 0
+	// the guard pages replace the bounds checks
+	if(m_mem.HasGuardPages())
+	{
+		// a fault only writes out the program output buffer
+		FlushOutput();
+
+		result = m_mem.RunGuarded([this]() -> bool { return RunLoop(); },
+			m_code_range[0], m_code_range[1], &m_outbuf);
+	}
+	else
+#endif
+	{
+		result = RunLoop();
+	}
+
+	FlushOutput();
+
+	if(m_profile)
+		m_profiler.Stop();
+
+	if(m_sampling)
+	{
+		m_sampling = false;
+		UpdateTimer();
+	}
+
+	if(m_debug)
+	{
+		std::cout << "Ran " << m_num_ops << " instructions." << std::endl;
+	}
+
+	return result;
+}
+
+
+/**
+ * run the interpreter loop for the current modes until the program ends
+ */
+bool VM::RunLoop()
+{
+	while(true)
+	{
+		std::optional<bool> result;
+		const bool checks = m_checks && !m_mem.IsGuarded();
+
+		if(m_debug)
+			result = RunWithFlags<true>(checks, m_drawmemimages);
+		else
+			result = RunWithFlags<false>(checks, m_drawmemimages);
+
+		// the modes have been changed while running, select the new loop
+		if(!result)
+			continue;
+
+		return *result;
+	}
+}
+
+
+/**
+ * select the interpreter loop for the memory check, memory image and profiling modes
+ */
+template<bool debug>
+std::optional<bool> VM::RunWithFlags(bool checks, bool memimages)
+{
+	// the profiler is not used together with the debug output and memory images,
+	// which would dominate the measured times
+	if constexpr(!debug)
+	{
+		// verified code is run without operand type tests and instruction pointer checks
+		if(!m_profile && !memimages && CanRunVerified())
+		{
+			if(checks)
+				return RunInstructions<false, true, false, false, true>();
+			return RunInstructions<false, false, false, false, true>();
+		}
+
+		if(m_profile && !memimages)
+		{
+			if(checks)
+				return RunInstructions<false, true, false, true>();
+			return RunInstructions<false, false, false, true>();
+		}
+	}
+
+	if(checks)
+	{
+		if(memimages)
+			return RunInstructions<debug, true, true>();
+		return RunInstructions<debug, true, false>();
+	}
+
+	if(memimages)
+		return RunInstructions<debug, false, true>();
+	return RunInstructions<debug, false, false>();
+}
+
+
+/**
+ * interpreter loop, specialised for the debug, memory check, memory image,
+ * profiling and verified modes, so that no mode flags are tested in the hot path
+ * @returns nullopt if the modes have been changed by the running program
+ */
+template<bool debug, bool checks, bool memimages, bool profile, bool verified>
+std::optional<bool> VM::RunInstructions()
 {
 	bool running = true;
 	std::size_t num_ops = 0;
 
-	while(running)
+	// run the pre-decoded instructions, the debug mode shows
+	// the operand decoding of the original instructions
+	constexpr const bool use_decoded = !debug;
+	if constexpr(use_decoded)
+		DecodeCode();
+
+	// current pre-decoded instruction
+	const DecodedInstr* instr = nullptr;
+	// instruction decoded at run time if no pre-decoded one is available
+	DecodedInstr run_decoded{};
+
+	// source line of the last debug output
+	std::optional<t_addr> debug_line{};
+
+	// fetches the next instruction or a call to an interrupt service routine
+	auto fetch_op = [this, &num_ops, &instr, &run_decoded, &debug_line]() -> OpCode
 	{
-		CheckPointerBounds();
-		if(m_drawmemimages)
+		// the verified code only reaches verified instructions
+		if constexpr(!verified)
+		{
+			// wrap around
+			if(m_ip >= m_memsize)
+			{
+				m_ip %= m_memsize;
+
+				if constexpr(debug)
+				{
+					std::cout << "ip wrapped around memory limit."
+						<< std::endl;
+				}
+			}
+		}
+
+		// the stack can still grow into the code with the calls
+		if constexpr(checks)
+			CheckPointerBounds();
+
+		if constexpr(memimages)
 			DrawMemoryImage();
 
+		[[maybe_unused]] const t_addr fetch_ip = m_ip;
 		OpCode op{OpCode::INVALID};
-		bool irq_active = false;
+		[[maybe_unused]] bool irq_active = false;
 
-		// tests for interrupt requests
-		for(t_addr irq = 0; irq < m_num_interrupts; ++irq)
+		// tests for interrupt requests, a single load if none is pending
+		for(t_irqmask irqs = m_irqs.load(std::memory_order_relaxed); irqs;
+			irqs &= irqs - 1)
 		{
-			if(!m_irqs[irq])
+			// lowest pending interrupt
+			const t_addr irq = std::countr_zero(irqs);
+			const t_irqmask irqbit = t_irqmask(1) << irq;
+
+			if(!(m_irqs.fetch_and(~irqbit, std::memory_order_acquire) & irqbit))
+				continue;
+
+			// sample for the profiler, no service routine is called
+			if(irq == m_sample_interrupt)
+			{
+				SampleStack();
 				continue;
+			}
 
-			m_irqs[irq] = false;
 			if(!m_isrs[irq])
 				continue;
 
 			irq_active = true;
 
 			// call interrupt service routine
-			PushAddress(*m_isrs[irq], VMType::ADDR_MEM);
+			PushAddress<checks>(*m_isrs[irq], VMType::ADDR_MEM);
 			op = OpCode::CALL;
 
 			// TODO: add specialised ICALL and IRET instructions
@@ -47,15 +249,63 @@ bool VM::Run()
 			break;
 		}
 
-		if(!irq_active)
+		if constexpr(verified)
+		{
+			// fetch verified instruction, no service routines are set,
+			// see CanRunVerified()
+			instr = &m_decoded[m_ip - m_code_range[0]];
+			op = instr->op;
+			m_ip = instr->next_ip;
+		}
+
+		else if(use_decoded && !irq_active && !m_decoded.empty()
+			&& m_ip >= m_code_range[0] && m_ip < m_code_range[1])
+		{
+			// fetch pre-decoded instruction
+			instr = &m_decoded[m_ip - m_code_range[0]];
+			op = instr->op;
+
+			if(op != OpCode::INVALID)
+				m_ip = instr->next_ip;
+		}
+
+		if(!verified && !irq_active && op == OpCode::INVALID)
 		{
 			// fetch instruction
 			t_byte _op = m_mem[m_ip++];
 			op = static_cast<OpCode>(_op);
+
+			// decode the inline operand of superinstructions
+			if(has_vm_addr_operand(op))
+			{
+				std::optional<DecodedInstr> decoded = DecodeInstr(m_ip - m_bytesize);
+				if(!decoded)
+					throw std::runtime_error("Invalid instruction operand.");
+
+				run_decoded = *decoded;
+				instr = &run_decoded;
+				m_ip = instr->next_ip;
+			}
 		}
 
-		if(m_debug)
+		if constexpr(debug)
 		{
+			// show the source line if debug info is available
+			if(m_debuginfo)
+			{
+				std::optional<t_addr> line = m_debuginfo->GetLine(fetch_ip);
+
+				if(line && line != debug_line)
+				{
+					std::cout << "--- " << m_debuginfo->GetSourceFile()
+						<< ":" << *line;
+					if(const DebugInfo::Func* func = m_debuginfo->GetFunc(fetch_ip))
+						std::cout << " in function " << func->name;
+					std::cout << " ---" << std::endl;
+				}
+				debug_line = line;
+			}
+
 			std::cout << "*** [" << num_ops << "] read instruction"
 				<< " at ip = " << t_int(m_ip)
 				<< ", sp = " << t_int(m_sp)
@@ -67,79 +317,353 @@ bool VM::Run()
 				<< std::dec << ". ***" << std::endl;
 		}
 
+		if constexpr(profile)
+			m_profiler.CountOp(op);
+
+		return op;
+	};
+
+	// operand type of the current instruction proven by the verifier
+	auto proven = [&instr]() -> VMType
+	{
+		if constexpr(verified)
+			return instr->optype;
+		else
+			return VMType::UNKNOWN;
+	};
+
+	// calls the function at the given address
+	auto call_func = [this](t_addr funcaddr, t_int framesize)
+	{
+		// save instruction and base pointer and
+		// set up the function's stack frame for local variables
+		PushAddress<checks>(m_ip, VMType::ADDR_MEM);
+		PushAddress<checks>(m_bp, VMType::ADDR_MEM);
+
+		if constexpr(debug)
+		{
+			std::cout << "saved base pointer " << m_bp
+				<< "." << std::endl;
+		}
+		m_bp = m_sp;
+		m_sp -= framesize;
+
+		// jump to function
+		m_ip = funcaddr;
+		if constexpr(debug)
+		{
+			std::cout << "calling function " << funcaddr
+				<< "." << std::endl;
+		}
+
+		if constexpr(profile)
+			m_profiler.EnterFunc(funcaddr);
+
+		// run hot functions as native code, the interpreter
+		// continues after the function or where the native code left
+		// (not while profiling, as the native code has no opcodes to count)
+		if constexpr(!debug && !memimages && !profile)
+		{
+			if(m_jit)
+				RunNative(funcaddr);
+		}
+	};
+
+	// returns from a function
+	auto return_func = [this](t_int num_args, t_int framesize)
+	{
+		// if there are still values on the stack, use then as return values
+		std::vector<t_data> retvals;
+		while(m_sp + framesize < m_bp)
+			retvals.push_back(PopData<checks>());
+
+		// zero the stack frame
+		if(m_zeropoppedvals)
+			std::memset(m_mem.get() + m_sp, 0, (m_bp - m_sp)*m_bytesize);
+
+		// remove the function's stack frame
+		m_sp = m_bp;
+
+		m_bp = PopAddress<checks>();
+		m_ip = PopAddress<checks>();  // jump back
+
+		if constexpr(debug)
+		{
+			std::cout << "restored base pointer " << m_bp
+				<< "." << std::endl;
+		}
+
+		if constexpr(profile)
+			m_profiler.ExitFunc();
+
+		// remove function arguments from stack
+		for(t_int arg = 0; arg < num_args; ++arg)
+			PopData<checks>();
+
+		for(const t_data& retval : retvals)
+			PushData<checks>(retval, VMType::UNKNOWN, false);
+	};
+
+#if VM_THREADED_DISPATCH != 0
+	// instruction handlers, indexed by opcode
+	std::array<void*, 256> dispatch_table;
+	dispatch_table.fill(&&op_invalid);
+
+	VM_HANDLER(HALT); VM_HANDLER(NOP);
+	VM_HANDLER(PUSH); VM_HANDLER(WRMEM); VM_HANDLER(RDMEM);
+	VM_HANDLER(RDARR); VM_HANDLER(RDARRR);
+	VM_HANDLER(RDARRM); VM_HANDLER(RDARRRM);
+	VM_HANDLER(WRARR); VM_HANDLER(WRARRR); VM_HANDLER(CPARRR);
+	VM_HANDLER(MAKEREALARR); VM_HANDLER(MAKEINTARR);
+	VM_HANDLER(MAKECPLXARR); VM_HANDLER(MAKEQUATARR);
+	VM_HANDLER(USUB); VM_HANDLER(ADD); VM_HANDLER(SUB);
+	VM_HANDLER(MUL); VM_HANDLER(DIV); VM_HANDLER(MOD);
+	VM_HANDLER(POW); VM_HANDLER(MATMUL);
+	VM_HANDLER(AND); VM_HANDLER(OR); VM_HANDLER(XOR); VM_HANDLER(NOT);
+	VM_HANDLER(GT); VM_HANDLER(LT); VM_HANDLER(GEQU);
+	VM_HANDLER(LEQU); VM_HANDLER(EQU); VM_HANDLER(NEQU);
+	VM_HANDLER(BINAND); VM_HANDLER(BINOR); VM_HANDLER(BINXOR);
+	VM_HANDLER(BINNOT); VM_HANDLER(SHL); VM_HANDLER(SHR);
+	VM_HANDLER(ROTL); VM_HANDLER(ROTR);
+	VM_HANDLER(TOR); VM_HANDLER(TOI); VM_HANDLER(TOC);
+	VM_HANDLER(TOQ); VM_HANDLER(TOB); VM_HANDLER(TOS);
+	VM_HANDLER(TOREALARR); VM_HANDLER(TOINTARR);
+	VM_HANDLER(TOCPLXARR); VM_HANDLER(TOQUATARR);
+	VM_HANDLER(JMP); VM_HANDLER(JMPCND);
+	VM_HANDLER(CALL); VM_HANDLER(RET); VM_HANDLER(EXTCALL);
+	VM_HANDLER(ADDFRAME); VM_HANDLER(REMFRAME);
+	VM_HANDLER(LOADLOCAL); VM_HANDLER(LOADGLOBAL);
+	VM_HANDLER(STORELOCAL); VM_HANDLER(STOREGLOBAL);
+	VM_HANDLER(JMPIFNOT); VM_HANDLER(JMPNOTGT); VM_HANDLER(JMPNOTLT);
+	VM_HANDLER(JMPNOTGEQU); VM_HANDLER(JMPNOTLEQU);
+	VM_HANDLER(JMPNOTEQU); VM_HANDLER(JMPNOTNEQU);
+	VM_HANDLER(PUSHD); VM_HANDLER(JMPD); VM_HANDLER(JMPCNDD);
+	VM_HANDLER(CALLD); VM_HANDLER(RETD);
+	VM_HANDLER(ADDFRAMED); VM_HANDLER(REMFRAMED);
+	VM_HANDLER(ADD_I); VM_HANDLER(SUB_I); VM_HANDLER(MUL_I); VM_HANDLER(DIV_I);
+	VM_HANDLER(ADD_R); VM_HANDLER(SUB_R); VM_HANDLER(MUL_R); VM_HANDLER(DIV_R);
+	VM_HANDLER(GT_I); VM_HANDLER(LT_I); VM_HANDLER(GEQU_I);
+	VM_HANDLER(LEQU_I); VM_HANDLER(EQU_I); VM_HANDLER(NEQU_I);
+	VM_HANDLER(GT_R); VM_HANDLER(LT_R); VM_HANDLER(GEQU_R);
+	VM_HANDLER(LEQU_R); VM_HANDLER(EQU_R); VM_HANDLER(NEQU_R);
+	VM_HANDLER(TAG_I); VM_HANDLER(TAG_R); VM_HANDLER(UNTAG_I); VM_HANDLER(UNTAG_R);
+	VM_HANDLER(PUSHUD); VM_HANDLER(TOR_IU); VM_HANDLER(TOI_RU);
+	VM_HANDLER(LOADLOCAL_IU); VM_HANDLER(LOADLOCAL_RU);
+	VM_HANDLER(LOADGLOBAL_IU); VM_HANDLER(LOADGLOBAL_RU);
+	VM_HANDLER(STORELOCAL_IU); VM_HANDLER(STORELOCAL_RU);
+	VM_HANDLER(STOREGLOBAL_IU); VM_HANDLER(STOREGLOBAL_RU);
+	VM_HANDLER(ADD_IU); VM_HANDLER(SUB_IU); VM_HANDLER(MUL_IU); VM_HANDLER(DIV_IU);
+	VM_HANDLER(ADD_RU); VM_HANDLER(SUB_RU); VM_HANDLER(MUL_RU); VM_HANDLER(DIV_RU);
+	VM_HANDLER(GT_IU); VM_HANDLER(LT_IU); VM_HANDLER(GEQU_IU);
+	VM_HANDLER(LEQU_IU); VM_HANDLER(EQU_IU); VM_HANDLER(NEQU_IU);
+	VM_HANDLER(GT_RU); VM_HANDLER(LT_RU); VM_HANDLER(GEQU_RU);
+	VM_HANDLER(LEQU_RU); VM_HANDLER(EQU_RU); VM_HANDLER(NEQU_RU);
+	VM_HANDLER(JMPNOTGT_IU); VM_HANDLER(JMPNOTLT_IU); VM_HANDLER(JMPNOTGEQU_IU);
+	VM_HANDLER(JMPNOTLEQU_IU); VM_HANDLER(JMPNOTEQU_IU); VM_HANDLER(JMPNOTNEQU_IU);
+	VM_HANDLER(JMPNOTGT_RU); VM_HANDLER(JMPNOTLT_RU); VM_HANDLER(JMPNOTGEQU_RU);
+	VM_HANDLER(JMPNOTLEQU_RU); VM_HANDLER(JMPNOTEQU_RU); VM_HANDLER(JMPNOTNEQU_RU);
+#endif
+
+	while(running)
+	{
+		OpCode op = fetch_op();
+
+#if VM_THREADED_DISPATCH != 0
+		goto *dispatch_table[static_cast<t_byte>(op)];
+#endif
+
 		// run instruction (as this is a zero-address machine without
 		// general-purpose registers and only one direct data instruction
-		// (push), we don't need an explicit decode step before)
+		// (push), the only decode step is the one done at load time,
+		// see DecodeCode())
 		switch(op)
 		{
-			case OpCode::HALT:
+			VM_CASE(HALT):
 			{
 				running = false;
 				break;
 			}
 
-			case OpCode::NOP:
+			VM_CASE(NOP):
 			{
-				break;
 			}
+			VM_NEXT;
 
 			// ----------------------------------------------------
 			// memory instructions
 			// ----------------------------------------------------
-			case OpCode::PUSH:  // push direct data onto stack
+			VM_CASE(PUSH):  // push direct data onto stack
 			{
-				auto [ty, val] = ReadMemData(m_ip);
-				m_ip += GetDataSize(val) + m_bytesize;
-				PushData(val, ty);
-				break;
+				auto [ty, val] = ReadMemData<checks>(m_ip);
+				m_ip += vm_slot_size(GetDataSize(val) + m_descrsize);
+				PushData<checks>(val, ty);
+			}
+			VM_NEXT;
+
+			VM_CASE(PUSHD):  // push pre-decoded direct data onto stack
+			{
+				// the direct data has the same layout in the code as on the stack
+				if constexpr(checks)
+					CheckMemoryBounds<checks>(m_sp, -instr->data_size);
+				m_sp -= instr->data_size;
+				std::memcpy(m_mem.get() + m_sp, m_mem.get() + instr->data_addr,
+					instr->data_size*m_bytesize);
 			}
+			VM_NEXT;
 
-			case OpCode::WRMEM:
+			VM_CASE(PUSHUD):  // push pre-decoded direct data without its descriptor
+			{
+				// the integers and reals have no padding after their descriptor
+				const t_addr valsize = instr->data_size - m_descrsize;
+				const t_addr size = valsize + vm_untagged_padding_size(valsize);
+				if constexpr(checks)
+					CheckMemoryBounds<checks>(m_sp, -size);
+				m_sp -= size;
+				std::memcpy(m_mem.get() + m_sp, m_mem.get() + instr->data_addr + m_descrsize,
+					valsize*m_bytesize);
+			}
+			VM_NEXT;
+
+			VM_CASE(WRMEM):
 			{
 				// variable address
-				t_addr addr = PopAddress();
+				t_addr addr = PopAddress<checks>();
 
 				// pop data and write it to memory
-				t_data val = PopData();
-				WriteMemData(addr, val);
-				break;
+				PopMemData<checks>(addr);
 			}
+			VM_NEXT;
 
-			case OpCode::RDMEM:
+			VM_CASE(RDMEM):
 			{
 				// variable address
-				t_addr addr = PopAddress();
+				t_addr addr = PopAddress<checks>();
 
 				// read and push data from memory
-				auto [ty, val] = ReadMemData(addr);
-				PushData(val, ty);
-				break;
+				PushMemData<checks>(addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(LOADLOCAL):  // read local variable
+			{
+				PushMemData<checks>(m_bp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(LOADGLOBAL):  // read global variable
+			{
+				PushMemData<checks>(m_gbp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(STORELOCAL):  // write local variable
+			{
+				PopMemData<checks>(m_bp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(STOREGLOBAL):  // write global variable
+			{
+				PopMemData<checks>(m_gbp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(LOADLOCAL_IU):  // read local integer variable untagged
+			{
+				OpLoadUntagged<t_int, checks>(m_bp + instr->var_addr, proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LOADLOCAL_RU):  // read local real variable untagged
+			{
+				OpLoadUntagged<t_real, checks>(m_bp + instr->var_addr, proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LOADGLOBAL_IU):  // read global integer variable untagged
+			{
+				OpLoadUntagged<t_int, checks>(m_gbp + instr->var_addr, proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LOADGLOBAL_RU):  // read global real variable untagged
+			{
+				OpLoadUntagged<t_real, checks>(m_gbp + instr->var_addr, proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(STORELOCAL_IU):  // write untagged integer to local variable
+			{
+				OpStoreUntagged<t_int, checks>(m_bp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(STORELOCAL_RU):  // write untagged real to local variable
+			{
+				OpStoreUntagged<t_real, checks>(m_bp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(STOREGLOBAL_IU):  // write untagged integer to global variable
+			{
+				OpStoreUntagged<t_int, checks>(m_gbp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(STOREGLOBAL_RU):  // write untagged real to global variable
+			{
+				OpStoreUntagged<t_real, checks>(m_gbp + instr->var_addr);
+			}
+			VM_NEXT;
+
+			VM_CASE(TAG_I):  // add the type descriptor to an untagged integer
+			{
+				OpTag<t_int, checks>();
 			}
+			VM_NEXT;
+
+			VM_CASE(TAG_R):  // add the type descriptor to an untagged real
+			{
+				OpTag<t_real, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(UNTAG_I):  // remove the type descriptor from an integer
+			{
+				OpUntag<t_int, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(UNTAG_R):  // remove the type descriptor from a real
+			{
+				OpUntag<t_real, checks>(proven());
+			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
 			// ----------------------------------------------------
 			// array instructions
 			// ----------------------------------------------------
-			case OpCode::RDARR:  // read array element
+			VM_CASE(RDARR):  // read array element
 			{
-				t_int idx = std::get<m_intidx>(PopData());
-				t_data arr = PopData();
+				t_int idx = std::get<m_intidx>(PopData<checks>());
+				t_data arr = PopData<checks>();
 
 				if(arr.index() == m_realarridx)
 				{
-					ReadArrayElem<t_vec_real>(arr, idx);
+					ReadArrayElem<t_vec_real, checks>(arr, idx);
 				}
 				else if(arr.index() == m_intarridx)
 				{
-					ReadArrayElem<t_vec_int>(arr, idx);
+					ReadArrayElem<t_vec_int, checks>(arr, idx);
 				}
 				else if(arr.index() == m_cplxarridx)
 				{
-					ReadArrayElem<t_vec_cplx>(arr, idx);
+					ReadArrayElem<t_vec_cplx, checks>(arr, idx);
 				}
 				else if(arr.index() == m_quatarridx)
 				{
-					ReadArrayElem<t_vec_quat>(arr, idx);
+					ReadArrayElem<t_vec_quat, checks>(arr, idx);
 				}
 				else if(arr.index() == m_stridx)
 				{
@@ -149,37 +673,71 @@ bool VM::Run()
 
 					t_str newstr;
 					newstr += str[idx];
-					PushData(t_data{std::in_place_index<m_stridx>, newstr});
+					PushData<checks>(t_data{std::in_place_index<m_stridx>, newstr});
 				}
 				else
 				{
 					throw std::runtime_error("Cannot index non-array type.");
 				}
 
-				break;
 			}
+			VM_NEXT;
+
+			VM_CASE(RDARRM):  // read array element directly from memory
+			{
+				t_int idx = std::get<m_intidx>(PopData<checks>());
+				t_addr addr = PopAddress<checks>();
+
+				// get variable data type
+				VMType ty = ReadMemType<checks>(addr);
+				// skip type descriptor byte
+				addr += m_descrsize;
+
+				if(ty == VMType::REALARR)
+					ReadArrayElem<t_vec_real, checks>(addr, idx);
+				else if(ty == VMType::INTARR)
+					ReadArrayElem<t_vec_int, checks>(addr, idx);
+				else if(ty == VMType::CPLXARR)
+					ReadArrayElem<t_vec_cplx, checks>(addr, idx);
+				else if(ty == VMType::QUATARR)
+					ReadArrayElem<t_vec_quat, checks>(addr, idx);
+				else if(ty == VMType::STR)
+				{
+					// gets string element as substring
+					t_addr strlen = ReadMemRaw<t_addr, checks>(addr);
+					addr += m_addrsize;
+					idx = safe_array_index<t_addr>(idx, strlen);
+
+					t_str newstr;
+					newstr += ReadMemRaw<t_char, checks>(addr + idx*m_charsize);
+					PushData<checks>(t_data{std::in_place_index<m_stridx>, newstr});
+				}
+				else
+					throw std::runtime_error("Cannot index non-array type.");
+			}
+			VM_NEXT;
 
-			case OpCode::RDARRR:  // read a range of array elements
+			VM_CASE(RDARRR):  // read a range of array elements
 			{
-				t_int idx2 = std::get<m_intidx>(PopData());
-				t_int idx1 = std::get<m_intidx>(PopData());
-				t_data arr = PopData();
+				t_int idx2 = std::get<m_intidx>(PopData<checks>());
+				t_int idx1 = std::get<m_intidx>(PopData<checks>());
+				t_data arr = PopData<checks>();
 
 				if(arr.index() == m_realarridx)
 				{
-					ReadArrayElemRange<t_vec_real>(arr, idx1, idx2);
+					ReadArrayElemRange<t_vec_real, checks>(arr, idx1, idx2);
 				}
 				else if(arr.index() == m_intarridx)
 				{
-					ReadArrayElemRange<t_vec_int>(arr, idx1, idx2);
+					ReadArrayElemRange<t_vec_int, checks>(arr, idx1, idx2);
 				}
 				else if(arr.index() == m_cplxarridx)
 				{
-					ReadArrayElemRange<t_vec_cplx>(arr, idx1, idx2);
+					ReadArrayElemRange<t_vec_cplx, checks>(arr, idx1, idx2);
 				}
 				else if(arr.index() == m_quatarridx)
 				{
-					ReadArrayElemRange<t_vec_quat>(arr, idx1, idx2);
+					ReadArrayElemRange<t_vec_quat, checks>(arr, idx1, idx2);
 				}
 				else if(arr.index() == m_stridx)
 				{
@@ -194,77 +752,160 @@ bool VM::Run()
 					t_str newstr;
 					for(t_int idx=idx1; idx!=idx2; idx+=delta)
 						newstr += str[idx];
-					PushData(t_data{std::in_place_index<m_stridx>, newstr});
+					PushData<checks>(t_data{std::in_place_index<m_stridx>, newstr});
 				}
 				else
 				{
 					throw std::runtime_error("Cannot index non-array type.");
 				}
 
-				break;
 			}
+			VM_NEXT;
+
+			VM_CASE(RDARRRM):  // read a range of array elements directly from memory
+			{
+				t_int idx2 = std::get<m_intidx>(PopData<checks>());
+				t_int idx1 = std::get<m_intidx>(PopData<checks>());
+				t_addr addr = PopAddress<checks>();
+
+				// get variable data type
+				VMType ty = ReadMemType<checks>(addr);
+				// skip type descriptor byte
+				addr += m_descrsize;
+
+				if(ty == VMType::REALARR)
+					ReadArrayElemRange<t_vec_real, checks>(addr, idx1, idx2);
+				else if(ty == VMType::INTARR)
+					ReadArrayElemRange<t_vec_int, checks>(addr, idx1, idx2);
+				else if(ty == VMType::CPLXARR)
+					ReadArrayElemRange<t_vec_cplx, checks>(addr, idx1, idx2);
+				else if(ty == VMType::QUATARR)
+					ReadArrayElemRange<t_vec_quat, checks>(addr, idx1, idx2);
+				else if(ty == VMType::STR)
+				{
+					// gets string range as substring
+					t_addr strlen = ReadMemRaw<t_addr, checks>(addr);
+					addr += m_addrsize;
+					idx1 = safe_array_index<t_addr>(idx1, strlen);
+					idx2 = safe_array_index<t_addr>(idx2, strlen);
+
+					t_int delta = (idx2 >= idx1 ? 1 : -1);
+					idx2 += delta;
+
+					t_str newstr;
+					for(t_int idx=idx1; idx!=idx2; idx+=delta)
+						newstr += ReadMemRaw<t_char, checks>(addr + idx*m_charsize);
+					PushData<checks>(t_data{std::in_place_index<m_stridx>, newstr});
+				}
+				else
+					throw std::runtime_error("Cannot index non-array type.");
+			}
+			VM_NEXT;
 
-			case OpCode::WRARR:  // write an array element
+			VM_CASE(WRARR):  // write an array element
 			{
-				t_int idx = std::get<m_intidx>(PopData());
+				t_int idx = std::get<m_intidx>(PopData<checks>());
 
-				t_data data = PopData();
-				t_addr addr = PopAddress();
+				t_data data = PopData<checks>();
+				t_addr addr = PopAddress<checks>();
 
 				// get variable data type
-				VMType ty = ReadMemType(addr);
+				VMType ty = ReadMemType<checks>(addr);
 				// skip type descriptor byte
-				addr += m_bytesize;
+				addr += m_descrsize;
 
 				if(ty == VMType::REALARR)
-					WriteArrayElem<t_vec_real>(addr, data, idx);
+					WriteArrayElem<t_vec_real, checks>(addr, data, idx);
 				else if(ty == VMType::INTARR)
-					WriteArrayElem<t_vec_int>(addr, data, idx);
+					WriteArrayElem<t_vec_int, checks>(addr, data, idx);
 				else if(ty == VMType::CPLXARR)
-					WriteArrayElem<t_vec_cplx>(addr, data, idx);
+					WriteArrayElem<t_vec_cplx, checks>(addr, data, idx);
 				else if(ty == VMType::QUATARR)
-					WriteArrayElem<t_vec_quat>(addr, data, idx);
+					WriteArrayElem<t_vec_quat, checks>(addr, data, idx);
 				else
 					throw std::runtime_error("Cannot index non-array type.");
 
-				break;
 			}
+			VM_NEXT;
+
+			VM_CASE(CPARRR):  // copy a range of array elements between variables
+			{
+				t_int dst_idx2 = std::get<m_intidx>(PopData<checks>());
+				t_int dst_idx1 = std::get<m_intidx>(PopData<checks>());
+				t_int src_idx2 = std::get<m_intidx>(PopData<checks>());
+				t_int src_idx1 = std::get<m_intidx>(PopData<checks>());
+				t_addr src_addr = PopAddress<checks>();
+				t_addr dst_addr = PopAddress<checks>();
+
+				// get variable data types
+				VMType ty = ReadMemType<checks>(dst_addr);
+				if(ReadMemType<checks>(src_addr) != ty)
+					throw std::runtime_error("Array range has to be of the same type.");
+
+				// skip type descriptor bytes
+				dst_addr += m_descrsize;
+				src_addr += m_descrsize;
+
+				if(ty == VMType::REALARR)
+				{
+					CopyArrayElemRange<t_vec_real, checks>(dst_addr, dst_idx1, dst_idx2,
+						src_addr, src_idx1, src_idx2);
+				}
+				else if(ty == VMType::INTARR)
+				{
+					CopyArrayElemRange<t_vec_int, checks>(dst_addr, dst_idx1, dst_idx2,
+						src_addr, src_idx1, src_idx2);
+				}
+				else if(ty == VMType::CPLXARR)
+				{
+					CopyArrayElemRange<t_vec_cplx, checks>(dst_addr, dst_idx1, dst_idx2,
+						src_addr, src_idx1, src_idx2);
+				}
+				else if(ty == VMType::QUATARR)
+				{
+					CopyArrayElemRange<t_vec_quat, checks>(dst_addr, dst_idx1, dst_idx2,
+						src_addr, src_idx1, src_idx2);
+				}
+				else
+					throw std::runtime_error("Cannot index non-array type.");
+			}
+			VM_NEXT;
 
-			case OpCode::WRARRR:  // write a range of array elements
+			VM_CASE(WRARRR):  // write a range of array elements
 			{
-				t_int idx2 = std::get<m_intidx>(PopData());
-				t_int idx1 = std::get<m_intidx>(PopData());
+				t_int idx2 = std::get<m_intidx>(PopData<checks>());
+				t_int idx1 = std::get<m_intidx>(PopData<checks>());
 
-				t_data data = PopData();
-				t_addr addr = PopAddress();
+				t_data data = PopData<checks>();
+				t_addr addr = PopAddress<checks>();
 
 				// get variable data type
-				VMType ty = ReadMemType(addr);
+				VMType ty = ReadMemType<checks>(addr);
 				// skip type descriptor byte
-				addr += m_bytesize;
+				addr += m_descrsize;
 
 				// lhs variable is a real array
 				if(ty == VMType::REALARR)
 				{
-					WriteArrayElemRange<t_vec_real>(addr, data, idx1, idx2);
+					WriteArrayElemRange<t_vec_real, checks>(addr, data, idx1, idx2);
 				}
 
 				// lhs variable is an int array
 				else if(ty == VMType::INTARR)
 				{
-					WriteArrayElemRange<t_vec_int>(addr, data, idx1, idx2);
+					WriteArrayElemRange<t_vec_int, checks>(addr, data, idx1, idx2);
 				}
 
 				// lhs variable is a complex array
 				else if(ty == VMType::CPLXARR)
 				{
-					WriteArrayElemRange<t_vec_cplx>(addr, data, idx1, idx2);
+					WriteArrayElemRange<t_vec_cplx, checks>(addr, data, idx1, idx2);
 				}
 
 				// lhs variable is a quaternion array
 				else if(ty == VMType::QUATARR)
 				{
-					WriteArrayElemRange<t_vec_quat>(addr, data, idx1, idx2);
+					WriteArrayElemRange<t_vec_quat, checks>(addr, data, idx1, idx2);
 				}
 
 				// lhs variable is a string
@@ -279,7 +920,7 @@ bool VM::Run()
 					const t_str& rhsstr = std::get<m_stridx>(data);;
 
 					// get array length indicator
-					t_addr strlen = ReadMemRaw<t_addr>(addr);
+					t_addr strlen = ReadMemRaw<t_addr, checks>(addr);
 					addr += m_addrsize;
 
 					idx1 = safe_array_index<t_addr>(idx1, strlen);
@@ -302,7 +943,7 @@ bool VM::Run()
 
 						elem = rhsstr[cur_idx++];
 
-						WriteMemRaw(addr, elem);
+						WriteMemRaw<t_char, checks>(addr, elem);
 						addr += m_charsize * delta;
 					}
 				}
@@ -311,44 +952,44 @@ bool VM::Run()
 					throw std::runtime_error("Cannot index non-array type.");
 				}
 
-				break;
 			}
+			VM_NEXT;
 
-			case OpCode::MAKEREALARR:  // create a real array out of the elements on the stack
+			VM_CASE(MAKEREALARR):  // create a real array out of the elements on the stack
 			{
-				t_vec_real vec = PopArray<t_vec_real>(false);
-				PushData(t_data{std::in_place_index<m_realarridx>, vec});
-				break;
+				t_vec_real vec = PopArray<t_vec_real, checks>(false);
+				PushData<checks>(t_data{std::in_place_index<m_realarridx>, vec});
 			}
+			VM_NEXT;
 
-			case OpCode::MAKEINTARR:  // create an int array out of the elements on the stack
+			VM_CASE(MAKEINTARR):  // create an int array out of the elements on the stack
 			{
-				t_vec_int vec = PopArray<t_vec_int>(false);
-				PushData(t_data{std::in_place_index<m_intarridx>, vec});
-				break;
+				t_vec_int vec = PopArray<t_vec_int, checks>(false);
+				PushData<checks>(t_data{std::in_place_index<m_intarridx>, vec});
 			}
+			VM_NEXT;
 
-			case OpCode::MAKECPLXARR:  // create a complex array out of the elements on the stack
+			VM_CASE(MAKECPLXARR):  // create a complex array out of the elements on the stack
 			{
-				t_vec_cplx vec = PopArray<t_vec_cplx>(false);
-				PushData(t_data{std::in_place_index<m_cplxarridx>, vec});
-				break;
+				t_vec_cplx vec = PopArray<t_vec_cplx, checks>(false);
+				PushData<checks>(t_data{std::in_place_index<m_cplxarridx>, vec});
 			}
+			VM_NEXT;
 
-			case OpCode::MAKEQUATARR:  // create a quaternion array out of the elements on the stack
+			VM_CASE(MAKEQUATARR):  // create a quaternion array out of the elements on the stack
 			{
-				t_vec_quat vec = PopArray<t_vec_quat>(false);
-				PushData(t_data{std::in_place_index<m_quatarridx>, vec});
-				break;
+				t_vec_quat vec = PopArray<t_vec_quat, checks>(false);
+				PushData<checks>(t_data{std::in_place_index<m_quatarridx>, vec});
 			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
 			// ----------------------------------------------------
 			// arithmetic instructions
 			// ----------------------------------------------------
-			case OpCode::USUB:
+			VM_CASE(USUB):
 			{
-				t_data val = PopData();
+				t_data val = PopData<checks>();
 				t_data result;
 
 				if(val.index() == m_realidx)
@@ -401,270 +1042,614 @@ bool VM::Run()
 						"Type mismatch in arithmetic operation.");
 				}
 
-				PushData(result);
-				break;
+				PushData<checks>(result);
 			}
+			VM_NEXT;
 
-			case OpCode::ADD:
+			VM_CASE(ADD):
 			{
-				OpArithmetic<'+'>();
-				break;
+				OpArithmetic<'+', checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::SUB:
+			VM_CASE(SUB):
 			{
-				OpArithmetic<'-'>();
-				break;
+				OpArithmetic<'-', checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::MUL:
+			VM_CASE(MUL):
 			{
-				OpArithmetic<'*'>();
-				break;
+				OpArithmetic<'*', checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::DIV:
+			VM_CASE(DIV):
 			{
-				OpArithmetic<'/'>();
-				break;
+				OpArithmetic<'/', checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::MOD:
+			VM_CASE(MOD):
 			{
-				OpArithmetic<'%'>();
-				break;
+				OpArithmetic<'%', checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::POW:
+			VM_CASE(POW):
 			{
-				OpArithmetic<'^'>();
-				break;
+				OpArithmetic<'^', checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::MATMUL:
+			VM_CASE(MATMUL):
 			{
-				OpMatrixMultiplication();
-				break;
+				OpMatrixMultiplication<checks>();
 			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
 			// ----------------------------------------------------
 			// logical instructions
 			// ----------------------------------------------------
-			case OpCode::AND:
+			VM_CASE(AND):
 			{
-				OpLogical<'&'>();
-				break;
+				OpLogical<'&', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::OR:
+			VM_CASE(OR):
 			{
-				OpLogical<'|'>();
-				break;
+				OpLogical<'|', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::XOR:
+			VM_CASE(XOR):
 			{
-				OpLogical<'^'>();
-				break;
+				OpLogical<'^', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::NOT:
+			VM_CASE(NOT):
 			{
 				// pop old value
-				bool boolval = PopBool();
+				bool boolval = PopBool<checks>();
 
 				// push new value
-				PushBool(!boolval);
-				break;
+				PushBool<checks>(!boolval);
 			}
+			VM_NEXT;
 
-			case OpCode::GT:
+			VM_CASE(GT):
 			{
-				OpComparison<OpCode::GT>();
-				break;
+				OpComparison<OpCode::GT, checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::LT:
+			VM_CASE(LT):
 			{
-				OpComparison<OpCode::LT>();
-				break;
+				OpComparison<OpCode::LT, checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::GEQU:
+			VM_CASE(GEQU):
 			{
-				OpComparison<OpCode::GEQU>();
-				break;
+				OpComparison<OpCode::GEQU, checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::LEQU:
+			VM_CASE(LEQU):
 			{
-				OpComparison<OpCode::LEQU>();
-				break;
+				OpComparison<OpCode::LEQU, checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::EQU:
+			VM_CASE(EQU):
 			{
-				OpComparison<OpCode::EQU>();
-				break;
+				OpComparison<OpCode::EQU, checks>(proven());
 			}
+			VM_NEXT;
 
-			case OpCode::NEQU:
+			VM_CASE(NEQU):
 			{
-				OpComparison<OpCode::NEQU>();
-				break;
+				OpComparison<OpCode::NEQU, checks>(proven());
+			}
+			VM_NEXT;
+			// ----------------------------------------------------
+
+			// ----------------------------------------------------
+			// statically typed arithmetic and comparison instructions
+			// ----------------------------------------------------
+			VM_CASE(ADD_I):
+			{
+				OpArithmeticTyped<t_int, '+', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(SUB_I):
+			{
+				OpArithmeticTyped<t_int, '-', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(MUL_I):
+			{
+				OpArithmeticTyped<t_int, '*', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(DIV_I):
+			{
+				OpArithmeticTyped<t_int, '/', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(ADD_R):
+			{
+				OpArithmeticTyped<t_real, '+', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(SUB_R):
+			{
+				OpArithmeticTyped<t_real, '-', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(MUL_R):
+			{
+				OpArithmeticTyped<t_real, '*', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(DIV_R):
+			{
+				OpArithmeticTyped<t_real, '/', checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(GT_I):
+			{
+				OpComparisonTyped<t_int, OpCode::GT, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LT_I):
+			{
+				OpComparisonTyped<t_int, OpCode::LT, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(GEQU_I):
+			{
+				OpComparisonTyped<t_int, OpCode::GEQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LEQU_I):
+			{
+				OpComparisonTyped<t_int, OpCode::LEQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(EQU_I):
+			{
+				OpComparisonTyped<t_int, OpCode::EQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(NEQU_I):
+			{
+				OpComparisonTyped<t_int, OpCode::NEQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(GT_R):
+			{
+				OpComparisonTyped<t_real, OpCode::GT, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LT_R):
+			{
+				OpComparisonTyped<t_real, OpCode::LT, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(GEQU_R):
+			{
+				OpComparisonTyped<t_real, OpCode::GEQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(LEQU_R):
+			{
+				OpComparisonTyped<t_real, OpCode::LEQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(EQU_R):
+			{
+				OpComparisonTyped<t_real, OpCode::EQU, checks>(proven());
+			}
+			VM_NEXT;
+
+			VM_CASE(NEQU_R):
+			{
+				OpComparisonTyped<t_real, OpCode::NEQU, checks>(proven());
 			}
+			VM_NEXT;
+			// ----------------------------------------------------
+
+			// ----------------------------------------------------
+			// instructions on untagged integers and reals
+			// ----------------------------------------------------
+			VM_CASE(ADD_IU):
+			{
+				OpArithmeticUntagged<t_int, '+', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(SUB_IU):
+			{
+				OpArithmeticUntagged<t_int, '-', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(MUL_IU):
+			{
+				OpArithmeticUntagged<t_int, '*', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(DIV_IU):
+			{
+				OpArithmeticUntagged<t_int, '/', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(ADD_RU):
+			{
+				OpArithmeticUntagged<t_real, '+', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(SUB_RU):
+			{
+				OpArithmeticUntagged<t_real, '-', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(MUL_RU):
+			{
+				OpArithmeticUntagged<t_real, '*', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(DIV_RU):
+			{
+				OpArithmeticUntagged<t_real, '/', checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(GT_IU):
+			{
+				OpComparisonUntagged<t_int, OpCode::GT, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(LT_IU):
+			{
+				OpComparisonUntagged<t_int, OpCode::LT, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(GEQU_IU):
+			{
+				OpComparisonUntagged<t_int, OpCode::GEQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(LEQU_IU):
+			{
+				OpComparisonUntagged<t_int, OpCode::LEQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(EQU_IU):
+			{
+				OpComparisonUntagged<t_int, OpCode::EQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(NEQU_IU):
+			{
+				OpComparisonUntagged<t_int, OpCode::NEQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(GT_RU):
+			{
+				OpComparisonUntagged<t_real, OpCode::GT, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(LT_RU):
+			{
+				OpComparisonUntagged<t_real, OpCode::LT, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(GEQU_RU):
+			{
+				OpComparisonUntagged<t_real, OpCode::GEQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(LEQU_RU):
+			{
+				OpComparisonUntagged<t_real, OpCode::LEQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(EQU_RU):
+			{
+				OpComparisonUntagged<t_real, OpCode::EQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(NEQU_RU):
+			{
+				OpComparisonUntagged<t_real, OpCode::NEQU, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(TOR_IU):
+			{
+				OpCastUntagged<t_int, t_real, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(TOI_RU):
+			{
+				OpCastUntagged<t_real, t_int, checks>();
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTGT_IU): // compare and jump to direct address if not >
+			{
+				if(!OpCompareUntagged<t_int, OpCode::GT, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTLT_IU): // compare and jump to direct address if not <
+			{
+				if(!OpCompareUntagged<t_int, OpCode::LT, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTGEQU_IU): // compare and jump to direct address if not >=
+			{
+				if(!OpCompareUntagged<t_int, OpCode::GEQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTLEQU_IU): // compare and jump to direct address if not <=
+			{
+				if(!OpCompareUntagged<t_int, OpCode::LEQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTEQU_IU): // compare and jump to direct address if not ==
+			{
+				if(!OpCompareUntagged<t_int, OpCode::EQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTNEQU_IU): // compare and jump to direct address if not !=
+			{
+				if(!OpCompareUntagged<t_int, OpCode::NEQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTGT_RU): // compare and jump to direct address if not >
+			{
+				if(!OpCompareUntagged<t_real, OpCode::GT, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTLT_RU): // compare and jump to direct address if not <
+			{
+				if(!OpCompareUntagged<t_real, OpCode::LT, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTGEQU_RU): // compare and jump to direct address if not >=
+			{
+				if(!OpCompareUntagged<t_real, OpCode::GEQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTLEQU_RU): // compare and jump to direct address if not <=
+			{
+				if(!OpCompareUntagged<t_real, OpCode::LEQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTEQU_RU): // compare and jump to direct address if not ==
+			{
+				if(!OpCompareUntagged<t_real, OpCode::EQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTNEQU_RU): // compare and jump to direct address if not !=
+			{
+				if(!OpCompareUntagged<t_real, OpCode::NEQU, checks>())
+					m_ip = instr->target;
+			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
 			// ----------------------------------------------------
 			// binary instructions
 			// ----------------------------------------------------
-			case OpCode::BINAND:
+			VM_CASE(BINAND):
 			{
-				OpBinary<'&'>();
-				break;
+				OpBinary<'&', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::BINOR:
+			VM_CASE(BINOR):
 			{
-				OpBinary<'|'>();
-				break;
+				OpBinary<'|', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::BINXOR:
+			VM_CASE(BINXOR):
 			{
-				OpBinary<'^'>();
-				break;
+				OpBinary<'^', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::BINNOT:
+			VM_CASE(BINNOT):
 			{
-				t_data val = PopData();
+				t_data val = PopData<checks>();
 				if(val.index() == m_intidx)
 				{
 					t_int newval = ~std::get<m_intidx>(val);
-					PushData(t_data{std::in_place_index<m_intidx>, newval});
+					PushData<checks>(t_data{std::in_place_index<m_intidx>, newval});
 				}
 				else
 				{
 					throw std::runtime_error("Invalid data type for binary not.");
 				}
 
-				break;
 			}
+			VM_NEXT;
 
-			case OpCode::SHL:
+			VM_CASE(SHL):
 			{
-				OpBinary<'<'>();
-				break;
+				OpBinary<'<', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::SHR:
+			VM_CASE(SHR):
 			{
-				OpBinary<'>'>();
-				break;
+				OpBinary<'>', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::ROTL:
+			VM_CASE(ROTL):
 			{
-				OpBinary<'l'>();
-				break;
+				OpBinary<'l', checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::ROTR:
+			VM_CASE(ROTR):
 			{
-				OpBinary<'r'>();
-				break;
+				OpBinary<'r', checks>();
 			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
 			// ----------------------------------------------------
 			// type casts
 			// ----------------------------------------------------
-			case OpCode::TOR: // converts value to t_real
+			VM_CASE(TOR): // converts value to t_real
 			{
-				OpCast<m_realidx>();
-				break;
+				OpCast<m_realidx, checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::TOI: // converts value to t_int
+			VM_CASE(TOI): // converts value to t_int
 			{
-				OpCast<m_intidx>();
-				break;
+				OpCast<m_intidx, checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::TOC: // converts value to t_cplx
+			VM_CASE(TOC): // converts value to t_cplx
 			{
-				OpCast<m_cplxidx>();
-				break;
+				OpCast<m_cplxidx, checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::TOQ: // converts value to t_quat
+			VM_CASE(TOQ): // converts value to t_quat
 			{
-				OpCast<m_quatidx>();
-				break;
+				OpCast<m_quatidx, checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::TOB: // converts value to t_bool
+			VM_CASE(TOB): // converts value to t_bool
 			{
-				OpCast<m_boolidx>();
-				break;
+				OpCast<m_boolidx, checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::TOS: // converts value to t_str
+			VM_CASE(TOS): // converts value to t_str
 			{
-				OpCast<m_stridx>();
-				break;
+				OpCast<m_stridx, checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::TOREALARR: // converts value to t_vec_real
+			VM_CASE(TOREALARR): // converts value to t_vec_real
 			{
-				t_addr vec_size = PopAddress();
-				OpCastToArray<t_vec_real>(vec_size);
-				break;
+				t_addr vec_size = PopAddress<checks>();
+				OpCastToArray<t_vec_real, checks>(vec_size);
 			}
+			VM_NEXT;
 
-			case OpCode::TOINTARR: // converts value to t_vec_int
+			VM_CASE(TOINTARR): // converts value to t_vec_int
 			{
-				t_addr vec_size = PopAddress();
-				OpCastToArray<t_vec_int>(vec_size);
-				break;
+				t_addr vec_size = PopAddress<checks>();
+				OpCastToArray<t_vec_int, checks>(vec_size);
 			}
+			VM_NEXT;
 
-			case OpCode::TOCPLXARR: // converts value to t_vec_cplx
+			VM_CASE(TOCPLXARR): // converts value to t_vec_cplx
 			{
-				t_addr vec_size = PopAddress();
-				OpCastToArray<t_vec_cplx>(vec_size);
-				break;
+				t_addr vec_size = PopAddress<checks>();
+				OpCastToArray<t_vec_cplx, checks>(vec_size);
 			}
+			VM_NEXT;
 
-			case OpCode::TOQUATARR: // converts value to t_vec_quat
+			VM_CASE(TOQUATARR): // converts value to t_vec_quat
 			{
-				t_addr vec_size = PopAddress();
-				OpCastToArray<t_vec_quat>(vec_size);
-				break;
+				t_addr vec_size = PopAddress<checks>();
+				OpCastToArray<t_vec_quat, checks>(vec_size);
 			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
 			// ----------------------------------------------------
 			// jumps and function calls
 			// ----------------------------------------------------
-			case OpCode::JMP: // jump to direct address
+			VM_CASE(JMP): // jump to direct address
 			{
 				// get address from stack and set ip
-				m_ip = PopAddress();
-				break;
+				m_ip = PopAddress<checks>();
 			}
+			VM_NEXT;
 
-			case OpCode::JMPCND: // conditional jump to direct address
+			VM_CASE(JMPCND): // conditional jump to direct address
 			{
 				// get address from stack
-				t_addr addr = PopAddress();
+				t_addr addr = PopAddress<checks>();
 
 				// get boolean condition result from stack
-				bool boolcond = PopBool();
+				bool boolcond = PopBool<checks>();
 
-				if(m_debug)
+				if constexpr(debug)
 				{
 					if(!boolcond)
 						std::cout << "no ";
@@ -675,8 +1660,70 @@ bool VM::Run()
 				// set instruction pointer
 				if(boolcond)
 					m_ip = addr;
-				break;
 			}
+			VM_NEXT;
+
+			VM_CASE(JMPIFNOT): // jump to direct address if the condition is false
+			{
+				if(!PopBool<checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTGT): // compare and jump to direct address if not >
+			{
+				if(!OpCompare<OpCode::GT, checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTLT): // compare and jump to direct address if not <
+			{
+				if(!OpCompare<OpCode::LT, checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTGEQU): // compare and jump to direct address if not >=
+			{
+				if(!OpCompare<OpCode::GEQU, checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTLEQU): // compare and jump to direct address if not <=
+			{
+				if(!OpCompare<OpCode::LEQU, checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTEQU): // compare and jump to direct address if not ==
+			{
+				if(!OpCompare<OpCode::EQU, checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPNOTNEQU): // compare and jump to direct address if not !=
+			{
+				if(!OpCompare<OpCode::NEQU, checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPD): // jump to resolved address
+			{
+				m_ip = instr->target;
+			}
+			VM_NEXT;
+
+			VM_CASE(JMPCNDD): // conditional jump to resolved address
+			{
+				if(PopBool<checks>(proven()))
+					m_ip = instr->target;
+			}
+			VM_NEXT;
 
 			/**
 			 * stack frame for functions:
@@ -703,97 +1750,86 @@ bool VM::Run()
 			 * |  func. arg n       |
 			 *  --------------------
 			 */
-			case OpCode::CALL: // function call
+			VM_CASE(CALL): // function call
 			{
 				// get return address and frame size
-				t_addr funcaddr = PopAddress();
-				t_int framesize = std::get<m_intidx>(PopData());
-
-				// save instruction and base pointer and
-				// set up the function's stack frame for local variables
-				PushAddress(m_ip, VMType::ADDR_MEM);
-				PushAddress(m_bp, VMType::ADDR_MEM);
+				t_addr funcaddr = PopAddress<checks>();
+				t_int framesize = std::get<m_intidx>(PopData<checks>());
 
-				if(m_debug)
-				{
-					std::cout << "saved base pointer " << m_bp
-						<< "." << std::endl;
-				}
-				m_bp = m_sp;
-				m_sp -= framesize;
+				call_func(funcaddr, framesize);
+			}
+			VM_NEXT;
 
-				// jump to function
-				m_ip = funcaddr;
-				if(m_debug)
-				{
-					std::cout << "calling function " << funcaddr
-						<< "." << std::endl;
-				}
-				break;
+			VM_CASE(CALLD): // function call with resolved address and frame size
+			{
+				call_func(instr->target, instr->framesize);
 			}
+			VM_NEXT;
 
-			case OpCode::RET: // return from function
+			VM_CASE(RET): // return from function
 			{
 				// get number of function arguments and frame size
-				t_int num_args = std::get<m_intidx>(PopData());
-				t_int framesize = std::get<m_intidx>(PopData());
-
-				// if there are still values on the stack, use then as return values
-				std::vector<t_data> retvals;
-				while(m_sp + framesize < m_bp)
-					retvals.push_back(PopData());
-
-				// zero the stack frame
-				if(m_zeropoppedvals)
-					std::memset(m_mem.get() + m_sp, 0, (m_bp - m_sp)*m_bytesize);
+				t_int num_args = std::get<m_intidx>(PopData<checks>());
+				t_int framesize = std::get<m_intidx>(PopData<checks>());
 
-				// remove the function's stack frame
-				m_sp = m_bp;
+				return_func(num_args, framesize);
+			}
+			VM_NEXT;
 
-				m_bp = PopAddress();
-				m_ip = PopAddress();  // jump back
+			VM_CASE(RETD): // return with resolved number of arguments and frame size
+			{
+				return_func(instr->num_args, instr->framesize);
 
-				if(m_debug)
+				// the return address has been overwritten,
+				// continue in the unverified loop
+				if constexpr(verified)
 				{
-					std::cout << "restored base pointer " << m_bp
-						<< "." << std::endl;
+					if(!IsVerifiedInstr(m_ip))
+					{
+						m_num_ops += num_ops + 1;
+						return std::nullopt;
+					}
 				}
-
-				// remove function arguments from stack
-				for(t_int arg = 0; arg < num_args; ++arg)
-					PopData();
-
-				for(const t_data& retval : retvals)
-					PushData(retval, VMType::UNKNOWN, false);
-				break;
 			}
+			VM_NEXT;
 
-			case OpCode::EXTCALL: // external function call
+			VM_CASE(EXTCALL): // external function call
 			{
-				// get function name
-				const t_str/*&*/ funcname = std::get<m_stridx>(PopData());
+				// get function id or name
+				t_data func = PopData<checks>();
 
-				t_data retval = CallExternal(funcname);
-				PushData(retval, VMType::UNKNOWN, false);
-				break;
+				t_data retval;
+				if(func.index() == m_intidx)
+					retval = CallExternal(static_cast<ExtFunc>(std::get<m_intidx>(func)));
+				else
+					retval = CallExternal(std::get<m_stridx>(func));
+				PushData<checks>(retval, VMType::UNKNOWN, false);
+
+				// the debug mode has been changed by the program
+				if(m_debug != debug)
+				{
+					m_num_ops += num_ops + 1;
+					return std::nullopt;
+				}
 			}
+			VM_NEXT;
 
-			case OpCode::ADDFRAME: // create a stack frame
+			VM_CASE(ADDFRAME): // create a stack frame
 			{
-				t_int framesize = std::get<m_intidx>(PopData());
+				t_int framesize = std::get<m_intidx>(PopData<checks>());
 				m_sp -= framesize;
 
-				if(m_debug)
+				if constexpr(debug)
 				{
 					std::cout << "created stack frame of size "
 						<< framesize << "." << std::endl;
 				}
-				break;
 			}
+			VM_NEXT;
 
-			case OpCode::REMFRAME: // remove a stack frame
+			VM_CASE(REMFRAME): // remove a stack frame
 			{
-				t_int framesize = std::get<m_intidx>(PopData());
+				t_int framesize = std::get<m_intidx>(PopData<checks>());
 
 				// zero the stack frame
 				if(m_zeropoppedvals)
@@ -801,16 +1837,32 @@ bool VM::Run()
 
 				m_sp += framesize;
 
-				if(m_debug)
+				if constexpr(debug)
 				{
 					std::cout << "removed stack frame of size "
 						<< framesize << "." << std::endl;
 				}
-				break;
 			}
+			VM_NEXT;
+
+			VM_CASE(ADDFRAMED): // create a stack frame of resolved size
+			{
+				m_sp -= instr->framesize;
+			}
+			VM_NEXT;
+
+			VM_CASE(REMFRAMED): // remove a stack frame of resolved size
+			{
+				// zero the stack frame
+				if(m_zeropoppedvals)
+					std::memset(m_mem.get() + m_sp, 0, instr->framesize*m_bytesize);
+
+				m_sp += instr->framesize;
+			}
+			VM_NEXT;
 			// ----------------------------------------------------
 
-			default:
+			VM_DEFAULT:
 			{
 				std::cerr << "Error: Invalid instruction " << std::hex
 					<< static_cast<t_addr>(op) << std::dec
@@ -819,24 +1871,8 @@ bool VM::Run()
 			}
 		}  // switch(op)
 		++num_ops;
-
-		// wrap around
-		if(m_ip >= m_memsize)
-		{
-			m_ip %= m_memsize;
-
-			if(m_debug)
-			{
-				std::cout << "ip wrapped around memory limit."
-					<< std::endl;
-			}
-		}
 	}  // while(running)
 
-	if(m_debug)
-	{
-		std::cout << "Ran " << num_ops << " instructions." << std::endl;
-	}
-
+	m_num_ops += num_ops;
 	return true;
 }
@@ -19,7 +19,12 @@ using t_vm_real = ::t_real;
 using t_vm_cplx = ::t_cplx;
 using t_vm_quat = ::t_quat;
 
-using t_vm_addr = std::int32_t;
+// 64 bit addresses allow for code, stack and arrays larger than 2 GiB
+#ifdef USE_ADDR64
+	using t_vm_addr = std::int64_t;
+#else
+	using t_vm_addr = std::int32_t;
+#endif
 using t_vm_byte = std::uint8_t;
 using t_vm_bool = t_vm_byte;
 using t_vm_str = std::string;
@@ -117,79 +122,155 @@ constexpr t_str get_vm_type_name(VMType ty)
 constexpr const t_vm_addr g_vm_longest_size = 64;
 
 
+// with aligned stack slots, the type descriptor takes up a full word and
+// all values are padded to multiples of the slot size, so that every real,
+// integer, bool or address is a single, aligned slot on the stack
+#ifdef USE_ALIGNED_STACK
+	constexpr const t_vm_addr g_vm_descr_size = 8;
+	constexpr const t_vm_addr g_vm_slot_size = 16;
+#else
+	constexpr const t_vm_addr g_vm_descr_size = sizeof(t_vm_byte);
+	constexpr const t_vm_addr g_vm_slot_size = 1;
+#endif
+
+
+/**
+ * size of a value with its type descriptor, rounded up to the slot size
+ */
+constexpr t_vm_addr vm_slot_size(t_vm_addr size_with_descr)
+{
+	return (size_with_descr + g_vm_slot_size - 1) / g_vm_slot_size * g_vm_slot_size;
+}
+
+
+/**
+ * padding following a value of the given size (without type descriptor)
+ */
+constexpr t_vm_addr vm_padding_size(t_vm_addr size)
+{
+	return vm_slot_size(size + g_vm_descr_size) - size - g_vm_descr_size;
+}
+
+
+/**
+ * padding following an untagged value, i.e. a value without type descriptor
+ */
+constexpr t_vm_addr vm_untagged_padding_size(t_vm_addr size)
+{
+	return vm_slot_size(size) - size;
+}
+
+
 /**
- * get (static) type sizes (including data type and, optionally, descriptor byte)
+ * get (static) type sizes (including data type and, optionally, descriptor and padding)
  */
 template<VMType ty, bool with_descr = false> constexpr t_vm_addr vm_type_size
-	= g_vm_longest_size + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(g_vm_longest_size + g_vm_descr_size) : g_vm_longest_size;
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::UNKNOWN, with_descr>
-	= g_vm_longest_size + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(g_vm_longest_size + g_vm_descr_size) : g_vm_longest_size;
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::REAL, with_descr>
-	= sizeof(t_vm_real) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_real) + g_vm_descr_size) : sizeof(t_vm_real);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::CPLX, with_descr>
-	= sizeof(t_vm_cplx) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_cplx) + g_vm_descr_size) : sizeof(t_vm_cplx);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::QUAT, with_descr>
-	= sizeof(t_vm_quat) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_quat) + g_vm_descr_size) : sizeof(t_vm_quat);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::INT, with_descr>
-	= sizeof(t_vm_int) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_int) + g_vm_descr_size) : sizeof(t_vm_int);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::BOOL, with_descr>
-	= sizeof(t_vm_bool) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_bool) + g_vm_descr_size) : sizeof(t_vm_bool);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::ADDR_MEM, with_descr>
-	= sizeof(t_vm_addr) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_addr) + g_vm_descr_size) : sizeof(t_vm_addr);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::ADDR_IP, with_descr>
-	= sizeof(t_vm_addr) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_addr) + g_vm_descr_size) : sizeof(t_vm_addr);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::ADDR_SP, with_descr>
-	= sizeof(t_vm_addr) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_addr) + g_vm_descr_size) : sizeof(t_vm_addr);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::ADDR_BP, with_descr>
-	= sizeof(t_vm_addr) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_addr) + g_vm_descr_size) : sizeof(t_vm_addr);
 template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::ADDR_GBP, with_descr>
-	= sizeof(t_vm_addr) + (with_descr ? sizeof(t_vm_byte) : 0);
+	= with_descr ? vm_slot_size(sizeof(t_vm_addr) + g_vm_descr_size) : sizeof(t_vm_addr);
 //template<bool with_descr> constexpr inline t_vm_addr vm_type_size<VMType::STR, with_descr>
 //	= g_vm_longest_size + (with_descr ? sizeof(t_vm_byte) : 0);
 
 
+// distance from a direct address in the code to the instruction pointer
+// after the jump, call or read instruction that follows it
+constexpr const t_vm_addr g_vm_addr_skip = vm_type_size<VMType::ADDR_IP, true>
+	- g_vm_descr_size + sizeof(t_vm_byte);
+
+
 static inline t_vm_addr get_vm_str_size(t_vm_addr raw_len,
 	bool with_descr = false, bool with_len = false)
 {
-	return raw_len*sizeof(t_vm_byte)
-		+ (with_len ? sizeof(t_vm_addr) : 0)
-		+ (with_descr ? sizeof(t_vm_byte) : 0);
+	t_vm_addr size = raw_len*sizeof(t_vm_byte)
+		+ (with_len ? sizeof(t_vm_addr) : 0);
+
+	return with_descr ? vm_slot_size(size + g_vm_descr_size) : size;
 }
 
 
 static inline t_vm_addr get_vm_vec_real_size(t_vm_addr raw_len,
 	bool with_descr = false, bool with_len = false)
 {
-	return raw_len*sizeof(t_vm_real)
-		+ (with_len ? sizeof(t_vm_addr) : 0)
-		+ (with_descr ? sizeof(t_vm_byte) : 0);
+	t_vm_addr size = raw_len*sizeof(t_vm_real)
+		+ (with_len ? sizeof(t_vm_addr) : 0);
+
+	return with_descr ? vm_slot_size(size + g_vm_descr_size) : size;
 }
 
 
 static inline t_vm_addr get_vm_vec_int_size(t_vm_addr raw_len,
 	bool with_descr = false, bool with_len = false)
 {
-	return raw_len*sizeof(t_vm_int)
-		+ (with_len ? sizeof(t_vm_addr) : 0)
-		+ (with_descr ? sizeof(t_vm_byte) : 0);
+	t_vm_addr size = raw_len*sizeof(t_vm_int)
+		+ (with_len ? sizeof(t_vm_addr) : 0);
+
+	return with_descr ? vm_slot_size(size + g_vm_descr_size) : size;
 }
 
 
 static inline t_vm_addr get_vm_vec_cplx_size(t_vm_addr raw_len,
 	bool with_descr = false, bool with_len = false)
 {
-	return raw_len*sizeof(t_vm_real)*2
-		+ (with_len ? sizeof(t_vm_addr) : 0)
-		+ (with_descr ? sizeof(t_vm_byte) : 0);
+	t_vm_addr size = raw_len*sizeof(t_vm_real)*2
+		+ (with_len ? sizeof(t_vm_addr) : 0);
+
+	return with_descr ? vm_slot_size(size + g_vm_descr_size) : size;
 }
 
 
 static inline t_vm_addr get_vm_vec_quat_size(t_vm_addr raw_len,
 	bool with_descr = false, bool with_len = false)
 {
-	return raw_len*sizeof(t_vm_real)*4
-		+ (with_len ? sizeof(t_vm_addr) : 0)
-		+ (with_descr ? sizeof(t_vm_byte) : 0);
+	t_vm_addr size = raw_len*sizeof(t_vm_real)*4
+		+ (with_len ? sizeof(t_vm_addr) : 0);
+
+	return with_descr ? vm_slot_size(size + g_vm_descr_size) : size;
+}
+
+
+
+/**
+ * write a type descriptor for direct data in the code
+ */
+template<class t_ostr>
+void write_vm_descr(t_ostr& ostr, VMType ty)
+{
+	ostr.put(static_cast<t_vm_byte>(ty));
+
+	for(t_vm_addr i = sizeof(t_vm_byte); i < g_vm_descr_size; ++i)
+		ostr.put(0);
+}
+
+
+/**
+ * pad direct data of the given size (without type descriptor) in the code,
+ * so that it has the same layout as on the stack
+ */
+template<class t_ostr>
+void write_vm_padding(t_ostr& ostr, t_vm_addr size)
+{
+	for(t_vm_addr i = 0; i < vm_padding_size(size); ++i)
+		ostr.put(0);
 }
 
 
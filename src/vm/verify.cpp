@@ -0,0 +1,1125 @@
+/**
+ * zero-address code vm, load-time verifier of the decoded instructions
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "vm.h"
+#include "mem.h"
+
+#include <map>
+#include <set>
+#include <deque>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+
+namespace {
+
+/**
+ * abstract value on the stack
+ */
+struct AbsValue
+{
+	VMType ty{VMType::UNKNOWN};     // proven data type
+	std::optional<t_vm_int> val{};  // constant integer or address
+	bool untagged{false};           // integer or real without type descriptor
+
+	bool operator==(const AbsValue&) const = default;
+};
+
+
+// types of the scalar variables, indexed by their offset to the base pointer
+using t_vartypes = std::map<t_vm_addr, VMType>;
+
+
+/**
+ * abstract machine state at the start of a basic block
+ */
+struct AbsState
+{
+	std::vector<AbsValue> stack{};  // values on the stack of the current function
+	t_vartypes locals{};            // variables relative to the base pointer
+	t_vartypes globals{};           // variables relative to the global base pointer
+
+	bool operator==(const AbsState&) const = default;
+};
+
+
+/**
+ * what the callers of a function need to know about it
+ */
+struct FuncSummary
+{
+	t_vm_int framesize{0};                      // size of the local variables
+	std::optional<t_vm_int> num_args{};         // known once the function returns
+	std::optional<std::vector<VMType>> args{};  // argument types, first argument first
+	std::optional<std::vector<VMType>> rets{};  // return value types, in the caller's order
+};
+
+
+/**
+ * size of a scalar including its type descriptor
+ */
+std::optional<t_vm_addr> get_scalar_size(VMType ty)
+{
+	switch(ty)
+	{
+		case VMType::REAL: return vm_type_size<VMType::REAL, true>;
+		case VMType::INT: return vm_type_size<VMType::INT, true>;
+		case VMType::CPLX: return vm_type_size<VMType::CPLX, true>;
+		case VMType::QUAT: return vm_type_size<VMType::QUAT, true>;
+		case VMType::BOOL: return vm_type_size<VMType::BOOL, true>;
+		default: return std::nullopt;
+	}
+}
+
+
+/**
+ * type of a value that can have either of the two types
+ */
+VMType join_types(VMType ty1, VMType ty2)
+{
+	return ty1 == ty2 ? ty1 : VMType::UNKNOWN;
+}
+
+
+/**
+ * join the argument or return value types of a function
+ * @returns true if the types have changed
+ */
+bool join_types(std::optional<std::vector<VMType>>& tys, const std::vector<VMType>& other)
+{
+	if(!tys)
+	{
+		tys = other;
+		return true;
+	}
+
+	if(tys->size() != other.size())
+		throw std::runtime_error("Function returns different numbers of values.");
+
+	bool changed = false;
+	for(std::size_t idx = 0; idx < other.size(); ++idx)
+	{
+		VMType ty = join_types((*tys)[idx], other[idx]);
+		changed = changed || ty != (*tys)[idx];
+		(*tys)[idx] = ty;
+	}
+
+	return changed;
+}
+
+
+/**
+ * only keep the variable types that are the same in both states
+ */
+void join_vars(t_vartypes& vars, const t_vartypes& other)
+{
+	std::erase_if(vars, [&other](const auto& var) -> bool
+	{
+		auto iter = other.find(var.first);
+		return iter == other.end() || iter->second != var.second;
+	});
+}
+
+
+/**
+ * merge a state reaching a block into the block's state
+ * @returns true if the block's state has changed
+ */
+bool join_states(AbsState& state, const AbsState& other, t_vm_addr addr)
+{
+	if(state.stack.size() != other.stack.size())
+	{
+		throw std::runtime_error("Stack depth differs between the paths to address "
+			+ std::to_string(addr) + ".");
+	}
+
+	AbsState joined = state;
+	for(std::size_t idx = 0; idx < other.stack.size(); ++idx)
+	{
+		AbsValue& val = joined.stack[idx];
+		const AbsValue& otherval = other.stack[idx];
+
+		// the untagged values have different sizes than the tagged ones
+		if(val.untagged != otherval.untagged)
+		{
+			throw std::runtime_error("Stack layout differs between the paths to address "
+				+ std::to_string(addr) + ".");
+		}
+
+		val.ty = join_types(val.ty, otherval.ty);
+		if(val.val != otherval.val)
+			val.val.reset();
+	}
+	join_vars(joined.locals, other.locals);
+	join_vars(joined.globals, other.globals);
+
+	if(joined == state)
+		return false;
+
+	state = std::move(joined);
+	return true;
+}
+
+
+/**
+ * forget the variables that overlap with written memory
+ * @param size size of the written value, unknown for dynamic sizes
+ */
+void clobber_vars(t_vartypes& vars, t_vm_addr addr, std::optional<t_vm_addr> size)
+{
+	std::erase_if(vars, [addr, size](const auto& var) -> bool
+	{
+		t_vm_addr var_end = var.first + *get_scalar_size(var.second);
+		return var_end > addr && (!size || var.first < addr + *size);
+	});
+}
+
+
+/**
+ * result type of an arithmetic operation
+ */
+VMType get_arithmetic_type(VMType ty1, VMType ty2)
+{
+	// operations on the same types mostly give the same type,
+	// but, e.g., the product of two arrays is a scalar
+	if(ty1 == ty2 && (ty1 == VMType::REAL || ty1 == VMType::INT ||
+		ty1 == VMType::CPLX || ty1 == VMType::QUAT || ty1 == VMType::STR))
+		return ty1;
+
+	return VMType::UNKNOWN;
+}
+
+
+/**
+ * result type of a cast, unconvertible values are kept
+ */
+VMType get_cast_type(VMType from, VMType to)
+{
+	if(from == to || from == VMType::REAL || from == VMType::INT)
+		return to;
+
+	return VMType::UNKNOWN;
+}
+
+}  // anonymous namespace
+
+
+
+/**
+ * abstractly interpret the decoded instructions of the main code and of all
+ * called functions, so that they can be run without type tests, see
+ * RunInstructions()
+ *
+ * the verifier tracks the depth of the stack and the types of its values
+ * and of the scalar variables at constant stack frame offsets. it checks:
+ *   - that all reachable instructions and jump targets are decoded
+ *     instruction boundaries,
+ *   - that the stack depth is the same on all paths to an instruction and
+ *     never drops below the stack frame of the current function,
+ *   - that all calls and returns of a function use the same frame size
+ *     and number of arguments,
+ *   - that variables are only written at constant addresses inside of the
+ *     current stack frame or the global frame,
+ *   - that values without type descriptors are only used by the instructions
+ *     for untagged values of the same type.
+ *
+ * the summaries of the functions, i.e. their argument and return value
+ * types, are iterated until they do not change anymore.
+ *
+ * @returns true if the code has been verified
+ */
+bool VM::VerifyCode()
+{
+	if(m_code_verified)
+		return *m_code_verified;
+
+	DecodeCode();
+
+	const t_addr code_begin = m_code_range[0];
+	const t_addr code_end = m_code_range[1];
+	const t_addr entry = 0;  // see Reset()
+
+	// get the decoded instruction at an address
+	auto get_instr = [this, code_begin, code_end](t_addr addr) -> DecodedInstr&
+	{
+		if(addr < code_begin || addr >= code_end)
+		{
+			throw std::runtime_error("Address " + std::to_string(addr)
+				+ " is outside of the code.");
+		}
+
+		DecodedInstr& instr = m_decoded[addr - code_begin];
+		if(instr.op == OpCode::INVALID)
+		{
+			throw std::runtime_error("No decoded instruction at address "
+				+ std::to_string(addr) + ".");
+		}
+
+		return instr;
+	};
+
+	auto clear_results = [this]()
+	{
+		for(DecodedInstr& instr : m_decoded)
+		{
+			instr.verified = false;
+			instr.optype = VMType::UNKNOWN;
+		}
+	};
+
+	std::size_t num_verified = 0;
+	std::size_t num_funcs = 0;
+
+	try
+	{
+		if(m_decoded.empty() || entry < code_begin || entry >= code_end)
+			throw std::runtime_error("No code.");
+
+		// jump and call targets start the blocks
+		std::set<t_addr> leaders;
+		for(const DecodedInstr& instr : m_decoded)
+		{
+			switch(instr.op)
+			{
+				case OpCode::JMPD: case OpCode::JMPCNDD: case OpCode::CALLD:
+				case OpCode::JMPIFNOT: case OpCode::JMPNOTGT: case OpCode::JMPNOTLT:
+				case OpCode::JMPNOTGEQU: case OpCode::JMPNOTLEQU:
+				case OpCode::JMPNOTEQU: case OpCode::JMPNOTNEQU:
+				case OpCode::JMPNOTGT_IU: case OpCode::JMPNOTLT_IU:
+				case OpCode::JMPNOTGEQU_IU: case OpCode::JMPNOTLEQU_IU:
+				case OpCode::JMPNOTEQU_IU: case OpCode::JMPNOTNEQU_IU:
+				case OpCode::JMPNOTGT_RU: case OpCode::JMPNOTLT_RU:
+				case OpCode::JMPNOTGEQU_RU: case OpCode::JMPNOTLEQU_RU:
+				case OpCode::JMPNOTEQU_RU: case OpCode::JMPNOTNEQU_RU:
+					leaders.insert(instr.target);
+					break;
+				default:
+					break;
+			}
+		}
+		const bool entry_is_target = leaders.contains(entry);
+		leaders.insert(entry);
+
+		// the global stack frame is created at the start of the program
+		t_int global_framesize = 0;
+		if(const DecodedInstr& instr = get_instr(entry); instr.op == OpCode::ADDFRAMED)
+			global_framesize = instr.framesize;
+		if(global_framesize < 0)
+			throw std::runtime_error("Invalid global stack frame size.");
+
+		std::map<t_addr, FuncSummary> funcs;  // called functions by address
+		bool funcs_write_globals = false;     // do functions change global variables?
+		bool changed = true;                  // have any function summaries changed?
+
+		// interpret the main code (if func == nullptr) or a function
+		auto verify_unit = [&](t_addr unit_entry, FuncSummary* func)
+		{
+			const bool is_main = (func == nullptr);
+			const t_int framesize = is_main ? global_framesize : func->framesize;
+
+			// the arguments follow the saved instruction and base pointers
+			AbsState init{};
+			if(func && func->args)
+			{
+				t_addr offs = 2*vm_type_size<VMType::ADDR_MEM, true>;
+				for(VMType ty : *func->args)
+				{
+					std::optional<t_addr> size = get_scalar_size(ty);
+					if(!size)
+						break;
+
+					init.locals.emplace(offs, ty);
+					offs += *size;
+				}
+			}
+
+			std::map<t_addr, AbsState> states;  // states at the start of the blocks
+			std::deque<t_addr> worklist;        // blocks to (re-)interpret
+			states.emplace(unit_entry, std::move(init));
+			worklist.push_back(unit_entry);
+
+			// a state reaches a block
+			auto flow = [&states, &worklist](t_addr addr, const AbsState& state)
+			{
+				auto [iter, inserted] = states.try_emplace(addr, state);
+				if(inserted || join_states(iter->second, state, addr))
+					worklist.push_back(addr);
+			};
+
+			auto pop = [](AbsState& state, t_addr addr) -> AbsValue
+			{
+				if(state.stack.empty())
+				{
+					throw std::runtime_error("Stack underflow at address "
+						+ std::to_string(addr) + ".");
+				}
+
+				AbsValue val = state.stack.back();
+				if(val.untagged)
+				{
+					throw std::runtime_error("Untagged value used by a tagged instruction at address "
+						+ std::to_string(addr) + ".");
+				}
+
+				state.stack.pop_back();
+				return val;
+			};
+
+			// pop an integer or real without type descriptor
+			auto pop_untagged = [](AbsState& state, VMType ty, t_addr addr)
+			{
+				if(state.stack.empty())
+				{
+					throw std::runtime_error("Stack underflow at address "
+						+ std::to_string(addr) + ".");
+				}
+
+				const AbsValue& val = state.stack.back();
+				if(!val.untagged || val.ty != ty)
+				{
+					throw std::runtime_error("Expected an untagged "
+						+ std::string(get_vm_type_name(ty)) + " at address "
+						+ std::to_string(addr) + ".");
+				}
+
+				state.stack.pop_back();
+			};
+
+			auto pop_n = [&pop](AbsState& state, t_int num, t_addr addr)
+			{
+				for(t_int idx = 0; idx < num; ++idx)
+					pop(state, addr);
+			};
+
+			auto push = [](AbsState& state, VMType ty,
+				std::optional<t_int> val = std::nullopt)
+			{
+				state.stack.emplace_back(AbsValue{.ty = ty, .val = val});
+			};
+
+			auto push_untagged = [](AbsState& state, VMType ty)
+			{
+				state.stack.emplace_back(AbsValue{.ty = ty, .untagged = true});
+			};
+
+			// integer or real type of the two values on top of the stack
+			auto scalar_operands = [](const AbsState& state) -> VMType
+			{
+				if(state.stack.size() < 2)
+					return VMType::UNKNOWN;
+
+				VMType ty = state.stack.rbegin()->ty;
+				if((ty == VMType::INT || ty == VMType::REAL)
+					&& std::next(state.stack.rbegin())->ty == ty)
+					return ty;
+
+				return VMType::UNKNOWN;
+			};
+
+			// get the variables and the frame size for a base register
+			auto get_frame = [&](AbsState& state, VMType base)
+				-> std::tuple<t_vartypes*, t_int>
+			{
+				// the base pointer is the global base pointer in the main code
+				if(base == VMType::ADDR_GBP || (is_main && base == VMType::ADDR_BP))
+					return std::make_tuple(&state.globals, global_framesize);
+				else if(base == VMType::ADDR_BP)
+					return std::make_tuple(&state.locals, framesize);
+
+				return std::make_tuple(nullptr, 0);
+			};
+
+			// type of a variable that is read
+			auto read_var = [&get_frame](AbsState& state, VMType base,
+				std::optional<t_int> offs) -> VMType
+			{
+				auto [vars, frame] = get_frame(state, base);
+				if(!vars || !offs)
+					return VMType::UNKNOWN;
+
+				auto iter = vars->find(static_cast<t_addr>(*offs));
+				return iter == vars->end() ? VMType::UNKNOWN : iter->second;
+			};
+
+			// check a write to a variable and update the variable types
+			// @param elems writes array or string elements, not the whole variable
+			auto write_var = [&](AbsState& state, VMType base, std::optional<t_int> _offs,
+				VMType ty, bool elems, t_addr addr)
+			{
+				auto [vars, frame] = get_frame(state, base);
+				if(!vars || !_offs)
+				{
+					throw std::runtime_error("Write to a computed address at address "
+						+ std::to_string(addr) + ".");
+				}
+
+				if(vars == &state.globals && !is_main && !funcs_write_globals)
+				{
+					funcs_write_globals = true;
+					changed = true;
+				}
+
+				const t_addr offs = static_cast<t_addr>(*_offs);
+				std::optional<t_addr> size = get_scalar_size(ty);
+
+				bool in_frame = (offs >= -frame && (size ? offs + *size <= 0 : offs < 0));
+
+				// function arguments can only be overwritten in place
+				if(offs >= 0 && vars == &state.locals)
+				{
+					if(elems)
+					{
+						in_frame = true;
+					}
+					else if(size)
+					{
+						auto iter = vars->find(offs);
+						in_frame = (iter != vars->end() && iter->second == ty);
+					}
+				}
+
+				if(!in_frame)
+				{
+					throw std::runtime_error("Write outside of the stack frame at address "
+						+ std::to_string(addr) + ".");
+				}
+
+				if(elems)
+				{
+					clobber_vars(*vars, offs, std::nullopt);
+					return;
+				}
+
+				clobber_vars(*vars, offs, size);
+				if(size)
+					(*vars)[offs] = ty;
+			};
+
+			while(!worklist.empty())
+			{
+				const t_addr block = worklist.front();
+				worklist.pop_front();
+				AbsState state = states.at(block);
+
+				for(t_addr addr = block;;)
+				{
+					DecodedInstr& instr = get_instr(addr);
+					t_addr next = instr.next_ip;
+					bool block_end = false;
+					VMType optype = VMType::UNKNOWN;              // proven operand type
+
+					switch(instr.op)
+					{
+						case OpCode::HALT:
+							block_end = true;
+							break;
+
+						case OpCode::NOP:
+							break;
+
+						case OpCode::PUSHD:
+						{
+							VMType ty = static_cast<VMType>(m_mem[instr.data_addr]);
+							std::optional<t_int> val;
+							if(ty == VMType::INT)
+								val = ReadMemRaw<t_int>(instr.data_addr + m_descrsize);
+							else if(ty == VMType::ADDR_MEM || ty == VMType::ADDR_BP
+								|| ty == VMType::ADDR_GBP)
+								val = ReadMemRaw<t_addr>(instr.data_addr + m_descrsize);
+							push(state, ty, val);
+							break;
+						}
+
+						case OpCode::WRMEM:
+						{
+							AbsValue varaddr = pop(state, addr);
+							AbsValue val = pop(state, addr);
+							write_var(state, varaddr.ty, varaddr.val, val.ty, false, addr);
+							break;
+						}
+
+						case OpCode::RDMEM:
+						{
+							AbsValue varaddr = pop(state, addr);
+							push(state, read_var(state, varaddr.ty, varaddr.val));
+							break;
+						}
+
+						case OpCode::LOADLOCAL:
+							push(state, read_var(state, VMType::ADDR_BP, instr.var_addr));
+							break;
+
+						case OpCode::LOADGLOBAL:
+							push(state, read_var(state, VMType::ADDR_GBP, instr.var_addr));
+							break;
+
+						case OpCode::STORELOCAL:
+						{
+							AbsValue val = pop(state, addr);
+							write_var(state, VMType::ADDR_BP, instr.var_addr, val.ty, false, addr);
+							break;
+						}
+
+						case OpCode::STOREGLOBAL:
+						{
+							AbsValue val = pop(state, addr);
+							write_var(state, VMType::ADDR_GBP, instr.var_addr, val.ty, false, addr);
+							break;
+						}
+
+						case OpCode::RDARR:
+						case OpCode::RDARRM:
+							pop_n(state, 2, addr);
+							push(state, VMType::UNKNOWN);
+							break;
+
+						case OpCode::RDARRR:
+						case OpCode::RDARRRM:
+							pop_n(state, 3, addr);
+							push(state, VMType::UNKNOWN);
+							break;
+
+						case OpCode::WRARR:
+						case OpCode::WRARRR:
+						{
+							// indices and value
+							pop_n(state, instr.op == OpCode::WRARR ? 2 : 3, addr);
+							AbsValue varaddr = pop(state, addr);
+							write_var(state, varaddr.ty, varaddr.val, VMType::UNKNOWN, true, addr);
+							break;
+						}
+
+						case OpCode::CPARRR:
+						{
+							// indices and source address
+							pop_n(state, 5, addr);
+							AbsValue varaddr = pop(state, addr);
+							write_var(state, varaddr.ty, varaddr.val, VMType::UNKNOWN, true, addr);
+							break;
+						}
+
+						case OpCode::MAKEREALARR:
+						case OpCode::MAKEINTARR:
+						case OpCode::MAKECPLXARR:
+						case OpCode::MAKEQUATARR:
+						{
+							AbsValue num = pop(state, addr);
+							if(num.ty != VMType::ADDR_MEM || !num.val || *num.val < 0)
+							{
+								throw std::runtime_error("Unknown array size at address "
+									+ std::to_string(addr) + ".");
+							}
+							pop_n(state, *num.val, addr);
+
+							VMType ty = VMType::REALARR;
+							if(instr.op == OpCode::MAKEINTARR)
+								ty = VMType::INTARR;
+							else if(instr.op == OpCode::MAKECPLXARR)
+								ty = VMType::CPLXARR;
+							else if(instr.op == OpCode::MAKEQUATARR)
+								ty = VMType::QUATARR;
+							push(state, ty);
+							break;
+						}
+
+						case OpCode::USUB:
+						{
+							VMType ty = pop(state, addr).ty;
+							push(state, ty == VMType::BOOL || ty == VMType::STR
+								? VMType::UNKNOWN : ty);
+							break;
+						}
+
+						case OpCode::ADD: case OpCode::SUB:
+						case OpCode::MUL: case OpCode::DIV:
+						case OpCode::MOD: case OpCode::POW:
+						case OpCode::ADD_I: case OpCode::SUB_I:
+						case OpCode::MUL_I: case OpCode::DIV_I:
+						case OpCode::ADD_R: case OpCode::SUB_R:
+						case OpCode::MUL_R: case OpCode::DIV_R:
+						{
+							optype = scalar_operands(state);
+							VMType ty2 = pop(state, addr).ty;
+							VMType ty1 = pop(state, addr).ty;
+							push(state, get_arithmetic_type(ty1, ty2));
+							break;
+						}
+
+						case OpCode::MATMUL:
+							pop_n(state, 2, addr);
+							push(state, VMType::UNKNOWN);
+							break;
+
+						case OpCode::AND:
+						case OpCode::OR:
+						case OpCode::XOR:
+							pop_n(state, 2, addr);
+							push(state, VMType::BOOL);
+							break;
+
+						case OpCode::NOT:
+							pop(state, addr);
+							push(state, VMType::BOOL);
+							break;
+
+						case OpCode::GT: case OpCode::LT:
+						case OpCode::GEQU: case OpCode::LEQU:
+						case OpCode::EQU: case OpCode::NEQU:
+						case OpCode::GT_I: case OpCode::LT_I:
+						case OpCode::GEQU_I: case OpCode::LEQU_I:
+						case OpCode::EQU_I: case OpCode::NEQU_I:
+						case OpCode::GT_R: case OpCode::LT_R:
+						case OpCode::GEQU_R: case OpCode::LEQU_R:
+						case OpCode::EQU_R: case OpCode::NEQU_R:
+							optype = scalar_operands(state);
+							pop_n(state, 2, addr);
+							push(state, VMType::BOOL);
+							break;
+
+						case OpCode::BINAND: case OpCode::BINOR:
+						case OpCode::BINXOR: case OpCode::SHL:
+						case OpCode::SHR: case OpCode::ROTL:
+						case OpCode::ROTR:
+							pop_n(state, 2, addr);
+							push(state, VMType::INT);
+							break;
+
+						case OpCode::BINNOT:
+							pop(state, addr);
+							push(state, VMType::INT);
+							break;
+
+						case OpCode::TOR:
+							push(state, get_cast_type(pop(state, addr).ty, VMType::REAL));
+							break;
+
+						case OpCode::TOI:
+							push(state, get_cast_type(pop(state, addr).ty, VMType::INT));
+							break;
+
+						case OpCode::TOC:
+							push(state, get_cast_type(pop(state, addr).ty, VMType::CPLX));
+							break;
+
+						case OpCode::TOQ:
+							push(state, get_cast_type(pop(state, addr).ty, VMType::QUAT));
+							break;
+
+						case OpCode::TOB:
+							push(state, get_cast_type(pop(state, addr).ty, VMType::BOOL));
+							break;
+
+						case OpCode::TOS:
+							push(state, get_cast_type(pop(state, addr).ty, VMType::STR));
+							break;
+
+						case OpCode::TOREALARR:
+						case OpCode::TOINTARR:
+						case OpCode::TOCPLXARR:
+						case OpCode::TOQUATARR:
+						{
+							VMType ty = VMType::REALARR;
+							if(instr.op == OpCode::TOINTARR)
+								ty = VMType::INTARR;
+							else if(instr.op == OpCode::TOCPLXARR)
+								ty = VMType::CPLXARR;
+							else if(instr.op == OpCode::TOQUATARR)
+								ty = VMType::QUATARR;
+
+							pop(state, addr);  // array size
+							push(state, get_cast_type(pop(state, addr).ty, ty));
+							break;
+						}
+
+						case OpCode::JMPD:
+							flow(instr.target, state);
+							block_end = true;
+							break;
+
+						case OpCode::JMPCNDD:
+						case OpCode::JMPIFNOT:
+						{
+							VMType ty = pop(state, addr).ty;
+							if(ty == VMType::BOOL || ty == VMType::INT)
+								optype = ty;
+							flow(instr.target, state);
+							break;
+						}
+
+						case OpCode::JMPNOTGT: case OpCode::JMPNOTLT:
+						case OpCode::JMPNOTGEQU: case OpCode::JMPNOTLEQU:
+						case OpCode::JMPNOTEQU: case OpCode::JMPNOTNEQU:
+							optype = scalar_operands(state);
+							pop_n(state, 2, addr);
+							flow(instr.target, state);
+							break;
+
+						case OpCode::PUSHUD:
+							push_untagged(state, static_cast<VMType>(m_mem[instr.data_addr]));
+							break;
+
+						case OpCode::TAG_I:
+						case OpCode::TAG_R:
+						{
+							VMType ty = (instr.op == OpCode::TAG_I ? VMType::INT : VMType::REAL);
+							pop_untagged(state, ty, addr);
+							push(state, ty);
+							break;
+						}
+
+						case OpCode::UNTAG_I:
+						case OpCode::UNTAG_R:
+						{
+							VMType ty = (instr.op == OpCode::UNTAG_I ? VMType::INT : VMType::REAL);
+							if(pop(state, addr).ty == ty)
+								optype = ty;
+							push_untagged(state, ty);
+							break;
+						}
+
+						case OpCode::LOADLOCAL_IU: case OpCode::LOADLOCAL_RU:
+						case OpCode::LOADGLOBAL_IU: case OpCode::LOADGLOBAL_RU:
+						{
+							VMType ty = get_vm_untagged_type(instr.op);
+							VMType base = (instr.op == OpCode::LOADLOCAL_IU
+								|| instr.op == OpCode::LOADLOCAL_RU) ? VMType::ADDR_BP : VMType::ADDR_GBP;
+							if(read_var(state, base, instr.var_addr) == ty)
+								optype = ty;
+							push_untagged(state, ty);
+							break;
+						}
+
+						case OpCode::STORELOCAL_IU: case OpCode::STORELOCAL_RU:
+						case OpCode::STOREGLOBAL_IU: case OpCode::STOREGLOBAL_RU:
+						{
+							VMType ty = get_vm_untagged_type(instr.op);
+							VMType base = (instr.op == OpCode::STORELOCAL_IU
+								|| instr.op == OpCode::STORELOCAL_RU) ? VMType::ADDR_BP : VMType::ADDR_GBP;
+							pop_untagged(state, ty, addr);
+							write_var(state, base, instr.var_addr, ty, false, addr);
+							break;
+						}
+
+						case OpCode::TOR_IU:
+							pop_untagged(state, VMType::INT, addr);
+							push_untagged(state, VMType::REAL);
+							break;
+
+						case OpCode::TOI_RU:
+							pop_untagged(state, VMType::REAL, addr);
+							push_untagged(state, VMType::INT);
+							break;
+
+						case OpCode::ADD_IU: case OpCode::SUB_IU:
+						case OpCode::MUL_IU: case OpCode::DIV_IU:
+						case OpCode::ADD_RU: case OpCode::SUB_RU:
+						case OpCode::MUL_RU: case OpCode::DIV_RU:
+						{
+							VMType ty = get_vm_untagged_type(instr.op);
+							pop_untagged(state, ty, addr);
+							pop_untagged(state, ty, addr);
+							push_untagged(state, ty);
+							break;
+						}
+
+						case OpCode::GT_IU: case OpCode::LT_IU:
+						case OpCode::GEQU_IU: case OpCode::LEQU_IU:
+						case OpCode::EQU_IU: case OpCode::NEQU_IU:
+						case OpCode::GT_RU: case OpCode::LT_RU:
+						case OpCode::GEQU_RU: case OpCode::LEQU_RU:
+						case OpCode::EQU_RU: case OpCode::NEQU_RU:
+						{
+							VMType ty = get_vm_untagged_type(instr.op);
+							pop_untagged(state, ty, addr);
+							pop_untagged(state, ty, addr);
+							push(state, VMType::BOOL);
+							break;
+						}
+
+						case OpCode::JMPNOTGT_IU: case OpCode::JMPNOTLT_IU:
+						case OpCode::JMPNOTGEQU_IU: case OpCode::JMPNOTLEQU_IU:
+						case OpCode::JMPNOTEQU_IU: case OpCode::JMPNOTNEQU_IU:
+						case OpCode::JMPNOTGT_RU: case OpCode::JMPNOTLT_RU:
+						case OpCode::JMPNOTGEQU_RU: case OpCode::JMPNOTLEQU_RU:
+						case OpCode::JMPNOTEQU_RU: case OpCode::JMPNOTNEQU_RU:
+						{
+							VMType ty = get_vm_untagged_type(instr.op);
+							pop_untagged(state, ty, addr);
+							pop_untagged(state, ty, addr);
+							flow(instr.target, state);
+							break;
+						}
+
+						case OpCode::CALLD:
+						{
+							if(instr.framesize < 0)
+							{
+								throw std::runtime_error("Invalid stack frame size at address "
+									+ std::to_string(addr) + ".");
+							}
+
+							auto [iter, inserted] = funcs.try_emplace(instr.target,
+								FuncSummary{.framesize = instr.framesize});
+							FuncSummary& callee = iter->second;
+							if(inserted)
+								changed = true;
+							else if(callee.framesize != instr.framesize)
+							{
+								throw std::runtime_error("Function " + std::to_string(instr.target)
+									+ " is called with different stack frame sizes.");
+							}
+
+							// the function has not returned (yet)
+							if(!callee.num_args || !callee.rets)
+							{
+								block_end = true;
+								break;
+							}
+
+							if(state.stack.size() < static_cast<std::size_t>(*callee.num_args))
+							{
+								throw std::runtime_error("Stack underflow at address "
+									+ std::to_string(addr) + ".");
+							}
+
+							std::vector<VMType> args;
+							for(t_int arg = 0; arg < *callee.num_args; ++arg)
+								args.push_back(pop(state, addr).ty);
+							if(join_types(callee.args, args))
+								changed = true;
+
+							for(VMType ty : *callee.rets)
+								push(state, ty);
+
+							// the function might have changed global variables
+							if(funcs_write_globals)
+								state.globals.clear();
+							break;
+						}
+
+						case OpCode::RETD:
+						{
+							if(is_main)
+							{
+								throw std::runtime_error("Return outside of a function at address "
+									+ std::to_string(addr) + ".");
+							}
+							if(instr.framesize != framesize || instr.num_args < 0
+								|| (func->num_args && *func->num_args != instr.num_args))
+							{
+								throw std::runtime_error("Function return at address "
+									+ std::to_string(addr) + " does not match its calls.");
+							}
+
+							if(!func->num_args)
+							{
+								func->num_args = instr.num_args;
+								changed = true;
+							}
+
+							// the return values are pushed back in reverse order
+							std::vector<VMType> rets;
+							for(auto iter = state.stack.rbegin(); iter != state.stack.rend(); ++iter)
+							{
+								if(iter->untagged)
+								{
+									throw std::runtime_error("Untagged value returned at address "
+										+ std::to_string(addr) + ".");
+								}
+								rets.push_back(iter->ty);
+							}
+							if(join_types(func->rets, rets))
+								changed = true;
+
+							block_end = true;
+							break;
+						}
+
+						case OpCode::EXTCALL:
+						{
+							AbsValue id = pop(state, addr);
+							const ExtFuncInfo* extfunc = nullptr;
+							if(id.ty == VMType::INT && id.val)
+								extfunc = get_vm_ext_func(static_cast<ExtFunc>(*id.val));
+
+							// service routines are not verified
+							if(!extfunc || extfunc->id == ExtFunc::SET_ISR)
+							{
+								throw std::runtime_error("Unknown external function at address "
+									+ std::to_string(addr) + ".");
+							}
+
+							switch(extfunc->id)
+							{
+								// keeps the argument's type, but gives the norm of an array
+								case ExtFunc::ABS:
+								case ExtFunc::FABS:
+								case ExtFunc::NORM:
+								{
+									VMType ty = pop(state, addr).ty;
+									push(state, ty == VMType::REALARR ? VMType::REAL : ty);
+									break;
+								}
+
+								// converts the value on the stack
+								case ExtFunc::TO_STRING:
+									push(state, get_cast_type(pop(state, addr).ty, VMType::STR));
+									break;
+
+								default:
+								{
+									if(extfunc->variadic)
+									{
+										AbsValue num = pop(state, addr);
+										if(num.ty != VMType::INT || !num.val || *num.val < 0)
+										{
+											throw std::runtime_error("Unknown number of arguments at address "
+												+ std::to_string(addr) + ".");
+										}
+										pop_n(state, *num.val, addr);
+									}
+
+									for(VMType argty : extfunc->argtys)
+									{
+										if(argty != VMType::UNKNOWN)
+											pop(state, addr);
+									}
+
+									if(extfunc->retty != VMType::UNKNOWN)
+										push(state, extfunc->retty);
+									break;
+								}
+							}
+							break;
+						}
+
+						case OpCode::ADDFRAMED:
+							// the global stack frame is only created once at the start
+							if(!is_main || addr != entry || entry_is_target)
+							{
+								throw std::runtime_error("Stack frame created at address "
+									+ std::to_string(addr) + ".");
+							}
+							break;
+
+						case OpCode::REMFRAMED:
+							// the global stack frame is removed directly before halting
+							if(!is_main || !state.stack.empty()
+								|| instr.framesize != global_framesize
+								|| get_instr(instr.next_ip).op != OpCode::HALT)
+							{
+								throw std::runtime_error("Stack frame removed at address "
+									+ std::to_string(addr) + ".");
+							}
+							break;
+
+						// instructions with computed addresses or frame sizes
+						default:
+						{
+							throw std::runtime_error("Instruction "
+								+ std::string(get_vm_opcode_name(instr.op))
+								+ " cannot be verified at address "
+								+ std::to_string(addr) + ".");
+						}
+					}
+
+					// the proven operand type has to hold on all paths
+					if(!instr.verified)
+					{
+						instr.verified = true;
+						instr.optype = optype;
+					}
+					else
+					{
+						instr.optype = join_types(instr.optype, optype);
+					}
+
+					if(block_end)
+						break;
+
+					if(leaders.contains(next))
+					{
+						flow(next, state);
+						break;
+					}
+
+					addr = next;
+				}
+			}
+		};
+
+		// interpret all code until the function summaries do not change anymore,
+		// the results of the last iteration are kept
+		while(changed)
+		{
+			changed = false;
+			clear_results();
+
+			verify_unit(entry, nullptr);
+			for(auto& [funcaddr, func] : funcs)
+				verify_unit(funcaddr, &func);
+		}
+
+		num_funcs = funcs.size();
+		num_verified = std::count_if(m_decoded.begin(), m_decoded.end(),
+			[](const DecodedInstr& instr) -> bool { return instr.verified; });
+
+		m_code_verified = true;
+		m_verify_error.clear();
+	}
+	catch(const std::exception& err)
+	{
+		clear_results();
+		m_code_verified = false;
+		m_verify_error = err.what();
+	}
+
+	if(m_debug)
+	{
+		if(*m_code_verified)
+		{
+			std::cout << "Verified " << num_verified << " instructions in "
+				<< num_funcs << " functions." << std::endl;
+		}
+		else
+		{
+			std::cout << "Code not verified: " << m_verify_error << std::endl;
+		}
+	}
+
+	return *m_code_verified;
+}
+
+
+/**
+ * is the instruction at the given address reached by the verified code?
+ */
+bool VM::IsVerifiedInstr(t_addr addr) const
+{
+	if(!m_code_verified || !*m_code_verified)
+		return false;
+	if(addr < m_code_range[0] || addr >= m_code_range[1])
+		return false;
+
+	const std::size_t idx = static_cast<std::size_t>(addr - m_code_range[0]);
+	return idx < m_decoded.size() && m_decoded[idx].verified;
+}
+
+
+/**
+ * can the verified interpreter loop run the code from the current instruction?
+ */
+bool VM::CanRunVerified()
+{
+	// interrupt service routines and native code are not verified
+	if(!m_verify || m_jit || std::any_of(m_isrs.begin(), m_isrs.end(),
+		[](const std::optional<t_addr>& isr) -> bool { return isr.has_value(); }))
+		return false;
+
+	return VerifyCode() && IsVerifiedInstr(m_ip);
+}
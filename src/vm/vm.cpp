@@ -14,9 +14,12 @@
 
 
 
-VM::VM(t_addr memsize) : m_memsize{memsize}
+VM::VM(t_addr memsize, bool guards, bool lazy) : m_memsize{memsize}
 {
-	m_mem.reset(new t_byte[m_memsize]);
+	m_mem.Allocate(m_memsize, guards, lazy);
+
+	// guarded memory is rounded up to whole pages
+	m_memsize = m_mem.GetSize();
 	Reset();
 }
 
@@ -24,6 +27,7 @@ VM::VM(t_addr memsize) : m_memsize{memsize}
 VM::~VM()
 {
 	StopTimer();
+	FlushOutput();
 }
 
 
@@ -45,25 +49,105 @@ void VM::StopTimer()
 }
 
 
+/**
+ * (re)starts the timer thread if timer interrupts or stack samples are requested,
+ * the settings must only be changed while the thread is stopped
+ */
+void VM::UpdateTimer()
+{
+	StopTimer();
+
+	if(m_timer_irq || m_sampling)
+		StartTimer();
+}
+
+
 /**
  * function for timer thread
  */
 void VM::TimerFunc()
 {
+	using t_clk = std::chrono::steady_clock;
+
+	const bool timer_irq = m_timer_irq;
+	const bool sampling = m_sampling && m_sample_ticks.count() > 0;
+	t_clk::time_point next_irq = t_clk::now() + m_timer_ticks;
+	t_clk::time_point next_sample = t_clk::now() + m_sample_ticks;
+
 	while(m_timer_running)
 	{
-		std::this_thread::sleep_for(m_timer_ticks);
-		RequestInterrupt(m_timer_interrupt);
+		if(timer_irq && sampling)
+			std::this_thread::sleep_until(std::min(next_irq, next_sample));
+		else if(sampling)
+			std::this_thread::sleep_until(next_sample);
+		else
+			std::this_thread::sleep_until(next_irq);
+
+		t_clk::time_point now = t_clk::now();
+
+		if(timer_irq && now >= next_irq)
+		{
+			RequestInterrupt(m_timer_interrupt);
+			next_irq = now + m_timer_ticks;
+		}
+
+		// the interpreter loop takes the sample at the next instruction
+		if(sampling && now >= next_sample)
+		{
+			RequestInterrupt(m_sample_interrupt);
+			next_sample = now + m_sample_ticks;
+		}
 	}
 }
 
 
+/**
+ * records the current instruction pointer and the return addresses
+ * of the active functions by following the saved base pointers,
+ * see the stack frame layout in run.cpp
+ */
+void VM::SampleStack()
+{
+	// maximum number of recorded frames
+	constexpr const std::size_t max_depth = 256;
+
+	std::vector<t_addr> stack;
+	stack.push_back(m_ip);
+
+	// a frame holds the saved base pointer and the return address
+	constexpr const t_addr saved_size = vm_type_size<VMType::ADDR_MEM, true>;
+
+	for(t_addr bp = m_bp; stack.size() < max_depth;)
+	{
+		if(bp < 0 || bp + 2*saved_size > m_memsize)
+			break;
+
+		if(static_cast<VMType>(m_mem[bp]) != VMType::ADDR_MEM ||
+			static_cast<VMType>(m_mem[bp + saved_size]) != VMType::ADDR_MEM)
+			break;
+
+		t_addr saved_bp = ReadMemRaw<t_addr>(bp + m_descrsize);
+		t_addr saved_ip = ReadMemRaw<t_addr>(bp + saved_size + m_descrsize);
+
+		// the return address points after the call instruction
+		stack.push_back(saved_ip - m_bytesize);
+
+		// the caller's frame has to be above the current one
+		if(saved_bp <= bp)
+			break;
+		bp = saved_bp;
+	}
+
+	m_profiler.AddSample(std::move(stack));
+}
+
+
 /**
  * signals an interrupt
  */
 void VM::RequestInterrupt(t_addr num)
 {
-	m_irqs[num] = true;
+	m_irqs.fetch_or(t_irqmask(1) << num, std::memory_order_release);
 }
 
 
@@ -84,13 +168,15 @@ void VM::SetISR(t_addr num, t_addr addr)
  * an address consists of the index of an register
  * holding the base address and an offset address
  */
+template<bool checks>
 VM::t_addr VM::PopAddress()
 {
 	// get register/type info from stack
-	t_byte regval = PopRaw<t_byte, m_bytesize>();
+	t_byte regval = PopRaw<t_byte, m_descrsize, checks>();
 
 	// get address from stack
-	t_addr addr = PopRaw<t_addr, m_addrsize>();
+	t_addr addr = PopRaw<t_addr, m_addrsize, checks>();
+	PopPadding<checks>(m_addrsize);
 	VMType thereg = static_cast<VMType>(regval);
 
 	if(m_debug)
@@ -119,19 +205,38 @@ VM::t_addr VM::PopAddress()
 /**
  * push an address to stack
  */
+template<bool checks>
 void VM::PushAddress(t_addr addr, VMType ty)
 {
-	PushRaw<t_addr, m_addrsize>(addr);
-	PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(ty));
+	PushPadding<checks>(m_addrsize);
+	PushRaw<t_addr, m_addrsize, checks>(addr);
+	PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(ty));
 }
 
 
 /**
  * pop a bool from the stack
  */
-bool VM::PopBool()
+template<bool checks>
+bool VM::PopBool(VMType proven)
 {
-	t_data dat = PopData();
+	// operand type proven by the verifier
+	if(proven == VMType::BOOL)
+	{
+		PopRaw<t_byte, m_descrsize, checks>();
+		const bool val = PopRaw<t_bool, GetDataTypeSize<t_bool>(), checks>() != 0;
+		PopPadding<checks>(GetDataTypeSize<t_bool>());
+		return val;
+	}
+	else if(proven == VMType::INT)
+	{
+		PopRaw<t_byte, m_descrsize, checks>();
+		const bool val = PopRaw<t_int, GetDataTypeSize<t_int>(), checks>() != 0;
+		PopPadding<checks>(GetDataTypeSize<t_int>());
+		return val;
+	}
+
+	t_data dat = PopData<checks>();
 	bool val = false;
 
 	if(dat.index() == m_boolidx)
@@ -148,10 +253,11 @@ bool VM::PopBool()
 /**
  * push a bool to the stack
  */
+template<bool checks>
 void VM::PushBool(bool val)
 {
 	t_bool dat = static_cast<t_bool>(val);
-	PushData(t_data{std::in_place_index<m_boolidx>, dat});
+	PushData<checks>(t_data{std::in_place_index<m_boolidx>, dat});
 }
 
 
@@ -160,10 +266,11 @@ void VM::PushBool(bool val)
  * a string consists of an t_addr giving the length
  * following by the string (without 0-termination)
  */
+template<bool checks>
 VM::t_str VM::PopString()
 {
-	t_addr len = PopRaw<t_addr, m_addrsize>();
-	CheckMemoryBounds(m_sp, len*m_charsize);
+	t_addr len = PopRaw<t_addr, m_addrsize, checks>();
+	CheckMemoryBounds<checks>(m_sp, len*m_charsize);
 
 	t_char* begin = reinterpret_cast<t_char*>(m_mem.get() + m_sp);
 	t_str str(begin, len);
@@ -179,12 +286,13 @@ VM::t_str VM::PopString()
 /**
  * get a string from the top of the stack
  */
+template<bool checks>
 VM::t_str VM::TopString(t_addr sp_offs) const
 {
-	t_addr len = TopRaw<t_addr, m_addrsize>(sp_offs);
+	t_addr len = TopRaw<t_addr, m_addrsize, checks>(sp_offs);
 	t_addr addr = m_sp + sp_offs + m_addrsize;
 
-	CheckMemoryBounds(addr, len*m_charsize);
+	CheckMemoryBounds<checks>(addr, len*m_charsize);
 	t_char* begin = reinterpret_cast<t_char*>(m_mem.get() + addr);
 	t_str str(begin, len);
 
@@ -195,21 +303,24 @@ VM::t_str VM::TopString(t_addr sp_offs) const
 /**
  * push a string to the stack
  */
+template<bool checks>
 void VM::PushString(const VM::t_str& str, bool raw)
 {
 	t_addr len = static_cast<t_addr>(str.length());
-	CheckMemoryBounds(m_sp, -len*m_charsize);
+	if(!raw)
+		PushPadding<checks>(m_addrsize + len*m_charsize);
+	CheckMemoryBounds<checks>(m_sp, -len*m_charsize);
 
 	m_sp -= len*m_charsize;
 	t_char* begin = reinterpret_cast<t_char*>(m_mem.get() + m_sp);
 	std::memcpy(begin, str.data(), len*m_charsize);
 
-	PushRaw<t_addr, m_addrsize>(len);
+	PushRaw<t_addr, m_addrsize, checks>(len);
 
 	if(!raw)
 	{
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(VMType::STR));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::STR));
 
 		if(m_debug)
 			std::cout << "pushed string \"" << str << "\"." << std::endl;
@@ -220,9 +331,10 @@ void VM::PushString(const VM::t_str& str, bool raw)
 /**
  * pop a complex number from the stack
  */
+template<bool checks>
 VM::t_cplx VM::PopComplex()
 {
-	CheckMemoryBounds(m_sp, GetDataTypeSize<t_cplx>());
+	CheckMemoryBounds<checks>(m_sp, GetDataTypeSize<t_cplx>());
 
 	t_real* begin = reinterpret_cast<t_real*>(m_mem.get() + m_sp);
 	t_cplx cplx{*begin, *(begin + 1)};
@@ -239,9 +351,10 @@ VM::t_cplx VM::PopComplex()
 /**
  * pop a quaternion from the stack
  */
+template<bool checks>
 VM::t_quat VM::PopQuaternion()
 {
-	CheckMemoryBounds(m_sp, GetDataTypeSize<t_quat>());
+	CheckMemoryBounds<checks>(m_sp, GetDataTypeSize<t_quat>());
 
 	t_real* begin = reinterpret_cast<t_real*>(m_mem.get() + m_sp);
 	t_quat quat{*begin, *(begin + 1), *(begin + 2), *(begin + 3)};
@@ -258,11 +371,12 @@ VM::t_quat VM::PopQuaternion()
 /**
  * get a complex number from the top of the stack
  */
+template<bool checks>
 VM::t_cplx VM::TopComplex(t_addr sp_offs) const
 {
 	t_addr addr = m_sp + sp_offs;
 
-	CheckMemoryBounds(addr, GetDataTypeSize<t_cplx>());
+	CheckMemoryBounds<checks>(addr, GetDataTypeSize<t_cplx>());
 	const t_real* begin = reinterpret_cast<t_real*>(m_mem.get() + addr);
 
 	return t_cplx{*begin, *(begin + 1)};
@@ -272,11 +386,12 @@ VM::t_cplx VM::TopComplex(t_addr sp_offs) const
 /**
  * get a quaternion from the top of the stack
  */
+template<bool checks>
 VM::t_quat VM::TopQuaternion(t_addr sp_offs) const
 {
 	t_addr addr = m_sp + sp_offs;
 
-	CheckMemoryBounds(addr, GetDataTypeSize<t_quat>());
+	CheckMemoryBounds<checks>(addr, GetDataTypeSize<t_quat>());
 	const t_real* begin = reinterpret_cast<t_real*>(m_mem.get() + addr);
 
 	return t_quat{*begin, *(begin + 1), *(begin + 2), *(begin + 3)};
@@ -286,9 +401,12 @@ VM::t_quat VM::TopQuaternion(t_addr sp_offs) const
 /**
  * push a complex number to the stack
  */
+template<bool checks>
 void VM::PushComplex(const VM::t_cplx& cplx, bool raw)
 {
-	CheckMemoryBounds(m_sp, -GetDataTypeSize<t_cplx>());
+	if(!raw)
+		PushPadding<checks>(GetDataTypeSize<t_cplx>());
+	CheckMemoryBounds<checks>(m_sp, -GetDataTypeSize<t_cplx>());
 
 	m_sp -= GetDataTypeSize<t_cplx>();
 	t_real* begin = reinterpret_cast<t_real*>(m_mem.get() + m_sp);
@@ -299,7 +417,7 @@ void VM::PushComplex(const VM::t_cplx& cplx, bool raw)
 	if(!raw)
 	{
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(VMType::CPLX));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::CPLX));
 
 		if(m_debug)
 			std::cout << "pushed complex " << cplx << "." << std::endl;
@@ -310,9 +428,12 @@ void VM::PushComplex(const VM::t_cplx& cplx, bool raw)
 /**
  * push a quaternion to the stack
  */
+template<bool checks>
 void VM::PushQuaternion(const VM::t_quat& quat, bool raw)
 {
-	CheckMemoryBounds(m_sp, -GetDataTypeSize<t_quat>());
+	if(!raw)
+		PushPadding<checks>(GetDataTypeSize<t_quat>());
+	CheckMemoryBounds<checks>(m_sp, -GetDataTypeSize<t_quat>());
 
 	m_sp -= GetDataTypeSize<t_quat>();
 	t_real* begin = reinterpret_cast<t_real*>(m_mem.get() + m_sp);
@@ -325,7 +446,7 @@ void VM::PushQuaternion(const VM::t_quat& quat, bool raw)
 	if(!raw)
 	{
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(VMType::QUAT));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::QUAT));
 
 		if(m_debug)
 		{
@@ -340,10 +461,11 @@ void VM::PushQuaternion(const VM::t_quat& quat, bool raw)
  * get top data from the stack, which is prefixed
  * with a type descriptor byte
  */
+template<bool checks>
 VM::t_data VM::TopData() const
 {
 	// get data type info from stack
-	t_byte tyval = TopRaw<t_byte, m_bytesize>();
+	t_byte tyval = TopRaw<t_byte, m_descrsize, checks>();
 	VMType ty = static_cast<VMType>(tyval);
 
 	t_data dat;
@@ -353,35 +475,35 @@ VM::t_data VM::TopData() const
 		case VMType::REAL:
 		{
 			dat = t_data{std::in_place_index<m_realidx>,
-				TopRaw<t_real, GetDataTypeSize<t_real>()>(m_bytesize)};
+				TopRaw<t_real, GetDataTypeSize<t_real>(), checks>(m_descrsize)};
 			break;
 		}
 
 		case VMType::INT:
 		{
 			dat = t_data{std::in_place_index<m_intidx>,
-				TopRaw<t_int, GetDataTypeSize<t_real>()>(m_bytesize)};
+				TopRaw<t_int, GetDataTypeSize<t_real>(), checks>(m_descrsize)};
 			break;
 		}
 
 		case VMType::CPLX:
 		{
 			dat = t_data{std::in_place_index<m_cplxidx>,
-				TopComplex(m_bytesize)};
+				TopComplex<checks>(m_descrsize)};
 			break;
 		}
 
 		case VMType::QUAT:
 		{
 			dat = t_data{std::in_place_index<m_quatidx>,
-				TopQuaternion(m_bytesize)};
+				TopQuaternion<checks>(m_descrsize)};
 			break;
 		}
 
 		case VMType::BOOL:
 		{
 			dat = t_data{std::in_place_index<m_boolidx>,
-				TopRaw<t_bool, GetDataTypeSize<t_bool>()>(m_bytesize)};
+				TopRaw<t_bool, GetDataTypeSize<t_bool>(), checks>(m_descrsize)};
 			break;
 		}
 
@@ -392,42 +514,42 @@ VM::t_data VM::TopData() const
 		case VMType::ADDR_GBP:
 		{
 			dat = t_data{std::in_place_index<m_addridx>,
-				TopRaw<t_addr, m_addrsize>(m_bytesize)};
+				TopRaw<t_addr, m_addrsize, checks>(m_descrsize)};
 			break;
 		}
 
 		case VMType::STR:
 		{
 			dat = t_data{std::in_place_index<m_stridx>,
-				TopString(m_bytesize)};
+				TopString<checks>(m_descrsize)};
 			break;
 		}
 
 		case VMType::REALARR:
 		{
 			dat = t_data{std::in_place_index<m_realarridx>,
-				TopArray<t_vec_real>(m_bytesize)};
+				TopArray<t_vec_real, checks>(m_descrsize)};
 				break;
 		}
 
 		case VMType::INTARR:
 		{
 			dat = t_data{std::in_place_index<m_intarridx>,
-				TopArray<t_vec_int>(m_bytesize)};
+				TopArray<t_vec_int, checks>(m_descrsize)};
 				break;
 		}
 
 		case VMType::CPLXARR:
 		{
 			dat = t_data{std::in_place_index<m_cplxarridx>,
-				TopArray<t_vec_cplx>(m_bytesize)};
+				TopArray<t_vec_cplx, checks>(m_descrsize)};
 				break;
 		}
 
 		case VMType::QUATARR:
 		{
 			dat = t_data{std::in_place_index<m_quatarridx>,
-				TopArray<t_vec_quat>(m_bytesize)};
+				TopArray<t_vec_quat, checks>(m_descrsize)};
 				break;
 		}
 
@@ -450,10 +572,11 @@ VM::t_data VM::TopData() const
  * pop data from the stack, which is prefixed
  * with a type descriptor byte
  */
+template<bool checks>
 VM::t_data VM::PopData()
 {
 	// get data type info from stack
-	t_byte tyval = PopRaw<t_byte, m_bytesize>();
+	t_byte tyval = PopRaw<t_byte, m_descrsize, checks>();
 	VMType ty = static_cast<VMType>(tyval);
 
 	t_data dat;
@@ -463,7 +586,8 @@ VM::t_data VM::PopData()
 		case VMType::REAL:
 		{
 			dat = t_data{std::in_place_index<m_realidx>,
-				PopRaw<t_real, GetDataTypeSize<t_real>()>()};
+				PopRaw<t_real, GetDataTypeSize<t_real>(), checks>()};
+			PopPadding<checks>(GetDataTypeSize<t_real>());
 			if(m_debug)
 			{
 				std::cout << "popped real " << std::get<m_realidx>(dat)
@@ -475,7 +599,8 @@ VM::t_data VM::PopData()
 		case VMType::INT:
 		{
 			dat = t_data{std::in_place_index<m_intidx>,
-				PopRaw<t_int, GetDataTypeSize<t_int>()>()};
+				PopRaw<t_int, GetDataTypeSize<t_int>(), checks>()};
+			PopPadding<checks>(GetDataTypeSize<t_int>());
 			if(m_debug)
 			{
 				std::cout << "popped integer " << std::get<m_intidx>(dat)
@@ -486,7 +611,8 @@ VM::t_data VM::PopData()
 
 		case VMType::CPLX:
 		{
-			dat = t_data{std::in_place_index<m_cplxidx>, PopComplex()};
+			dat = t_data{std::in_place_index<m_cplxidx>, PopComplex<checks>()};
+			PopPadding<checks>(GetDataTypeSize<t_cplx>());
 			if(m_debug)
 			{
 				std::cout << "popped complex " << std::get<m_cplxidx>(dat)
@@ -497,7 +623,8 @@ VM::t_data VM::PopData()
 
 		case VMType::QUAT:
 		{
-			dat = t_data{std::in_place_index<m_quatidx>, PopQuaternion()};
+			dat = t_data{std::in_place_index<m_quatidx>, PopQuaternion<checks>()};
+			PopPadding<checks>(GetDataTypeSize<t_quat>());
 			if(m_debug)
 			{
 				using namespace m_ops;
@@ -510,7 +637,8 @@ VM::t_data VM::PopData()
 		case VMType::BOOL:
 		{
 			dat = t_data{std::in_place_index<m_boolidx>,
-				PopRaw<t_bool, GetDataTypeSize<t_bool>()>()};
+				PopRaw<t_bool, GetDataTypeSize<t_bool>(), checks>()};
+			PopPadding<checks>(GetDataTypeSize<t_bool>());
 			if(m_debug)
 			{
 				std::cout << "popped bool " << std::boolalpha
@@ -527,7 +655,8 @@ VM::t_data VM::PopData()
 		case VMType::ADDR_GBP:
 		{
 			dat = t_data{std::in_place_index<m_addridx>,
-				PopRaw<t_addr, m_addrsize>()};
+				PopRaw<t_addr, m_addrsize, checks>()};
+			PopPadding<checks>(m_addrsize);
 			if(m_debug)
 			{
 				std::cout << "popped address " << std::get<m_addridx>(dat)
@@ -538,7 +667,8 @@ VM::t_data VM::PopData()
 
 		case VMType::STR:
 		{
-			dat = t_data{std::in_place_index<m_stridx>, PopString()};
+			dat = t_data{std::in_place_index<m_stridx>, PopString<checks>()};
+			PopPadding<checks>(GetDataSize(dat));
 			if(m_debug)
 			{
 				std::cout << "popped string \"" << std::get<m_stridx>(dat)
@@ -549,7 +679,8 @@ VM::t_data VM::PopData()
 
 		case VMType::REALARR:
 		{
-			dat = t_data{std::in_place_index<m_realarridx>, PopArray<t_vec_real>()};
+			dat = t_data{std::in_place_index<m_realarridx>, PopArray<t_vec_real, checks>()};
+			PopPadding<checks>(GetDataSize(dat));
 			if(m_debug)
 			{
 				using namespace m_ops;
@@ -562,7 +693,8 @@ VM::t_data VM::PopData()
 
 		case VMType::INTARR:
 		{
-			dat = t_data{std::in_place_index<m_intarridx>, PopArray<t_vec_int>()};
+			dat = t_data{std::in_place_index<m_intarridx>, PopArray<t_vec_int, checks>()};
+			PopPadding<checks>(GetDataSize(dat));
 			if(m_debug)
 			{
 				using namespace m_ops;
@@ -575,7 +707,8 @@ VM::t_data VM::PopData()
 
 		case VMType::CPLXARR:
 		{
-			dat = t_data{std::in_place_index<m_cplxarridx>, PopArray<t_vec_cplx>()};
+			dat = t_data{std::in_place_index<m_cplxarridx>, PopArray<t_vec_cplx, checks>()};
+			PopPadding<checks>(GetDataSize(dat));
 			if(m_debug)
 			{
 				using namespace m_ops;
@@ -588,7 +721,8 @@ VM::t_data VM::PopData()
 
 		case VMType::QUATARR:
 		{
-			dat = t_data{std::in_place_index<m_quatarridx>, PopArray<t_vec_quat>()};
+			dat = t_data{std::in_place_index<m_quatarridx>, PopArray<t_vec_quat, checks>()};
+			PopPadding<checks>(GetDataSize(dat));
 			if(m_debug)
 			{
 				using namespace m_ops;
@@ -617,16 +751,18 @@ VM::t_data VM::PopData()
 /**
  * push the raw data followed by a data type descriptor
  */
+template<bool checks>
 void VM::PushData(const VM::t_data& data, VMType ty, bool err_on_unknown)
 {
 	// real data
 	if(data.index() == m_realidx)
 	{
 		// push the actual data
-		PushRaw<t_real, GetDataTypeSize<t_real>()>(std::get<m_realidx>(data));
+		PushPadding<checks>(GetDataTypeSize<t_real>());
+		PushRaw<t_real, GetDataTypeSize<t_real>(), checks>(std::get<m_realidx>(data));
 
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(VMType::REAL));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::REAL));
 
 		if(m_debug)
 		{
@@ -640,10 +776,11 @@ void VM::PushData(const VM::t_data& data, VMType ty, bool err_on_unknown)
 	else if(data.index() == m_intidx)
 	{
 		// push the actual data
-		PushRaw<t_int, GetDataTypeSize<t_int>()>(std::get<m_intidx>(data));
+		PushPadding<checks>(GetDataTypeSize<t_int>());
+		PushRaw<t_int, GetDataTypeSize<t_int>(), checks>(std::get<m_intidx>(data));
 
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(VMType::INT));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::INT));
 
 		if(m_debug)
 		{
@@ -657,24 +794,25 @@ void VM::PushData(const VM::t_data& data, VMType ty, bool err_on_unknown)
 	else if(data.index() == m_cplxidx)
 	{
 		// push the actual complex number
-		PushComplex(std::get<m_cplxidx>(data), false);
+		PushComplex<checks>(std::get<m_cplxidx>(data), false);
 	}
 
 	// quaternion data
 	else if(data.index() == m_quatidx)
 	{
 		// push the actual quaternion
-		PushQuaternion(std::get<m_quatidx>(data), false);
+		PushQuaternion<checks>(std::get<m_quatidx>(data), false);
 	}
 
 	// bool data
 	else if(data.index() == m_boolidx)
 	{
 		// push the actual data
-		PushRaw<t_bool, GetDataTypeSize<t_bool>()>(std::get<m_boolidx>(data));
+		PushPadding<checks>(GetDataTypeSize<t_bool>());
+		PushRaw<t_bool, GetDataTypeSize<t_bool>(), checks>(std::get<m_boolidx>(data));
 
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(VMType::BOOL));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(VMType::BOOL));
 
 		if(m_debug)
 		{
@@ -688,10 +826,11 @@ void VM::PushData(const VM::t_data& data, VMType ty, bool err_on_unknown)
 	else if(data.index() == m_addridx)
 	{
 		// push the actual address
-		PushRaw<t_addr, m_addrsize>(std::get<m_addridx>(data));
+		PushPadding<checks>(m_addrsize);
+		PushRaw<t_addr, m_addrsize, checks>(std::get<m_addridx>(data));
 
 		// push descriptor
-		PushRaw<t_byte, m_bytesize>(static_cast<t_byte>(ty));
+		PushRaw<t_byte, m_descrsize, checks>(static_cast<t_byte>(ty));
 
 		if(m_debug)
 		{
@@ -705,35 +844,35 @@ void VM::PushData(const VM::t_data& data, VMType ty, bool err_on_unknown)
 	else if(data.index() == m_stridx)
 	{
 		// push the actual string
-		PushString(std::get<m_stridx>(data), false);
+		PushString<checks>(std::get<m_stridx>(data), false);
 	}
 
 	// real array data
 	else if(data.index() == m_realarridx)
 	{
 		// push the actual array
-		PushArray<t_vec_real>(std::get<m_realarridx>(data), false);
+		PushArray<t_vec_real, checks>(std::get<m_realarridx>(data), false);
 	}
 
 	// int array data
 	else if(data.index() == m_intarridx)
 	{
 		// push the actual array
-		PushArray<t_vec_int>(std::get<m_intarridx>(data), false);
+		PushArray<t_vec_int, checks>(std::get<m_intarridx>(data), false);
 	}
 
 	// complex array data
 	else if(data.index() == m_cplxarridx)
 	{
 		// push the actual array
-		PushArray<t_vec_cplx>(std::get<m_cplxarridx>(data), false);
+		PushArray<t_vec_cplx, checks>(std::get<m_cplxarridx>(data), false);
 	}
 
 	// quaternion array data
 	else if(data.index() == m_quatarridx)
 	{
 		// push the actual array
-		PushArray<t_vec_quat>(std::get<m_quatarridx>(data), false);
+		PushArray<t_vec_quat, checks>(std::get<m_quatarridx>(data), false);
 	}
 
 	// unknown data
@@ -751,10 +890,11 @@ void VM::PushData(const VM::t_data& data, VMType ty, bool err_on_unknown)
 /**
  * read the data type prefix from data in memory
  */
+template<bool checks>
 VMType VM::ReadMemType(VM::t_addr addr)
 {
 	// get data type info from memory
-	t_byte tyval = ReadMemRaw<t_byte>(addr);
+	t_byte tyval = ReadMemRaw<t_byte, checks>(addr);
 	return static_cast<VMType>(tyval);
 }
 
@@ -762,11 +902,12 @@ VMType VM::ReadMemType(VM::t_addr addr)
 /**
  * read type-prefixed data from memory
  */
+template<bool checks>
 std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 {
 	// get data type info from memory
-	VMType ty = ReadMemType(addr);
-	addr += m_bytesize;
+	VMType ty = ReadMemType<checks>(addr);
+	addr += m_descrsize;
 
 	t_data dat;
 
@@ -774,7 +915,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 	{
 		case VMType::REAL:     // int type
 		{
-			t_real val = ReadMemRaw<t_real>(addr);
+			t_real val = ReadMemRaw<t_real, checks>(addr);
 			dat = t_data{std::in_place_index<m_realidx>, val};
 
 			if(m_debug)
@@ -788,7 +929,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::INT:      // int type
 		{
-			t_int val = ReadMemRaw<t_int>(addr);
+			t_int val = ReadMemRaw<t_int, checks>(addr);
 			dat = t_data{std::in_place_index<m_intidx>, val};
 
 			if(m_debug)
@@ -802,7 +943,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::CPLX:     // complex type
 		{
-			t_cplx val = ReadMemRaw<t_cplx>(addr);
+			t_cplx val = ReadMemRaw<t_cplx, checks>(addr);
 			dat = t_data{std::in_place_index<m_cplxidx>, val};
 
 			if(m_debug)
@@ -816,7 +957,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::QUAT:     // quaternion type
 		{
-			t_quat val = ReadMemRaw<t_quat>(addr);
+			t_quat val = ReadMemRaw<t_quat, checks>(addr);
 			dat = t_data{std::in_place_index<m_quatidx>, val};
 
 			if(m_debug)
@@ -831,7 +972,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::BOOL:     // bool type
 		{
-			t_bool val = ReadMemRaw<t_bool>(addr);
+			t_bool val = ReadMemRaw<t_bool, checks>(addr);
 			dat = t_data{std::in_place_index<m_boolidx>, val};
 
 			if(m_debug)
@@ -849,7 +990,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 		case VMType::ADDR_BP:
 		case VMType::ADDR_GBP:
 		{
-			t_addr val = ReadMemRaw<t_addr>(addr);
+			t_addr val = ReadMemRaw<t_addr, checks>(addr);
 			dat = t_data{std::in_place_index<m_addridx>, val};
 
 			if(m_debug)
@@ -863,7 +1004,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::STR:      // string type
 		{
-			t_str str = ReadMemRaw<t_str>(addr);
+			t_str str = ReadMemRaw<t_str, checks>(addr);
 			dat = t_data{std::in_place_index<m_stridx>, str};
 
 			if(m_debug)
@@ -877,7 +1018,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::REALARR:  // real array type
 		{
-			t_vec_real vec = ReadMemRaw<t_vec_real>(addr);
+			t_vec_real vec = ReadMemRaw<t_vec_real, checks>(addr);
 			dat = t_data{std::in_place_index<m_realarridx>, vec};
 
 			if(m_debug)
@@ -892,7 +1033,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::INTARR:  // int array type
 		{
-			t_vec_int vec = ReadMemRaw<t_vec_int>(addr);
+			t_vec_int vec = ReadMemRaw<t_vec_int, checks>(addr);
 			dat = t_data{std::in_place_index<m_intarridx>, vec};
 
 			if(m_debug)
@@ -907,7 +1048,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::CPLXARR:  // complex array type
 		{
-			t_vec_cplx vec = ReadMemRaw<t_vec_cplx>(addr);
+			t_vec_cplx vec = ReadMemRaw<t_vec_cplx, checks>(addr);
 			dat = t_data{std::in_place_index<m_cplxarridx>, vec};
 
 			if(m_debug)
@@ -922,7 +1063,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 
 		case VMType::QUATARR:  // quaternion array type
 		{
-			t_vec_quat vec = ReadMemRaw<t_vec_quat>(addr);
+			t_vec_quat vec = ReadMemRaw<t_vec_quat, checks>(addr);
 			dat = t_data{std::in_place_index<m_quatarridx>, vec};
 
 			if(m_debug)
@@ -954,6 +1095,7 @@ std::tuple<VMType, VM::t_data> VM::ReadMemData(VM::t_addr addr)
 /**
  * write type-prefixed data to memory
  */
+template<bool checks>
 void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 {
 	// real type
@@ -968,11 +1110,11 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(VMType::REAL));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(VMType::REAL));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_real>(addr, std::get<m_realidx>(data));
+		WriteMemRaw<t_real, checks>(addr, std::get<m_realidx>(data));
 	}
 
 	// integer type
@@ -987,11 +1129,11 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(VMType::INT));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(VMType::INT));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_int>(addr, std::get<m_intidx>(data));
+		WriteMemRaw<t_int, checks>(addr, std::get<m_intidx>(data));
 	}
 
 	// complex type
@@ -1006,11 +1148,11 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(VMType::CPLX));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(VMType::CPLX));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_cplx>(addr, std::get<m_cplxidx>(data));
+		WriteMemRaw<t_cplx, checks>(addr, std::get<m_cplxidx>(data));
 	}
 
 	// quaternion type
@@ -1026,11 +1168,11 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(VMType::QUAT));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(VMType::QUAT));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_quat>(addr, std::get<m_quatidx>(data));
+		WriteMemRaw<t_quat, checks>(addr, std::get<m_quatidx>(data));
 	}
 
 	// bool type
@@ -1045,11 +1187,11 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(VMType::BOOL));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(VMType::BOOL));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_bool>(addr, std::get<m_boolidx>(data));
+		WriteMemRaw<t_bool, checks>(addr, std::get<m_boolidx>(data));
 	}
 
 	// address type
@@ -1064,11 +1206,11 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(ty));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(ty));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_int>(addr, std::get<m_addridx>(data));
+		WriteMemRaw<t_int, checks>(addr, std::get<m_addridx>(data));
 	}*/
 
 	// string type
@@ -1083,35 +1225,35 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 		}
 
 		// write descriptor prefix
-		WriteMemRaw<t_byte>(addr, static_cast<t_byte>(VMType::STR));
-		addr += m_bytesize;
+		WriteMemRaw<t_byte, checks>(addr, static_cast<t_byte>(VMType::STR));
+		addr += m_descrsize;
 
 		// write the actual data
-		WriteMemRaw<t_str>(addr, std::get<m_stridx>(data));
+		WriteMemRaw<t_str, checks>(addr, std::get<m_stridx>(data));
 	}
 
 	// real array type
 	else if(data.index() == m_realarridx)
 	{
-		WriteArray<t_vec_real>(addr, std::get<m_realarridx>(data), false);
+		WriteArray<t_vec_real, checks>(addr, std::get<m_realarridx>(data), false);
 	}
 
 	// int array type
 	else if(data.index() == m_intarridx)
 	{
-		WriteArray<t_vec_int>(addr, std::get<m_intarridx>(data), false);
+		WriteArray<t_vec_int, checks>(addr, std::get<m_intarridx>(data), false);
 	}
 
 	// complex array type
 	else if(data.index() == m_cplxarridx)
 	{
-		WriteArray<t_vec_cplx>(addr, std::get<m_cplxarridx>(data), false);
+		WriteArray<t_vec_cplx, checks>(addr, std::get<m_cplxarridx>(data), false);
 	}
 
 	// quaternion array type
 	else if(data.index() == m_quatarridx)
 	{
-		WriteArray<t_vec_quat>(addr, std::get<m_quatarridx>(data), false);
+		WriteArray<t_vec_quat, checks>(addr, std::get<m_quatarridx>(data), false);
 	}
 
 	// unknown type
@@ -1122,6 +1264,103 @@ void VM::WriteMemData(VM::t_addr addr, const VM::t_data& data)
 }
 
 
+/**
+ * size of a scalar value including its type descriptor, 0 for other types
+ */
+static inline VM::t_addr get_scalar_size(VMType ty)
+{
+	switch(ty)
+	{
+		case VMType::REAL: return vm_type_size<VMType::REAL, true>;
+		case VMType::INT: return vm_type_size<VMType::INT, true>;
+		case VMType::CPLX: return vm_type_size<VMType::CPLX, true>;
+		case VMType::QUAT: return vm_type_size<VMType::QUAT, true>;
+		case VMType::BOOL: return vm_type_size<VMType::BOOL, true>;
+		default: return 0;
+	}
+}
+
+
+/**
+ * push data from memory onto the stack,
+ * scalars have the same layout in memory and on the stack and are copied directly
+ */
+template<bool checks>
+void VM::PushMemData(VM::t_addr addr)
+{
+	t_addr size = get_scalar_size(ReadMemType<checks>(addr));
+
+	if(size && !m_debug)
+	{
+		CheckMemoryBounds<checks>(addr, size);
+		CheckMemoryBounds<checks>(m_sp, -size);
+
+		m_sp -= size;
+		std::memmove(m_mem.get() + m_sp, m_mem.get() + addr, size*m_bytesize);
+	}
+	else
+	{
+		auto [ty, val] = ReadMemData<checks>(addr);
+		PushData<checks>(val, ty);
+	}
+}
+
+
+/**
+ * pop data from the stack and write it to memory,
+ * scalars have the same layout in memory and on the stack and are copied directly
+ */
+template<bool checks>
+void VM::PopMemData(VM::t_addr addr)
+{
+	t_addr size = get_scalar_size(static_cast<VMType>(TopRaw<t_byte, m_descrsize, checks>()));
+
+	if(size && !m_debug)
+	{
+		CheckMemoryBounds<checks>(m_sp, size);
+		CheckMemoryBounds<checks>(addr, size);
+
+		std::memmove(m_mem.get() + addr, m_mem.get() + m_sp, size*m_bytesize);
+		if(m_zeropoppedvals)
+			std::memset(m_mem.get() + m_sp, 0, size*m_bytesize);
+
+		m_sp += size;
+	}
+	else
+	{
+		WriteMemData<checks>(addr, PopData<checks>());
+	}
+}
+
+
+// memory/stack operations with and without bounds checks
+#define VM_INSTANTIATE_MEM_OPS(checks) \
+	template VM::t_addr VM::PopAddress<checks>(); \
+	template void VM::PushAddress<checks>(t_addr, VMType); \
+	template bool VM::PopBool<checks>(VMType); \
+	template void VM::PushBool<checks>(bool); \
+	template VM::t_str VM::PopString<checks>(); \
+	template VM::t_str VM::TopString<checks>(t_addr) const; \
+	template void VM::PushString<checks>(const t_str&, bool); \
+	template VM::t_cplx VM::PopComplex<checks>(); \
+	template VM::t_quat VM::PopQuaternion<checks>(); \
+	template VM::t_cplx VM::TopComplex<checks>(t_addr) const; \
+	template VM::t_quat VM::TopQuaternion<checks>(t_addr) const; \
+	template void VM::PushComplex<checks>(const t_cplx&, bool); \
+	template void VM::PushQuaternion<checks>(const t_quat&, bool); \
+	template VM::t_data VM::TopData<checks>() const; \
+	template VM::t_data VM::PopData<checks>(); \
+	template void VM::PushData<checks>(const t_data&, VMType, bool); \
+	template VMType VM::ReadMemType<checks>(t_addr); \
+	template std::tuple<VMType, VM::t_data> VM::ReadMemData<checks>(t_addr); \
+	template void VM::WriteMemData<checks>(t_addr, const t_data&); \
+	template void VM::PushMemData<checks>(t_addr); \
+	template void VM::PopMemData<checks>(t_addr);
+
+VM_INSTANTIATE_MEM_OPS(true)
+VM_INSTANTIATE_MEM_OPS(false)
+
+
 /**
  * helper function to get (possibly dynamic) data type sizes
  */
@@ -1140,7 +1379,15 @@ VM::t_addr VM::GetDataSize(const t_data& data) const
 	else if(data.index() == m_addridx)
 		return m_addrsize;
 	else if(data.index() == m_stridx)
-		return m_addrsize + std::get<m_stridx>(data).length();
+		return m_addrsize + std::get<m_stridx>(data).length()*m_charsize;
+	else if(data.index() == m_realarridx)
+		return m_addrsize + std::get<m_realarridx>(data).size()*GetDataTypeSize<t_real>();
+	else if(data.index() == m_intarridx)
+		return m_addrsize + std::get<m_intarridx>(data).size()*GetDataTypeSize<t_int>();
+	else if(data.index() == m_cplxarridx)
+		return m_addrsize + std::get<m_cplxarridx>(data).size()*GetDataTypeSize<t_cplx>();
+	else if(data.index() == m_quatarridx)
+		return m_addrsize + std::get<m_quatarridx>(data).size()*GetDataTypeSize<t_quat>();
 
 	throw std::runtime_error("GetDataSize: Data type not yet implemented.");
 	return 0;
@@ -1156,8 +1403,31 @@ void VM::Reset()
 	// padding of max. data type size to avoid writing beyond memory size
 	m_sp -= sizeof(t_data) + 1;
 
-	std::memset(m_mem.get(), static_cast<t_byte>(OpCode::HALT), m_memsize*m_bytesize);
+	// start the stack and the frames at slot boundaries
+	m_sp -= m_sp % g_vm_slot_size;
+	m_bp -= m_bp % g_vm_slot_size;
+	m_gbp -= m_gbp % g_vm_slot_size;
+
+	m_mem.Clear(static_cast<t_byte>(OpCode::HALT));
 	m_code_range[0] = m_code_range[1] = -1;
+	m_decoded.clear();
+	m_code_decoded = false;
+	m_code_verified.reset();
+	ClearNativeCode();
+}
+
+
+/**
+ * get the deepest extent of the stack since the last reset, i.e. the distance
+ * from the end of the memory to the lowest address above the code that has
+ * been written to, values zeroed after popping them are not seen
+ */
+VM::t_addr VM::GetPeakStackSize() const
+{
+	if(auto lowest = m_mem.GetLowestUsed(GetCodeSize(), m_memsize,
+		static_cast<t_byte>(OpCode::HALT)))
+		return m_memsize - *lowest;
+	return 0;
 }
 
 
@@ -1166,6 +1436,10 @@ void VM::Reset()
  */
 void VM::UpdateCodeRange(t_addr begin, t_addr end)
 {
+	m_code_decoded = false;
+	m_code_verified.reset();
+	ClearNativeCode();
+
 	if(m_code_range[0] < 0 || m_code_range[1] < 0)
 	{
 		// set range
@@ -1209,26 +1483,39 @@ void VM::SetMem(t_addr addr, const VM::t_byte* data, std::size_t size, bool is_c
 }
 
 
-void VM::CheckMemoryBounds(t_addr addr, t_addr size) const
+/**
+ * maps the code section of a program file to address 0 without copying it
+ * @returns false if the memory or the file offset does not allow it,
+ * the code then has to be loaded using SetMem
+ */
+bool VM::MapCode(int fd, std::size_t offset, std::size_t size)
 {
-	if(!m_checks)
-		return;
+	if(size > std::size_t(m_memsize) || !m_mem.MapFile(fd, offset, size))
+		return false;
+
+	UpdateCodeRange(0, static_cast<t_addr>(size));
+	return true;
+}
 
+
+/**
+ * report a failed memory bounds check, see CheckMemoryBounds()
+ */
+void VM::ThrowMemoryBounds(t_addr addr, t_addr size) const
+{
 	t_addr new_addr = addr + size;
-	if(new_addr > m_memsize || new_addr < 0 || addr < 0)
-	{
-		std::ostringstream msg;
-		msg << "Attempted memory access out of bounds: "
-			<< addr << " + " << size << " = " << new_addr
-			<< " > " << m_memsize << ".";
-		throw std::runtime_error(msg.str());
-	}
+
+	std::ostringstream msg;
+	msg << "Attempted memory access out of bounds: "
+		<< addr << " + " << size << " = " << new_addr
+		<< " > " << m_memsize << ".";
+	throw std::runtime_error(msg.str());
 }
 
 
 void VM::CheckPointerBounds() const
 {
-	if(!m_checks)
+	if(!m_checks || m_mem.IsGuarded())
 		return;
 
 	// check code range?
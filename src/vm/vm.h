@@ -13,6 +13,7 @@
 #include <memory>
 #include <array>
 #include <vector>
+#include <unordered_map>
 #include <optional>
 #include <variant>
 #include <iostream>
@@ -22,11 +23,17 @@
 #include <chrono>
 #include <atomic>
 #include <limits>
+#include <cstdint>
 #include <string>
 #include <cstring>
 #include <cmath>
 
 #include "opcodes.h"
+#include "extfuncs.h"
+#include "jit.h"
+#include "vmmem.h"
+#include "profile.h"
+#include "debuginfo.h"
 #include "common/helpers.h"
 
 
@@ -76,12 +83,35 @@ public:
 
 	// data type sizes
 	static constexpr const t_addr m_bytesize = sizeof(t_byte);
+	static constexpr const t_addr m_descrsize = g_vm_descr_size;
 	static constexpr const t_addr m_addrsize = sizeof(t_addr);
 	static constexpr const t_addr m_charsize = sizeof(t_char);
 
 	// interrupts
 	static constexpr const t_addr m_num_interrupts = 16;
+
+
+	/**
+	 * instruction with operands that have been resolved at load time
+	 */
+	struct DecodedInstr
+	{
+		OpCode op{OpCode::INVALID};  // (fused) opcode, invalid if not decoded
+		t_addr next_ip{0};           // address of the following instruction
+		t_addr data_addr{0};         // address of direct data (with descriptor)
+		t_addr data_size{0};         // size of direct data (with descriptor)
+		t_addr target{0};            // absolute jump or function address
+		t_addr var_addr{0};          // variable address relative to its base pointer
+		t_int framesize{0};          // size of the stack frame
+		t_int num_args{0};           // number of function arguments
+
+		// results of the verifier, see VerifyCode()
+		bool verified{false};             // reached by the verified code
+		VMType optype{VMType::UNKNOWN};   // proven type of the operands
+	};
 	static constexpr const t_addr m_timer_interrupt = 0;
+	// request to sample the call stack, not handled by a service routine
+	static constexpr const t_addr m_sample_interrupt = m_num_interrupts;
 
 
 	/**
@@ -214,20 +244,42 @@ public:
 
 
 public:
-	VM(t_addr memsize = 0x1000);
+	VM(t_addr memsize = 0x1000, bool guards = false, bool lazy = false);
 	~VM();
 
 	void SetDebug(bool b) { m_debug = b; }
 	void SetDrawMemImages(bool b) { m_drawmemimages = b; }
-	void SetChecks(bool b) { m_checks = b; }
+	void SetChecks(bool b) { m_checks = b; ClearNativeCode(); }
 	void SetZeroPoppedVals(bool b) { m_zeropoppedvals = b; }
+	void SetOutputBuffer(std::size_t size, bool flush_lines = true);
+	void SetJit(bool b) { m_jit = b; }
+	void SetProfile(bool b) { m_profile = b; }
+	void SetSampleInterval(std::chrono::microseconds us) { m_sample_ticks = us; }
+	void SetVerify(bool b) { m_verify = b; }
+	void SetDebugInfo(DebugInfo&& info) { m_debuginfo = std::move(info); }
 
 	void Reset();
 	bool Run();
 
+	// number of instructions executed in the last run
+	std::size_t GetNumOps() const { return m_num_ops; }
+	const VMProfiler& GetProfiler() const { return m_profiler; }
+	const DebugInfo* GetDebugInfo() const { return m_debuginfo ? &*m_debuginfo : nullptr; }
+
+	// result of the code verification, nullopt if the code has not been verified
+	std::optional<bool> GetCodeVerified() const { return m_code_verified; }
+	const t_str& GetVerifyError() const { return m_verify_error; }
+
+	// memory usage since the last reset
+	t_addr GetMemSize() const { return m_memsize; }
+	t_addr GetCodeSize() const { return std::max<t_addr>(m_code_range[1], 0); }
+	t_addr GetPeakStackSize() const;
+	std::optional<std::size_t> GetResidentMemSize() const { return m_mem.GetResidentSize(); }
+
 	void SetMem(t_addr addr, t_byte data);
 	void SetMem(t_addr addr, const t_byte* data, std::size_t size, bool is_code = false);
 	void SetMem(t_addr addr, const std::string& data, bool is_code = false);
+	bool MapCode(int fd, std::size_t offset, std::size_t size);
 
 	t_addr GetSP() const { return m_sp; }
 	t_addr GetBP() const { return m_bp; }
@@ -240,10 +292,10 @@ public:
 	void SetIP(t_addr ip) { m_ip = ip; }
 
 	//get top data from the stack
-	t_data TopData() const;
+	template<bool checks = true> t_data TopData() const;
 
 	//pop data from the stack
-	t_data PopData();
+	template<bool checks = true> t_data PopData();
 
 	//signals an interrupt
 	void RequestInterrupt(t_addr num);
@@ -258,66 +310,106 @@ protected:
 
 	//call external function
 	t_data CallExternal(const t_str& func_name);
+	t_data CallExternal(ExtFunc func_id);
+
+	// buffered program output
+	void WriteOutput(const t_str& str);
+	void FlushOutput();
 
 	// sets the address of an interrupt service routine
 	void SetISR(t_addr num, t_addr addr);
 
 	void StartTimer();
 	void StopTimer();
+	void UpdateTimer();
+
+	// records the call stack for the sampling profiler
+	void SampleStack();
+
+	// --------------------------------------------------------------------
+	// native code
+	// --------------------------------------------------------------------
+	// run a hot function as native code
+	void RunNative(t_addr funcaddr);
+
+	// remove all generated code
+	void ClearNativeCode();
+
+#if VM_JIT != 0
+	// get the native code of a function, compiling it if it is hot
+	const void* GetNativeFunc(t_addr funcaddr);
+
+	// compile a function and the functions it calls
+	void CompileNative(t_addr funcaddr);
+
+	// get the end address of a function
+	std::optional<t_addr> GetNativeRegion(t_addr funcaddr) const;
+
+	// emit the native code for a function
+	void EmitNativeFunc(JitBatch& batch, t_addr funcaddr, t_addr funcend);
+#endif
+	// --------------------------------------------------------------------
 
 	// --------------------------------------------------------------------
 	// memory/stack operations
 	// --------------------------------------------------------------------
 	//pop an address from the stack
-	t_addr PopAddress();
+	template<bool checks = true> t_addr PopAddress();
 
 	// push an address to stack
-	void PushAddress(t_addr addr, VMType ty = VMType::ADDR_MEM);
+	template<bool checks = true> void PushAddress(t_addr addr, VMType ty = VMType::ADDR_MEM);
 
 	// pop a bool from the stack
-	bool PopBool();
+	template<bool checks = true> bool PopBool(VMType proven = VMType::UNKNOWN);
 
 	// push a bool to the stack
-	void PushBool(bool val);
+	template<bool checks = true> void PushBool(bool val);
 
 	// pop a complex number from the stack
-	t_cplx PopComplex();
+	template<bool checks = true> t_cplx PopComplex();
 
 	// pop a quaternion from the stack
-	t_quat PopQuaternion();
+	template<bool checks = true> t_quat PopQuaternion();
 
 	// get the complex number on top of the stack
-	t_cplx TopComplex(t_addr sp_offs = 0) const;
+	template<bool checks = true> t_cplx TopComplex(t_addr sp_offs = 0) const;
 
 	// get the quaternion on top of the stack
-	t_quat TopQuaternion(t_addr sp_offs = 0) const;
+	template<bool checks = true> t_quat TopQuaternion(t_addr sp_offs = 0) const;
 
 	// push a complex number to the stack
-	void PushComplex(const t_cplx& val, bool raw = true);
+	template<bool checks = true> void PushComplex(const t_cplx& val, bool raw = true);
 
 	// push a quaternion to the stack
-	void PushQuaternion(const t_quat& val, bool raw = true);
+	template<bool checks = true> void PushQuaternion(const t_quat& val, bool raw = true);
 
 	// pop a string from the stack
-	t_str PopString();
+	template<bool checks = true> t_str PopString();
 
 	// get the string on top of the stack
-	t_str TopString(t_addr sp_offs = 0) const;
+	template<bool checks = true> t_str TopString(t_addr sp_offs = 0) const;
 
 	// push a string to the stack
-	void PushString(const t_str& str, bool raw = true);
+	template<bool checks = true> void PushString(const t_str& str, bool raw = true);
 
 	// push data onto the stack
+	template<bool checks = true>
 	void PushData(const t_data& data, VMType ty = VMType::UNKNOWN, bool err_on_unknown = true);
 
 	// read the data type prefix from data in memory
-	VMType ReadMemType(t_addr addr);
+	template<bool checks = true> VMType ReadMemType(t_addr addr);
 
 	// read data from memory
-	std::tuple<VMType, t_data> ReadMemData(t_addr addr);
+	template<bool checks = true> std::tuple<VMType, t_data> ReadMemData(t_addr addr);
 
 	// write data to memory
-	void WriteMemData(t_addr addr, const t_data& data);
+	template<bool checks = true> void WriteMemData(t_addr addr, const t_data& data);
+
+	// push data from memory onto the stack
+	template<bool checks = true> void PushMemData(t_addr addr);
+
+	// pop data from the stack and write it to memory
+	template<bool checks = true> void PopMemData(t_addr addr);
 	// --------------------------------------------------------------------
 
 	// --------------------------------------------------------------------
@@ -328,125 +420,217 @@ protected:
 	 * an array consists of an t_addr giving the length
 	 * following by the array elements
 	 */
-	template<class t_vec = t_vec_real> t_vec PopArray(bool raw_elems = true);
+	template<class t_vec = t_vec_real, bool checks = true> t_vec PopArray(bool raw_elems = true);
 
 	// get the array on top of the stack
-	template<class t_vec = t_vec_real> t_vec TopArray(t_addr sp_offs = 0) const;
+	template<class t_vec = t_vec_real, bool checks = true> t_vec TopArray(t_addr sp_offs = 0) const;
 
 	// push an array onto the stack
-	template<class t_vec = t_vec_real> void PushArray(const t_vec& vec, bool raw = true);
+	template<class t_vec = t_vec_real, bool checks = true> void PushArray(const t_vec& vec, bool raw = true);
 
 	// read an array from a memory address
-	template<class t_vec = t_vec_real>
+	template<class t_vec = t_vec_real, bool checks = true>
 	t_vec ReadArrayRaw(t_addr addr) const;
 
 	// write an array to a memory address
-	template<class t_vec = t_vec_real>
+	template<class t_vec = t_vec_real, bool checks = true>
 	void WriteArray(t_addr addr, const t_vec& vec, bool raw = true);
 
 	// read an array element from a given index and push it onto the stack
-	template<class t_vec = t_vec_real>
+	template<class t_vec = t_vec_real, bool checks = true>
 	void ReadArrayElem(const t_data& arr, t_int idx = 0);
 
+	// read an array element directly from a memory address and push it onto the stack
+	template<class t_vec = t_vec_real, bool checks = true>
+	void ReadArrayElem(t_addr addr, t_int idx = 0);
+
 	/**
 	 * read an array element range from given indices
 	 * and push the new array onto the stack
 	 */
-	template<class t_vec = t_vec_real>
+	template<class t_vec = t_vec_real, bool checks = true>
 	void ReadArrayElemRange(const t_data& arr, t_int idx1 = 0, t_int idx2 = 0);
 
+	/**
+	 * read an array element range directly from a memory address
+	 * and push the new array onto the stack
+	 */
+	template<class t_vec = t_vec_real, bool checks = true>
+	void ReadArrayElemRange(t_addr addr, t_int idx1 = 0, t_int idx2 = 0);
+
 	// write an array element to a memory address
-	template<class t_vec = t_vec_real>
+	template<class t_vec = t_vec_real, bool checks = true>
 	void WriteArrayElem(t_addr addr, const t_data& data, t_int idx = 0);
 
 	// write an array element range to a memory address
-	template<class t_vec = t_vec_real>
+	template<class t_vec = t_vec_real, bool checks = true>
 	void WriteArrayElemRange(t_addr addr, const t_data& data,
 		t_int idx1 = 0, t_int idx2 = 0);
 
+	// copy an array element range between two memory addresses
+	template<class t_vec = t_vec_real, bool checks = true>
+	void CopyArrayElemRange(t_addr dst_addr, t_int dst_idx1, t_int dst_idx2,
+		t_addr src_addr, t_int src_idx1, t_int src_idx2);
+
 	// --------------------------------------------------------------------
 	// raw memory/stack operations
 	// --------------------------------------------------------------------
 	// read a raw value from memory
-	template<class t_val> t_val ReadMemRaw(t_addr addr) const;
+	template<class t_val, bool checks = true> t_val ReadMemRaw(t_addr addr) const;
 
 	// write a raw value to memory
-	template<class t_val>
+	template<class t_val, bool checks = true>
 	void WriteMemRaw(t_addr addr, const t_val& val);
 
 	// get the value on top of the stack
-	template<class t_val, t_addr valsize = sizeof(t_val)>
+	template<class t_val, t_addr valsize = sizeof(t_val), bool checks = true>
 	t_val TopRaw(t_addr sp_offs = 0) const;
 
 	// pop a raw value from the stack
-	template<class t_val, t_addr valsize = sizeof(t_val)>
+	template<class t_val, t_addr valsize = sizeof(t_val), bool checks = true>
 	t_val PopRaw();
 
 	// push a raw value onto the stack
-	template<class t_val, t_addr valsize = sizeof(t_val)>
+	template<class t_val, t_addr valsize = sizeof(t_val), bool checks = true>
 	void PushRaw(const t_val& val);
+
+	// push or pop the padding of a value up to whole stack slots
+	template<bool checks = true> void PushPadding(t_addr size);
+	template<bool checks = true> void PopPadding(t_addr size);
+
+	// pop or push an integer or real without type descriptor
+	template<class t_val, bool checks = true> t_val PopUntagged();
+	template<class t_val, bool checks = true> void PushUntagged(const t_val& val);
 	// --------------------------------------------------------------------
 
 	// --------------------------------------------------------------------
 	// operators
 	// --------------------------------------------------------------------
 	// cast from one variable type to the other
-	template<std::size_t toidx> void OpCast();
+	template<std::size_t toidx, bool checks = true> void OpCast();
 
 	// cast from an array variable type
-	template<class t_to, class t_vec> void OpCastFromArray(const t_data& data);
+	template<class t_to, class t_vec, bool checks = true> void OpCastFromArray(const t_data& data);
 
 	// cast to an array variable type
-	template<class t_vec_to> void OpCastToArray(t_addr size);
+	template<class t_vec_to, bool checks = true> void OpCastToArray(t_addr size);
 
 	// same-type arithmetic operation
 	template<class t_val, char op>
 	t_val OpArithmeticSameType(const t_val& val1, const t_val& val2);
 
 	// arithmetic operation
-	template<char op> void OpArithmetic();
+	template<char op, bool checks = true> void OpArithmetic(VMType proven = VMType::UNKNOWN);
 
 	// matrix multiplication
-	void OpMatrixMultiplication();
+	template<bool checks = true> void OpMatrixMultiplication();
 
 	// logical operation
-	template<char op> void OpLogical();
+	template<char op, bool checks = true> void OpLogical();
 
 	// same-type binary operation
 	template<class t_val, char op>
 	t_val OpBinarySameType(const t_val& val1, const t_val& val2);
 
 	// binary operation
-	template<char op> void OpBinary();
+	template<char op, bool checks = true> void OpBinary();
 
 	// same-type comparison operation
 	template<class t_val, OpCode op>
 	bool OpComparisonSameType(const t_val& val1, const t_val& val2);
 
 	// comparison operation
-	template<OpCode op> void OpComparison();
+	template<OpCode op, bool checks = true>
+	void OpComparison(VMType proven = VMType::UNKNOWN);
+
+	// comparison operation, returning the result instead of pushing it
+	template<OpCode op, bool checks = true>
+	bool OpCompare(VMType proven = VMType::UNKNOWN);
+
+	// are the two values on top of the stack scalars of the given type?
+	template<class t_val, bool checks = true> bool HasTopScalars() const;
+
+	// operations on raw integers or reals on the stack, without type tests
+	template<class t_val, char op, bool checks = true> void OpArithmeticRaw();
+	template<class t_val, OpCode op, bool checks = true> bool OpCompareRaw();
+
+	// arithmetic operation on raw integers or reals on the stack
+	template<class t_val, char op, bool checks = true>
+	void OpArithmeticTyped(VMType proven = VMType::UNKNOWN);
+
+	// comparison operation on raw integers or reals on the stack
+	template<class t_val, OpCode op, bool checks = true>
+	bool OpCompareTyped(VMType proven = VMType::UNKNOWN);
+	template<class t_val, OpCode op, bool checks = true>
+	void OpComparisonTyped(VMType proven = VMType::UNKNOWN);
+
+	// add or remove the type descriptor of an integer or real
+	template<class t_val, bool checks = true> void OpTag();
+	template<class t_val, bool checks = true> void OpUntag(VMType proven = VMType::UNKNOWN);
+
+	// read or write a variable as untagged integer or real
+	template<class t_val, bool checks = true>
+	void OpLoadUntagged(t_addr addr, VMType proven = VMType::UNKNOWN);
+	template<class t_val, bool checks = true> void OpStoreUntagged(t_addr addr);
+
+	// operations on untagged integers or reals on the stack
+	template<class t_from, class t_to, bool checks = true> void OpCastUntagged();
+	template<class t_val, char op, bool checks = true> void OpArithmeticUntagged();
+	template<class t_val, OpCode op, bool checks = true> bool OpCompareUntagged();
+	template<class t_val, OpCode op, bool checks = true> void OpComparisonUntagged();
 	// --------------------------------------------------------------------
 
 
 private:
-	void CheckMemoryBounds(t_addr addr, t_addr size = 1) const;
+	template<bool checks = true> void CheckMemoryBounds(t_addr addr, t_addr size = 1) const;
+	[[noreturn]] void ThrowMemoryBounds(t_addr addr, t_addr size) const;
 	void CheckPointerBounds() const;
 	void UpdateCodeRange(t_addr begin, t_addr end);
 
 	void TimerFunc();
 
+	// interpreter loops specialised for the debug, check and memory image modes
+	bool RunLoop();
+	template<bool debug> std::optional<bool> RunWithFlags(bool checks, bool memimages);
+	template<bool debug, bool checks, bool memimages, bool profile = false, bool verified = false>
+	std::optional<bool> RunInstructions();
+
+	// decode the instructions in the code range
+	void DecodeCode();
+	std::optional<DecodedInstr> DecodeInstr(t_addr addr) const;
+	std::optional<t_addr> GetDirectDataSize(t_addr addr) const;
+
+	// verify the decoded instructions to run them without type tests
+	bool VerifyCode();
+	bool CanRunVerified();
+	bool IsVerifiedInstr(t_addr addr) const;
+
 
 private:
 	bool m_debug{false};               // write debug messages
 	bool m_checks{true};               // do memory boundary checks
 	bool m_drawmemimages{false};       // write memory dump images
 	bool m_zeropoppedvals{false};      // zero memory of popped values
+	bool m_jit{false};                 // compile hot functions to native code
+	bool m_profile{false};             // count and time the opcodes and functions
+	bool m_verify{true};               // run verified code without type tests
 	t_real m_eps{std::numeric_limits<t_real>::epsilon()};
 	t_int m_prec{6};
 
-	std::unique_ptr<t_byte[]> m_mem{}; // ram
+	// program output buffer, unbuffered if its size is zero
+	t_str m_outbuf{};
+	std::size_t m_outbuf_size{0};
+	bool m_outbuf_flushlines{true};    // flush the buffer at line ends
+
+	VMMemory m_mem{};                  // ram
 	t_addr m_code_range[2]{-1, -1};    // address range where the code resides
 
+	// pre-decoded instructions, indexed by address relative to the code start
+	std::vector<DecodedInstr> m_decoded{};
+	bool m_code_decoded{false};        // is the decoded code up-to-date?
+	std::optional<bool> m_code_verified{};  // has the decoded code been verified?
+	t_str m_verify_error{};            // why the code could not be verified
+
 	// registers
 	t_addr m_ip{};                     // instruction pointer
 	t_addr m_sp{};                     // stack pointer
@@ -456,14 +640,36 @@ private:
 	// memory sizes and ranges
 	t_addr m_memsize = 0x1000;         // total memory size
 
-	// signals interrupt requests
-	std::array<std::atomic_bool, m_num_interrupts> m_irqs{};
+	std::size_t m_num_ops{0};          // number of executed instructions
+	VMProfiler m_profiler{};           // opcode and function statistics
+	std::optional<DebugInfo> m_debuginfo{};  // source lines and functions of the code
+
+#if VM_JIT != 0
+	// number of calls after which a function is compiled
+	static constexpr const std::size_t m_jit_hot_calls = 16;
+
+	// native code of the functions, nullptr if they cannot be compiled
+	std::unordered_map<t_addr, const void*> m_native_funcs{};
+	// number of interpreted calls of the functions
+	std::unordered_map<t_addr, std::size_t> m_native_calls{};
+	std::vector<JitCode> m_native_code{};
+	JitCode m_native_enter{};          // entry trampoline
+#endif
+
+	// signals interrupt requests, one bit per pending interrupt
+	using t_irqmask = std::uint32_t;
+	static_assert(m_sample_interrupt < std::numeric_limits<t_irqmask>::digits,
+		"Too many interrupts for the pending interrupt mask.");
+	std::atomic<t_irqmask> m_irqs{0};
 	// addresses of the interrupt service routines
 	std::array<std::optional<t_addr>, m_num_interrupts> m_isrs{};
 
 	std::thread m_timer_thread{};
 	bool m_timer_running{false};
+	bool m_timer_irq{false};                  // request timer interrupts
 	std::chrono::milliseconds m_timer_ticks{250};
+	bool m_sampling{false};                   // request call stack samples
+	std::chrono::microseconds m_sample_ticks{0};  // sampling interval, 0: off
 };
 
 
@@ -0,0 +1,665 @@
+/**
+ * zero-address code vm, memory backend
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#include "vmmem.h"
+
+#include <stdexcept>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <mutex>
+#include <limits>
+
+#if VM_MMAP != 0
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#if VM_GUARD_PAGES != 0
+	#include <signal.h>
+#endif
+
+
+
+#if VM_MMAP != 0
+static std::size_t get_pagesize()
+{
+	return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+
+static std::size_t round_to_pages(std::size_t size, std::size_t pagesize)
+{
+	return (size + pagesize - 1) / pagesize * pagesize;
+}
+#endif
+
+
+
+#if VM_GUARD_PAGES != 0
+// addresses below and above the vm memory that have to be guarded,
+// covering all t_vm_addr offsets and lengths
+static constexpr const std::size_t g_guard_below = std::size_t(1) << 31;
+static constexpr const std::size_t g_guard_above = std::size_t(1) << 32;
+
+// guarded run of the current thread, used by the signal handler
+static thread_local const VMMemory* t_guarded_mem = nullptr;
+
+// previously installed signal handlers
+static struct sigaction g_prev_segv{};
+static struct sigaction g_prev_bus{};
+
+
+/**
+ * appends a string or a number to the message buffer,
+ * only using async-signal-safe operations
+ */
+static void append_msg(char* buf, std::size_t& len, std::size_t size, const char* str)
+{
+	while(*str && len + 1 < size)
+		buf[len++] = *str++;
+}
+
+
+static void append_msg(char* buf, std::size_t& len, std::size_t size, std::int64_t num)
+{
+	char digits[24];
+	std::size_t num_digits = 0;
+
+	std::uint64_t val = (num < 0 ? std::uint64_t(0) - std::uint64_t(num) : std::uint64_t(num));
+	do
+	{
+		digits[num_digits++] = char('0' + val % 10);
+		val /= 10;
+	}
+	while(val);
+
+	if(num < 0)
+		digits[num_digits++] = '-';
+
+	while(num_digits && len + 1 < size)
+		buf[len++] = digits[--num_digits];
+}
+
+
+/**
+ * writes all data to a file descriptor, async-signal-safe
+ */
+static void write_all(int fd, const char* data, std::size_t size)
+{
+	while(size)
+	{
+		::ssize_t written = ::write(fd, data, size);
+		if(written <= 0)
+			break;
+
+		data += written;
+		size -= static_cast<std::size_t>(written);
+	}
+}
+
+
+/**
+ * reports an access to the guard pages or to the write-protected code
+ * in the same way as a failed bounds check and exits
+ */
+[[noreturn]] static void report_fault(const VMMemory* mem, const void* fault_addr)
+{
+	// write out the program output that has been buffered so far
+	if(const std::string* output = mem->GetFaultOutput(); output)
+		write_all(STDOUT_FILENO, output->data(), output->size());
+
+	const std::int64_t addr = static_cast<const t_vm_byte*>(fault_addr) - mem->get();
+	const std::int64_t size = mem->GetSize();
+
+	char buf[256];
+	std::size_t len = 0;
+	append_msg(buf, len, sizeof(buf), "Error: Attempted memory access out of bounds: ");
+	if(addr >= 0 && addr < size)
+	{
+		append_msg(buf, len, sizeof(buf), "write to the code pages at address ");
+		append_msg(buf, len, sizeof(buf), addr);
+		append_msg(buf, len, sizeof(buf), ".");
+	}
+	else
+	{
+		append_msg(buf, len, sizeof(buf), "address ");
+		append_msg(buf, len, sizeof(buf), addr);
+		append_msg(buf, len, sizeof(buf), " is outside of the memory size ");
+		append_msg(buf, len, sizeof(buf), size);
+		append_msg(buf, len, sizeof(buf), ".");
+	}
+	buf[len++] = '\n';
+
+	write_all(STDERR_FILENO, buf, len);
+	::_exit(-1);
+}
+
+
+/**
+ * reports faults in the reserved address range of the guarded run,
+ * passes all other faults on to the previous handlers
+ */
+static void guard_handler(int sig, siginfo_t* info, void* ctx)
+{
+	if(t_guarded_mem && t_guarded_mem->IsReserved(info->si_addr))
+		report_fault(t_guarded_mem, info->si_addr);
+
+	const struct sigaction& prev = (sig == SIGBUS ? g_prev_bus : g_prev_segv);
+	if((prev.sa_flags & SA_SIGINFO) && prev.sa_sigaction)
+	{
+		prev.sa_sigaction(sig, info, ctx);
+	}
+	else if(prev.sa_handler != SIG_DFL && prev.sa_handler != SIG_IGN)
+	{
+		prev.sa_handler(sig);
+	}
+	else
+	{
+		// restore the default action, which is taken
+		// when the faulting instruction is executed again
+		::sigaction(sig, &prev, nullptr);
+	}
+}
+
+
+static void install_guard_handler()
+{
+	static std::once_flag installed;
+	std::call_once(installed, []()
+	{
+		struct sigaction action{};
+		action.sa_sigaction = &guard_handler;
+		action.sa_flags = SA_SIGINFO | SA_NODEFER;
+		sigemptyset(&action.sa_mask);
+
+		if(::sigaction(SIGSEGV, &action, &g_prev_segv) != 0
+			|| ::sigaction(SIGBUS, &action, &g_prev_bus) != 0)
+			throw std::runtime_error("Cannot install the guard page signal handler.");
+	});
+}
+#endif
+
+
+
+VMMemory::~VMMemory()
+{
+	Free();
+}
+
+
+/**
+ * allocates the memory, optionally surrounded by guard pages
+ * and optionally committing the pages when they are used
+ */
+void VMMemory::Allocate(t_vm_addr size, bool guards, bool lazy)
+{
+	Free();
+
+	if(size <= 0)
+		throw std::runtime_error("Invalid memory size.");
+
+	if(!guards && !lazy)
+	{
+		m_heap.reset(new t_vm_byte[size]);
+		m_mem = m_heap.get();
+		m_size = size;
+		return;
+	}
+
+#if VM_MMAP != 0
+	const std::size_t pagesize = get_pagesize();
+
+	if(!guards)
+	{
+		m_mapped_size = round_to_pages(std::size_t(size), pagesize);
+		void* mapped = ::mmap(nullptr, m_mapped_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if(mapped == MAP_FAILED)
+		{
+			m_mapped_size = 0;
+			throw std::runtime_error("Cannot reserve the memory.");
+		}
+
+		m_mapped = m_mem = static_cast<t_vm_byte*>(mapped);
+		m_size = size;
+		m_lazy = true;
+		return;
+	}
+#endif
+
+#if VM_GUARD_PAGES != 0
+	install_guard_handler();
+
+	// no accessible padding is left between the memory and the guard pages
+	const std::size_t accessible_size = round_to_pages(std::size_t(size), pagesize);
+	if(accessible_size > std::size_t(std::numeric_limits<t_vm_addr>::max()))
+		throw std::runtime_error("Invalid memory size.");
+
+	// reserve the whole range without access and without backing storage
+	m_mapped_size = g_guard_below + accessible_size + g_guard_above;
+	void* mapped = ::mmap(nullptr, m_mapped_size, PROT_NONE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if(mapped == MAP_FAILED)
+	{
+		m_mapped_size = 0;
+		throw std::runtime_error("Cannot reserve the guarded memory range.");
+	}
+	m_mapped = static_cast<t_vm_byte*>(mapped);
+
+	// make the vm memory accessible, its pages are only committed when they are used
+	t_vm_byte* accessible = m_mapped + g_guard_below;
+	if(::mprotect(accessible, accessible_size, PROT_READ | PROT_WRITE) != 0)
+	{
+		Free();
+		throw std::runtime_error("Cannot allocate the guarded memory.");
+	}
+
+	m_mem = accessible;
+	m_size = static_cast<t_vm_addr>(accessible_size);
+	m_guards = true;
+	m_lazy = lazy;
+#else
+	throw std::runtime_error("Guard pages or lazily allocated memory"
+		" are not supported on this system.");
+#endif
+}
+
+
+void VMMemory::Free()
+{
+	m_heap.reset();
+
+#if VM_MMAP != 0
+	if(m_mapped)
+		::munmap(m_mapped, m_mapped_size);
+#endif
+
+	m_mapped = nullptr;
+	m_mapped_size = 0;
+	m_filemapped_size = 0;
+	m_protected = nullptr;
+	m_protected_size = 0;
+	m_guards = false;
+	m_lazy = false;
+	m_mem = nullptr;
+	m_size = 0;
+}
+
+
+/**
+ * fills the memory, lazily allocated memory is only
+ * touched if the fill value is not zero
+ */
+void VMMemory::Clear(t_vm_byte fill)
+{
+	UnmapFile();
+
+#if VM_MMAP != 0 && defined(__linux__)
+	if(m_lazy && fill == 0)
+	{
+		// release the pages, they read as zeros when used again
+		const std::uintptr_t pagesize = get_pagesize();
+		const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(m_mem);
+		const std::uintptr_t first = (begin + pagesize - 1) / pagesize * pagesize;
+		const std::uintptr_t last = (begin + m_size) / pagesize * pagesize;
+
+		// clear the partially used pages at the borders
+		if(last > first && ::madvise(reinterpret_cast<void*>(first),
+			last - first, MADV_DONTNEED) == 0)
+		{
+			std::memset(m_mem, fill, first - begin);
+			std::memset(reinterpret_cast<t_vm_byte*>(last), fill, begin + m_size - last);
+			return;
+		}
+	}
+#endif
+
+	std::memset(m_mem, fill, m_size);
+}
+
+
+/**
+ * maps size bytes of a program file, starting at the file offset, to the
+ * start of the memory, the pages are private copies that are only read from
+ * the file when they are first used, only the rest of the last page is
+ * copied directly
+ * @returns false if the memory is not mapped or it or the offset is not page-aligned
+ */
+bool VMMemory::MapFile([[maybe_unused]] int fd, [[maybe_unused]] std::size_t offset,
+	[[maybe_unused]] std::size_t size)
+{
+#if VM_MMAP != 0
+	const std::size_t pagesize = get_pagesize();
+	if(fd < 0 || !m_mapped || size > std::size_t(m_size) || offset % pagesize != 0
+		|| reinterpret_cast<std::uintptr_t>(m_mem) % pagesize != 0)
+		return false;
+
+	UnmapFile();
+
+	const std::size_t mapped_size = size / pagesize * pagesize;
+	if(mapped_size)
+	{
+		void* mem = ::mmap(m_mem, mapped_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_FIXED, fd, ::off_t(offset));
+		if(mem == MAP_FAILED)
+		{
+			// the previous pages may have been unmapped
+			m_filemapped_size = mapped_size;
+			UnmapFile();
+			return false;
+		}
+
+		m_filemapped_size = mapped_size;
+	}
+
+	// the partially used last page also holds the start of the stack
+	for(std::size_t pos = mapped_size; pos < size;)
+	{
+		const ::ssize_t num = ::pread(fd, m_mem + pos, size - pos, ::off_t(offset + pos));
+		if(num <= 0)
+			return false;
+		pos += std::size_t(num);
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+/**
+ * replaces the pages mapped from a program file by anonymous ones
+ */
+void VMMemory::UnmapFile()
+{
+#if VM_MMAP != 0
+	if(m_filemapped_size)
+	{
+		::mmap(m_mem, m_filemapped_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+	}
+#endif
+
+	m_filemapped_size = 0;
+}
+
+
+/**
+ * is the host address in the reserved range of the guarded memory?
+ */
+bool VMMemory::IsReserved(const void* addr) const
+{
+	if(!m_guards)
+		return false;
+
+	const t_vm_byte* ptr = static_cast<const t_vm_byte*>(addr);
+	return ptr >= m_mapped && ptr < m_mapped + m_mapped_size;
+}
+
+
+#if VM_MMAP != 0 && defined(__linux__)
+/**
+ * get the residency of the pages in the host range [begin, end)
+ * @returns the page-aligned start of the range and the flags per page
+ */
+static std::pair<std::uintptr_t, std::vector<unsigned char>>
+get_resident_pages(const t_vm_byte* begin, const t_vm_byte* end)
+{
+	const std::uintptr_t pagesize = get_pagesize();
+	const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(begin)
+		/ pagesize * pagesize;
+	const std::uintptr_t last = round_to_pages(
+		reinterpret_cast<std::uintptr_t>(end), pagesize);
+
+	std::vector<unsigned char> resident((last - first) / pagesize);
+	if(resident.size() && ::mincore(reinterpret_cast<void*>(first),
+		last - first, resident.data()) != 0)
+	{
+		// unknown, treat all pages as resident
+		std::fill(resident.begin(), resident.end(), 1);
+	}
+
+	return std::make_pair(first, std::move(resident));
+}
+#endif
+
+
+/**
+ * get the lowest address in the range [begin, end) that does not hold
+ * the fill value, the pages of lazily allocated memory that have
+ * never been used are skipped
+ */
+std::optional<t_vm_addr> VMMemory::GetLowestUsed(
+	t_vm_addr begin, t_vm_addr end, t_vm_byte fill) const
+{
+	begin = std::max<t_vm_addr>(begin, 0);
+	end = std::min<t_vm_addr>(end, m_size);
+	if(begin >= end)
+		return std::nullopt;
+
+#if VM_MMAP != 0 && defined(__linux__)
+	if(m_lazy)
+	{
+		// only look at the pages that have been used, reading
+		// the others would make the system map them
+		const std::uintptr_t pagesize = get_pagesize();
+		const auto [first, resident] = get_resident_pages(m_mem + begin, m_mem + end);
+
+		for(std::size_t page = 0; page < resident.size(); ++page)
+		{
+			if(!(resident[page] & 1))
+				continue;
+
+			const t_vm_addr page_begin = static_cast<t_vm_addr>(
+				std::ptrdiff_t(first + page*pagesize) - std::ptrdiff_t(m_mem));
+			const t_vm_addr page_end = static_cast<t_vm_addr>(page_begin + pagesize);
+
+			for(t_vm_addr addr = std::max(begin, page_begin);
+				addr < std::min(end, page_end); ++addr)
+			{
+				if(m_mem[addr] != fill)
+					return addr;
+			}
+		}
+
+		return std::nullopt;
+	}
+#endif
+
+	for(t_vm_addr addr = begin; addr < end; ++addr)
+	{
+		if(m_mem[addr] != fill)
+			return addr;
+	}
+
+	return std::nullopt;
+}
+
+
+/**
+ * get the size of the memory pages committed by the system
+ */
+std::optional<std::size_t> VMMemory::GetResidentSize() const
+{
+#if VM_MMAP != 0 && defined(__linux__)
+	if(m_mapped)
+	{
+		const std::size_t pagesize = get_pagesize();
+		const auto [first, resident] = get_resident_pages(m_mem, m_mem + m_size);
+
+		std::size_t num_pages = 0;
+		for(unsigned char page : resident)
+			num_pages += (page & 1);
+		return num_pages * pagesize;
+	}
+#endif
+
+	return std::nullopt;
+}
+
+
+/**
+ * write-protects the pages holding the code range [begin, end), the rest of
+ * the last code page is protected as well and cannot be used by the stack
+ * @returns false if the code range could not be protected completely
+ */
+bool VMMemory::ProtectCode([[maybe_unused]] t_vm_addr begin, [[maybe_unused]] t_vm_addr end)
+{
+	UnprotectCode();
+
+#if VM_GUARD_PAGES != 0
+	if(!m_guards || begin < 0 || end > m_size || begin >= end)
+		return false;
+
+	const std::uintptr_t pagesize = get_pagesize();
+	const std::uintptr_t mem_end = reinterpret_cast<std::uintptr_t>(m_mem + m_size);
+	const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(m_mem + begin)
+		/ pagesize * pagesize;
+	const std::uintptr_t last = round_to_pages(
+		reinterpret_cast<std::uintptr_t>(m_mem + end), pagesize);
+
+	// the code and the stack share the last page
+	if(last >= mem_end)
+		return false;
+
+	t_vm_byte* pages = reinterpret_cast<t_vm_byte*>(first);
+	if(::mprotect(pages, last - first, PROT_READ) != 0)
+		return false;
+
+	m_protected = pages;
+	m_protected_size = last - first;
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+void VMMemory::UnprotectCode()
+{
+#if VM_GUARD_PAGES != 0
+	if(m_protected)
+		::mprotect(m_protected, m_protected_size, PROT_READ | PROT_WRITE);
+#endif
+
+	m_protected = nullptr;
+	m_protected_size = 0;
+}
+
+
+#if VM_GUARD_PAGES != 0
+/**
+ * starts a guarded run on the current thread
+ */
+void VMMemory::EnterGuarded(t_vm_addr code_begin, t_vm_addr code_end,
+	const std::string* output)
+{
+	if(!m_guards)
+		throw std::runtime_error("The memory has no guard pages.");
+
+	m_prev_mem = t_guarded_mem;
+	m_fault_output = output;
+	t_guarded_mem = this;
+
+	// the bounds checks are only replaced if the code cannot be overwritten,
+	// otherwise the guard pages just catch the accesses beyond the memory
+	m_guarded = ProtectCode(code_begin, code_end);
+}
+
+
+/**
+ * ends the guarded run, makes the code writable again
+ */
+void VMMemory::ExitGuarded()
+{
+	t_guarded_mem = m_prev_mem;
+	m_prev_mem = nullptr;
+	m_fault_output = nullptr;
+	m_guarded = false;
+
+	UnprotectCode();
+}
+#endif
+
+
+
+ProgramFile::~ProgramFile()
+{
+	Close();
+}
+
+
+/**
+ * maps or reads the program file
+ */
+bool ProgramFile::Open(const std::string& filename)
+{
+	Close();
+
+#if VM_MMAP != 0
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if(fd >= 0)
+	{
+		struct stat filestat{};
+		if(::fstat(fd, &filestat) == 0 && filestat.st_size > 0)
+		{
+			void* mapped = ::mmap(nullptr, std::size_t(filestat.st_size),
+				PROT_READ, MAP_PRIVATE, fd, 0);
+			if(mapped != MAP_FAILED)
+			{
+				m_fd = fd;
+				m_mapped = mapped;
+				m_data = static_cast<const t_vm_byte*>(mapped);
+				m_size = std::size_t(filestat.st_size);
+				return true;
+			}
+		}
+
+		::close(fd);
+	}
+#endif
+
+	std::ifstream ifstr(filename, std::ios_base::binary | std::ios_base::ate);
+	if(!ifstr)
+		return false;
+
+	m_bytes.resize(std::size_t(ifstr.tellg()));
+	ifstr.seekg(0, std::ios_base::beg);
+	ifstr.read(reinterpret_cast<char*>(m_bytes.data()), m_bytes.size());
+	if(ifstr.fail())
+	{
+		m_bytes.clear();
+		return false;
+	}
+
+	m_data = m_bytes.data();
+	m_size = m_bytes.size();
+	return true;
+}
+
+
+void ProgramFile::Close()
+{
+#if VM_MMAP != 0
+	if(m_mapped)
+		::munmap(m_mapped, m_size);
+	if(m_fd >= 0)
+		::close(m_fd);
+#endif
+
+	m_mapped = nullptr;
+	m_fd = -1;
+	m_data = nullptr;
+	m_size = 0;
+	m_bytes.clear();
+}
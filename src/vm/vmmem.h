@@ -0,0 +1,202 @@
+/**
+ * zero-address code vm, memory backend
+ * @author Tobias Weber (orcid: 0000-0002-7230-1932)
+ * @date 16-oct-2026
+ * @license see 'LICENSE' file
+ */
+
+#ifndef __0ACVM_VMMEM_H__
+#define __0ACVM_VMMEM_H__
+
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+#include "types.h"
+
+
+// lazily committed memory needs posix memory mappings
+#if defined(__unix__) || defined(__APPLE__)
+	#define VM_MMAP 1
+#else
+	#define VM_MMAP 0
+#endif
+
+// guard pages additionally need signals and a 64 bit host
+// address space to reserve the range of all 32 bit vm addresses
+#if VM_MMAP != 0 && UINTPTR_MAX > 0xffffffffu && !defined(USE_ADDR64)
+	#define VM_GUARD_PAGES 1
+#else
+	#define VM_GUARD_PAGES 0
+#endif
+
+
+
+/**
+ * memory of the vm
+ *
+ * by default, the memory is allocated on the heap and cleared completely.
+ *
+ * lazily allocated memory is only reserved by a mapping without backing
+ * storage, the system commits its pages when they are first used, so
+ * that a large memory size only costs the pages actually used by the
+ * code and the deepest extent of the stack.
+ *
+ * with guard pages, the memory is placed in a reserved address range that
+ * covers all addresses reachable with a t_vm_addr offset plus a length,
+ * i.e. [mem - 2^31, mem + 2^32). everything outside of the vm memory is
+ * mapped without access rights, so that an out-of-bounds access faults
+ * instead of hitting host memory. the size of the vm memory is rounded
+ * up to whole pages, so that it starts directly after the lower and ends
+ * directly before the upper guard region, where the stack starts. the
+ * pages holding the code are write-protected while running, which
+ * catches stack overflows into the code.
+ *
+ * the code of a program file can be mapped directly into page-aligned
+ * mapped memory, so that its pages are only read when they are used.
+ */
+class VMMemory
+{
+public:
+	VMMemory() = default;
+	~VMMemory();
+
+	VMMemory(const VMMemory&) = delete;
+	VMMemory& operator=(const VMMemory&) = delete;
+
+	void Allocate(t_vm_addr size, bool guards = false, bool lazy = false);
+	void Free();
+	void Clear(t_vm_byte fill);
+	bool MapFile(int fd, std::size_t offset, std::size_t size);
+
+	t_vm_byte* get() const { return m_mem; }
+	t_vm_byte& operator[](t_vm_addr addr) const { return m_mem[addr]; }
+
+	t_vm_addr GetSize() const { return m_size; }
+	bool HasGuardPages() const { return m_guards; }
+	bool IsLazy() const { return m_lazy; }
+
+	// memory usage statistics
+	std::optional<t_vm_addr> GetLowestUsed(t_vm_addr begin, t_vm_addr end, t_vm_byte fill) const;
+	std::optional<std::size_t> GetResidentSize() const;
+
+	// is a guarded run active, which makes the bounds checks unnecessary?
+	bool IsGuarded() const { return m_guarded; }
+	// buffered output which is written out before exiting on a fault
+	const std::string* GetFaultOutput() const { return m_fault_output; }
+	bool IsReserved(const void* addr) const;
+
+#if VM_GUARD_PAGES != 0
+	template<class t_func>
+	auto RunGuarded(t_func&& func, t_vm_addr code_begin, t_vm_addr code_end,
+		const std::string* output = nullptr);
+#endif
+
+
+protected:
+	bool ProtectCode(t_vm_addr begin, t_vm_addr end);
+	void UnprotectCode();
+	void UnmapFile();
+
+#if VM_GUARD_PAGES != 0
+	void EnterGuarded(t_vm_addr code_begin, t_vm_addr code_end, const std::string* output);
+	void ExitGuarded();
+#endif
+
+
+private:
+	t_vm_byte* m_mem{nullptr};             // start of the vm memory
+	t_vm_addr m_size{0};                   // size of the vm memory
+
+	// memory allocated on the heap
+	std::unique_ptr<t_vm_byte[]> m_heap{};
+
+	// mapped address range, including the guard pages
+	t_vm_byte* m_mapped{nullptr};
+	std::size_t m_mapped_size{0};
+	bool m_guards{false};                  // the mapping has guard pages
+	bool m_lazy{false};                    // pages are committed when used
+
+	// pages mapped from a program file
+	std::size_t m_filemapped_size{0};
+
+	// write-protected pages holding the code
+	t_vm_byte* m_protected{nullptr};
+	std::size_t m_protected_size{0};
+
+	// state of the guarded run
+	bool m_guarded{false};
+	const std::string* m_fault_output{nullptr};  // buffered output, written on a fault
+#if VM_GUARD_PAGES != 0
+	const VMMemory* m_prev_mem{nullptr};   // enclosing guarded run on this thread
+#endif
+};
+
+
+
+#if VM_GUARD_PAGES != 0
+/**
+ * calls the function with active guard pages
+ *
+ * an access to the guard pages is fatal: the interrupted vm instruction
+ * cannot be resumed and its objects cannot be destroyed, so the fault is
+ * reported like a failed bounds check and the process exits after writing
+ * the buffered output, other buffered streams have to be flushed before
+ */
+template<class t_func>
+auto VMMemory::RunGuarded(t_func&& func, t_vm_addr code_begin, t_vm_addr code_end,
+	const std::string* output)
+{
+	struct Scope
+	{
+		VMMemory& mem;
+		~Scope() { mem.ExitGuarded(); }
+	};
+
+	EnterGuarded(code_begin, code_end, output);
+	Scope scope{*this};
+
+	return func();
+}
+#endif
+
+
+
+/**
+ * program file, mapped read-only into the host memory if possible,
+ * otherwise read into a buffer
+ */
+class ProgramFile
+{
+public:
+	ProgramFile() = default;
+	~ProgramFile();
+
+	ProgramFile(const ProgramFile&) = delete;
+	ProgramFile& operator=(const ProgramFile&) = delete;
+
+	bool Open(const std::string& filename);
+	void Close();
+
+	const t_vm_byte* GetData() const { return m_data; }
+	std::size_t GetSize() const { return m_size; }
+
+	// file descriptor for mapping the file into the vm memory, -1 if not available
+	int GetDescriptor() const { return m_fd; }
+
+
+private:
+	const t_vm_byte* m_data{nullptr};
+	std::size_t m_size{0};
+	int m_fd{-1};
+
+	void* m_mapped{nullptr};
+	std::vector<t_vm_byte> m_bytes{};
+};
+
+
+#endif